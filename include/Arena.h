@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace JackCompiler {
+    class Arena;
+}
+
+class JackCompiler::Arena {
+public:
+    /**
+     * \brief Creates a new bump-allocator that hands out memory from blocks of (at least) a provided size.
+     * Objects allocated in the arena are never destroyed individually, all memory is released at
+     * once when the arena is destroyed or reused after a call of reset().
+     * \param blockSize The size of the memory-blocks
+     */
+    explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE) : blockSize_{blockSize} {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * \brief Constructs an object in the arena.
+     * \param args The arguments passed to the object's constructor
+     * \return A pointer to the object that remains valid until the arena is reset or destroyed
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Objects in an arena are never destroyed.");
+        return new(allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+    }
+
+    /**
+     * \brief Copies an array of objects into the arena.
+     * \param first A pointer to the first object
+     * \param count The number of objects
+     * \return A pointer to the first copied object (nullptr if count is 0)
+     */
+    template<typename T>
+    T* copy(const T* first, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable objects can be copied into an arena.");
+
+        if(count == 0) {
+            return nullptr;
+        }
+
+        auto* const storage = allocate(sizeof(T) * count, alignof(T));
+        std::memcpy(storage, first, sizeof(T) * count);
+        return static_cast<T*>(storage);
+    }
+
+    /**
+     * \brief Copies a string into the arena.
+     * \param string The string to copy
+     * \return A view of the copy
+     */
+    std::string_view copy(std::string_view string) { return {copy(string.data(), string.size()), string.size()}; }
+
+    /**
+     * \brief Releases all objects allocated in the arena at once. The memory-blocks are kept
+     * and reused for later allocations.
+     */
+    void reset();
+
+    /**
+     * \brief Gets the number of bytes that are currently reserved by the arena's memory-blocks.
+     * \return The number of reserved bytes
+     */
+    size_t capacity() const;
+
+private:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t currentBlockIndex_{};
+    char* current_{};
+    char* end_{};
+
+    void* allocate(size_t size, size_t alignment) {
+        const auto address = reinterpret_cast<std::uintptr_t>(current_);
+        const auto alignedAddress = (address + alignment - 1) & ~(alignment - 1);
+
+        if(current_ != nullptr && alignedAddress + size <= reinterpret_cast<std::uintptr_t>(end_)) {
+            current_ = reinterpret_cast<char*>(alignedAddress + size);
+            return reinterpret_cast<void*>(alignedAddress);
+        }
+
+        return allocateFromNextBlock(size, alignment);
+    }
+
+    void* allocateFromNextBlock(size_t size, size_t alignment);
+};
@@ -0,0 +1,295 @@
+#pragma once
+#include "Tokenizer.h"
+#include "VMWriter.h"
+#include <cstddef>
+#include <string_view>
+
+/**
+ * \brief The nodes of the abstract syntax tree of a Jack class. Nodes are allocated in an arena
+ * and are immutable once created. Variables and subroutine calls are already resolved, i.e. they
+ * refer to the RAM-segments and the fully qualified names used in the generated code.
+ */
+namespace JackCompiler::Ast {
+    /**
+     * \brief A read-only view of an arena-allocated array.
+     */
+    template<typename T>
+    class List {
+    public:
+        List() = default;
+        List(const T* data, size_t size) : data_{data}, size_{size} {}
+
+        const T* begin() const { return data_; }
+        const T* end() const { return data_ + size_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const T& operator[](size_t index) const { return data_[index]; }
+
+    private:
+        const T* data_{};
+        size_t size_{};
+    };
+
+    struct Expression {
+        enum class Kind { INT_CONST, STRING_CONST, KEYWORD_CONST, VARIABLE, ARRAY_ELEMENT, SUBROUTINE_CALL, UNARY_OP, BINARY_OP };
+
+        const Kind kind;
+
+        /**
+         * \brief Gets this expression as an expression of a specific node-type.
+         * \return The expression or nullptr if it is not of the requested type
+         */
+        template<typename T>
+        const T* as() const { return kind == T::KIND ? static_cast<const T*>(this) : nullptr; }
+
+    protected:
+        explicit Expression(Kind expressionKind) : kind{expressionKind} {}
+    };
+
+    struct IntConstant : Expression {
+        static constexpr Kind KIND = Kind::INT_CONST;
+        // a 16-bit value, negative values only result from constant folding
+        const int value;
+
+        explicit IntConstant(int constantValue) : Expression{KIND}, value{constantValue} {}
+    };
+
+    struct StringConstant : Expression {
+        static constexpr Kind KIND = Kind::STRING_CONST;
+        const std::string_view value;
+
+        explicit StringConstant(std::string_view constantValue) : Expression{KIND}, value{constantValue} {}
+    };
+
+    struct KeywordConstant : Expression {
+        static constexpr Kind KIND = Kind::KEYWORD_CONST;
+        // TRUE, FALSE, NULL_ or THIS
+        const Tokenizer::KeyWordType keyword;
+
+        explicit KeywordConstant(Tokenizer::KeyWordType keywordType) : Expression{KIND}, keyword{keywordType} {}
+    };
+
+    struct Variable : Expression {
+        static constexpr Kind KIND = Kind::VARIABLE;
+        const std::string_view name;
+        const std::string_view type;
+        const VMWriter::Segment segment;
+        const int index;
+
+        Variable(std::string_view variableName, std::string_view variableType, VMWriter::Segment variableSegment, int variableIndex)
+            : Expression{KIND}, name{variableName}, type{variableType}, segment{variableSegment}, index{variableIndex} {}
+    };
+
+    struct ArrayElement : Expression {
+        static constexpr Kind KIND = Kind::ARRAY_ELEMENT;
+        const Variable* const array;
+        const Expression* const index;
+
+        ArrayElement(const Variable* arrayVariable, const Expression* elementIndex)
+            : Expression{KIND}, array{arrayVariable}, index{elementIndex} {}
+    };
+
+    struct SubroutineCall : Expression {
+        static constexpr Kind KIND = Kind::SUBROUTINE_CALL;
+        const std::string_view className;
+        const std::string_view subroutineName;
+        // the object a method is called on ('this' or a variable), nullptr for function-calls
+        const Expression* const receiver;
+        const List<const Expression*> arguments;
+
+        SubroutineCall(std::string_view calledClassName, std::string_view calledSubroutineName, 
+            const Expression* methodReceiver, List<const Expression*> callArguments)
+            : Expression{KIND}, className{calledClassName}, subroutineName{calledSubroutineName},
+              receiver{methodReceiver}, arguments{callArguments} {}
+    };
+
+    struct UnaryOp : Expression {
+        static constexpr Kind KIND = Kind::UNARY_OP;
+        // '-' or '~'
+        const char op;
+        const Expression* const operand;
+
+        UnaryOp(char opSymbol, const Expression* opOperand) : Expression{KIND}, op{opSymbol}, operand{opOperand} {}
+    };
+
+    struct BinaryOp : Expression {
+        static constexpr Kind KIND = Kind::BINARY_OP;
+        // one of + - * / & | < > =
+        const char op;
+        const Expression* const left;
+        const Expression* const right;
+
+        BinaryOp(char opSymbol, const Expression* leftOperand, const Expression* rightOperand)
+            : Expression{KIND}, op{opSymbol}, left{leftOperand}, right{rightOperand} {}
+    };
+
+    struct Statement {
+        enum class Kind { LET, IF, WHILE, DO, RETURN };
+
+        const Kind kind;
+
+        /**
+         * \brief Gets this statement as a statement of a specific node-type.
+         * \return The statement or nullptr if it is not of the requested type
+         */
+        template<typename T>
+        const T* as() const { return kind == T::KIND ? static_cast<const T*>(this) : nullptr; }
+
+    protected:
+        explicit Statement(Kind statementKind) : kind{statementKind} {}
+    };
+
+    struct LetStatement : Statement {
+        static constexpr Kind KIND = Kind::LET;
+        const Variable* const target;
+        // the index of the assigned array-element, nullptr if the variable itself is assigned
+        const Expression* const index;
+        const Expression* const value;
+
+        LetStatement(const Variable* targetVariable, const Expression* elementIndex, const Expression* assignedValue)
+            : Statement{KIND}, target{targetVariable}, index{elementIndex}, value{assignedValue} {}
+    };
+
+    struct IfStatement : Statement {
+        static constexpr Kind KIND = Kind::IF;
+        const Expression* const condition;
+        const List<const Statement*> thenStatements;
+        const List<const Statement*> elseStatements;
+        const bool hasElse;
+
+        IfStatement(const Expression* ifCondition, List<const Statement*> ifThenStatements,
+            List<const Statement*> ifElseStatements, bool ifHasElse)
+            : Statement{KIND}, condition{ifCondition}, thenStatements{ifThenStatements}, 
+              elseStatements{ifElseStatements}, hasElse{ifHasElse} {}
+    };
+
+    struct WhileStatement : Statement {
+        static constexpr Kind KIND = Kind::WHILE;
+        const Expression* const condition;
+        const List<const Statement*> statements;
+
+        WhileStatement(const Expression* whileCondition, List<const Statement*> bodyStatements)
+            : Statement{KIND}, condition{whileCondition}, statements{bodyStatements} {}
+    };
+
+    struct DoStatement : Statement {
+        static constexpr Kind KIND = Kind::DO;
+        const SubroutineCall* const call;
+
+        explicit DoStatement(const SubroutineCall* subroutineCall) : Statement{KIND}, call{subroutineCall} {}
+    };
+
+    struct ReturnStatement : Statement {
+        static constexpr Kind KIND = Kind::RETURN;
+        // nullptr if no value is returned
+        const Expression* const value;
+
+        explicit ReturnStatement(const Expression* returnedValue) : Statement{KIND}, value{returnedValue} {}
+    };
+
+    struct Subroutine {
+        // CONSTRUCTOR, FUNCTION or METHOD
+        const Tokenizer::KeyWordType type;
+        const std::string_view name;
+        const std::string_view returnType;
+        // including the implicit 'this'-argument of methods
+        const int nArgs;
+        const int nLocals;
+        const List<const Statement*> statements;
+    };
+
+    struct Class {
+        const std::string_view name;
+        const int nFields;
+        const int nStatics;
+        const List<const Subroutine*> subroutines;
+    };
+
+    /**
+     * \brief Calls a function for an expression and all of its subexpressions (in the order in which
+     * their code is generated).
+     * \param expression 
+     * \param function A callable that accepts a const Expression&
+     */
+    template<typename Function>
+    void forEachExpression(const Expression& expression, Function&& function) {
+        function(expression);
+
+        switch(expression.kind) {
+            case Expression::Kind::ARRAY_ELEMENT: {
+                const auto* arrayElement = expression.as<ArrayElement>();
+                forEachExpression(*arrayElement->array, function);
+                forEachExpression(*arrayElement->index, function);
+                break;
+            }
+            case Expression::Kind::SUBROUTINE_CALL: {
+                const auto* call = expression.as<SubroutineCall>();
+
+                if(call->receiver != nullptr) {
+                    forEachExpression(*call->receiver, function);
+                }
+
+                for(const auto* argument : call->arguments) {
+                    forEachExpression(*argument, function);
+                }
+
+                break;
+            }
+            case Expression::Kind::UNARY_OP:
+                forEachExpression(*expression.as<UnaryOp>()->operand, function);
+                break;
+            case Expression::Kind::BINARY_OP:
+                forEachExpression(*expression.as<BinaryOp>()->left, function);
+                forEachExpression(*expression.as<BinaryOp>()->right, function);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * \brief Calls a function for all expressions (including subexpressions) within a list of statements
+     * and their nested statements. The target variables of let-statements are not visited.
+     * \param statements 
+     * \param function A callable that accepts a const Expression&
+     */
+    template<typename Function>
+    void forEachExpression(const List<const Statement*>& statements, Function&& function) {
+        for(const auto* statement : statements) {
+            switch(statement->kind) {
+                case Statement::Kind::LET: {
+                    const auto* let = statement->as<LetStatement>();
+
+                    if(let->index != nullptr) {
+                        forEachExpression(*let->index, function);
+                    }
+
+                    forEachExpression(*let->value, function);
+                    break;
+                }
+                case Statement::Kind::IF: {
+                    const auto* ifStatement = statement->as<IfStatement>();
+                    forEachExpression(*ifStatement->condition, function);
+                    forEachExpression(ifStatement->thenStatements, function);
+                    forEachExpression(ifStatement->elseStatements, function);
+                    break;
+                }
+                case Statement::Kind::WHILE: {
+                    const auto* whileStatement = statement->as<WhileStatement>();
+                    forEachExpression(*whileStatement->condition, function);
+                    forEachExpression(whileStatement->statements, function);
+                    break;
+                }
+                case Statement::Kind::DO:
+                    forEachExpression(*statement->as<DoStatement>()->call, function);
+                    break;
+                case Statement::Kind::RETURN:
+                    if(const auto* value = statement->as<ReturnStatement>()->value) {
+                        forEachExpression(*value, function);
+                    }
+
+                    break;
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "ContentHash.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace JackCompiler {
+    class BuildManifest;
+}
+
+/**
+ * \brief The record of an incremental compilation that is kept next to the generated .vm-files. For every
+ * compiled .jack-file it holds the hashes of its content, its tokens and its output, so that files that have
+ * not changed since the last compilation with the same compiler version and options can be skipped.
+ */
+class JackCompiler::BuildManifest {
+public:
+    /**
+     * \brief The name of the manifest-file within the directory of the compiled files.
+     */
+    static constexpr std::string_view FILE_NAME = ".jack-compiler-manifest";
+
+    /**
+     * \brief What is known about a file that has been compiled without errors. The sizes and modification
+     * times allow to skip a file without reading it, the hashes detect changes that keep the size and time.
+     */
+    struct Entry {
+        std::uintmax_t sourceSize{};
+        // 0 if the source was modified too recently to rely on its modification time
+        std::int64_t sourceTime{};
+        ContentHash::Hash sourceHash{};
+        ContentHash::Hash tokenHash{};
+        std::uintmax_t outputSize{};
+        std::int64_t outputTime{};
+        ContentHash::Hash outputHash{};
+    };
+
+    /**
+     * \brief Creates an empty manifest.
+     * \param configuration The hash of the compiler version and the options
+     */
+    explicit BuildManifest(ContentHash::Hash configuration) : configuration_{configuration} {}
+
+    /**
+     * \brief Loads the manifest of a directory. The manifest is empty if it does not exist, is invalid or
+     * has been written by another compiler version or with other options.
+     * \param directoryPath 
+     * \param configuration The hash of the compiler version and the options
+     * \return The manifest
+     */
+    static BuildManifest load(const std::filesystem::path& directoryPath, ContentHash::Hash configuration);
+
+    /**
+     * \brief Writes the manifest to a directory. It is written to a temporary file first, which then
+     * replaces the manifest, so that an interrupted compilation does not leave a corrupt manifest.
+     * \param directoryPath 
+     * \return True if the manifest has been written, otherwise false
+     */
+    bool save(const std::filesystem::path& directoryPath) const;
+
+    /**
+     * \brief Gets the entry of a file.
+     * \param fileName The name of the .jack-file (without directory)
+     * \return The entry or nullptr if the file is unknown
+     */
+    const Entry* find(std::string_view fileName) const;
+
+    /**
+     * \brief Adds or replaces the entry of a file.
+     * \param fileName The name of the .jack-file (without directory)
+     * \param entry 
+     */
+    void set(std::string_view fileName, const Entry& entry) { entries_[std::string{fileName}] = entry; }
+
+    /**
+     * \brief Removes the entry of a file, e.g. after its compilation has failed.
+     * \param fileName The name of the .jack-file (without directory)
+     */
+    void erase(std::string_view fileName);
+
+    /**
+     * \brief Gets the modification time of a file as it is stored in an entry.
+     * \param path 
+     * \return The modification time or 0 if it cannot be determined or the file has been modified so
+     * recently that a further modification might not change it
+     */
+    static std::int64_t modificationTimeOf(const std::filesystem::path& path);
+
+    /**
+     * \brief Checks if the output of an entry has not been changed or deleted since it has been generated.
+     * \param entry 
+     * \param outputPath 
+     * \return True if the output can be kept
+     */
+    static bool isOutputUpToDate(const Entry& entry, const std::filesystem::path& outputPath);
+
+private:
+    ContentHash::Hash configuration_;
+    std::map<std::string, Entry, std::less<>> entries_;
+};
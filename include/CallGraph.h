@@ -0,0 +1,53 @@
+#pragma once
+#include "Ast.h"
+#include "Inliner.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace JackCompiler {
+    class CallGraph;
+}
+
+class JackCompiler::CallGraph {
+public:
+    /**
+     * \brief Builds the static call graph of a program and determines the subroutines that are reachable
+     * from its entry point, which is Sys.init if the program contains it (i.e. it provides its own OS),
+     * otherwise Main.main. Besides explicit calls, the calls generated for multiplications, divisions,
+     * string constants and constructors are considered. Calls that are inlined are not part of the graph,
+     * instead the calls generated for the inlined body are made by the caller.
+     * \param classes All classes of the program, which must outlive the call graph
+     * \param inliner The subroutines that are inlined or nullptr if no subroutines are inlined
+     */
+    explicit CallGraph(const std::vector<const Ast::Class*>& classes, const Inliner* inliner = nullptr);
+
+    /**
+     * \brief Checks if the program contains an entry point. Without one, all subroutines are
+     * considered to be reachable.
+     * \return True if an entry point exists, otherwise false
+     */
+    bool hasEntryPoint() const { return !entryPoint_.empty(); }
+
+    /**
+     * \brief Checks if a subroutine of the program is reachable from the entry point.
+     * \param subroutine 
+     * \return True if the subroutine is reachable, otherwise false
+     */
+    bool isReachable(const Ast::Subroutine& subroutine) const { return !hasEntryPoint() || reachable_.count(&subroutine) > 0; }
+
+    /**
+     * \brief Prints the number of reachable subroutines and the names of all unreachable ones.
+     * \param outputStream 
+     */
+    void printReport(std::ostream& outputStream) const;
+
+private:
+    std::string entryPoint_;
+    size_t subroutineCount_{};
+    std::unordered_set<const Ast::Subroutine*> reachable_;
+    std::vector<std::string> unreachableNames_;
+};
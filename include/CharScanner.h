@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+/**
+ * \brief Functions that search a text for the next byte of interest to the tokenizer. If the target
+ * supports SSE2 or AVX2 (e.g. when compiling with JACK_COMPILER_ENABLE_AVX2), the text is examined 16 or
+ * 32 bytes at a time, otherwise (and for the remaining tail of the text) byte by byte.
+ * All functions return text.size() if the searched byte was not found.
+ */
+namespace JackCompiler::CharScanner {
+    /**
+     * \brief Skips whitespace (including newlines) starting at a position of a text.
+     * \param text The text to search
+     * \param pos The start-position
+     * \param newlineCount Is increased by the number of skipped newlines
+     * \return The position of the first non-whitespace byte
+     */
+    size_t skipWhitespace(std::string_view text, size_t pos, size_t& newlineCount);
+
+    /**
+     * \brief Finds the first occurrence of a byte starting at a position of a text.
+     * \param text The text to search
+     * \param pos The start-position
+     * \param c The byte to search for
+     * \return The position of the byte
+     */
+    size_t find(std::string_view text, size_t pos, char c);
+
+    /**
+     * \brief Finds the first occurrence of one of two bytes starting at a position of a text.
+     * \param text The text to search
+     * \param pos The start-position
+     * \param c1 The first byte to search for
+     * \param c2 The second byte to search for
+     * \return The position of the first byte that matches either c1 or c2
+     */
+    size_t findEither(std::string_view text, size_t pos, char c1, char c2);
+
+    /**
+     * \brief Finds the end of a block-comment, i.e. the first occurrence of the closing delimiter
+     * starting at a position of a text.
+     * \param text The text to search
+     * \param pos The start-position (the position after the opening delimiter)
+     * \param newlineCount Is increased by the number of newlines up to the returned position
+     * \return The position of the closing delimiter
+     */
+    size_t findBlockCommentEnd(std::string_view text, size_t pos, size_t& newlineCount);
+
+    /**
+     * \brief Byte-by-byte implementations of the functions above. These are used for the tails
+     * of texts and on targets without SIMD-support.
+     */
+    namespace Scalar {
+        size_t skipWhitespace(std::string_view text, size_t pos, size_t& newlineCount);
+        size_t find(std::string_view text, size_t pos, char c);
+        size_t findEither(std::string_view text, size_t pos, char c1, char c2);
+        size_t findBlockCommentEnd(std::string_view text, size_t pos, size_t& newlineCount);
+    }
+}
@@ -1,8 +1,22 @@
 #pragma once
+#include "Arena.h"
+#include "Ast.h"
+#include "CallGraph.h"
+#include "CompilationError.h"
+#include "CompilationOptions.h"
+#include "Inliner.h"
+#include "OptimizationStatistics.h"
+#include "StringPool.h"
 #include "Tokenizer.h"
+#include "TokenBuffer.h"
 #include "SymbolTable.h"
+#include "ValueNumbering.h"
 #include "VMWriter.h"
 #include <istream>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace JackCompiler {
     class CompilationEngine;
@@ -16,25 +30,133 @@ public:
      * and write the result to a provided output-stream
      * \param inputStream 
      * \param outputStream 
+     * \param options 
      */
-    CompilationEngine(std::istream& inputStream, std::ostream& outputStream) 
-        : tokenizer_{inputStream}, vmWriter_{outputStream} {}
+    CompilationEngine(std::istream& inputStream, std::ostream& outputStream, const CompilationOptions& options = {}) 
+        : options_{options}, tokenizer_{inputStream}, 
+          vmWriter_{options.peephole ? VMWriter{outputStream, statistics_} : VMWriter{outputStream}} {}
 
     /**
-     * \brief Compiles a complete class.
+     * \brief Creates a new compilation engine that compiles Jack code contained in a
+     * contiguous buffer (e.g. a memory-mapped file) and writes the result to a provided output-stream.
+     * The buffer must outlive the compilation engine.
+     * \param source 
+     * \param outputStream 
+     * \param options 
+     */
+    CompilationEngine(std::string_view source, std::ostream& outputStream, const CompilationOptions& options = {}) 
+        : options_{options}, tokenizer_{source}, 
+          vmWriter_{options.peephole ? VMWriter{outputStream, statistics_} : VMWriter{outputStream}} {}
+
+    /**
+     * \brief Creates a new compilation engine that compiles the tokens of a pre-lexed token-buffer
+     * and writes the result to a provided output-stream. The token-buffer must outlive the compilation engine.
+     * \param tokenBuffer 
+     * \param outputStream 
+     * \param options 
+     */
+    CompilationEngine(const TokenBuffer& tokenBuffer, std::ostream& outputStream, const CompilationOptions& options = {}) 
+        : options_{options}, tokenizer_{tokenBuffer}, 
+          vmWriter_{options.peephole ? VMWriter{outputStream, statistics_} : VMWriter{outputStream}} {}
+
+    /**
+     * \brief Prepares the compilation engine to compile another class contained in a contiguous buffer, as if
+     * it had been created for the buffer. The memory allocated by the engine (like its arena, symbol table and
+     * buffered instructions) is kept and reused, so that compiling many small classes does not allocate it
+     * again. The abstract syntax tree, statistics and errors of the previous class are released.
+     * \param source 
+     * \param outputStream 
+     * \param options 
+     */
+    void reset(std::string_view source, std::ostream& outputStream, const CompilationOptions& options = {});
+
+    /**
+     * \brief Compiles a complete class. Depending on the options, code is either generated while
+     * parsing or the class is parsed into an abstract syntax tree first which is then lowered.
+     * After an error no more code is generated, but the rest of the class is still parsed to find further
+     * errors (up to the maximum number of errors). Throws the first CompilationError once the class has
+     * been parsed, all of them are available through errors().
      */
     void compileClass();
 
+    /**
+     * \brief Parses a complete class into an abstract syntax tree without generating any code.
+     * The tree is allocated in an arena owned by the compilation engine and is released at once
+     * when the engine is destroyed. Errors are handled like by compileClass().
+     * \return The root of the abstract syntax tree
+     */
+    const Ast::Class& parseClass();
+
+    /**
+     * \brief Generates the code for a class from its abstract syntax tree.
+     * \param astClass The root of the abstract syntax tree
+     * \param inliner The subroutines (of this and other classes) that may be inlined at call sites or
+     * nullptr if no subroutines should be inlined
+     * \param callGraph The call graph of the whole program, no code is generated for subroutines that are
+     * unreachable, or nullptr if code should be generated for all subroutines
+     */
+    void lowerClass(const Ast::Class& astClass, const Inliner* inliner = nullptr, const CallGraph* callGraph = nullptr);
+
+    /**
+     * \brief Gets the statistics of the optimizations that have been applied so far.
+     * \return The optimization statistics
+     */
+    const OptimizationStatistics& statistics() const { return statistics_; }
+
+    /**
+     * \brief Gets the errors that have been found in the class so far, in the order of their occurrence.
+     * \return The errors
+     */
+    const std::vector<CompilationError>& errors() const { return errors_; }
+
 private:
+    CompilationOptions options_;
+    OptimizationStatistics statistics_;
     SymbolTable symbolTable_;
     Tokenizer tokenizer_;
     VMWriter vmWriter_;
-    std::string className_;
-    std::string currentSubroutineName_;
+    std::string_view className_;
+    std::string_view currentSubroutineName_;
+    std::string_view currentSubroutineReturnType_;
     Tokenizer::KeyWordType currentSubroutineType_{};
+    std::vector<CompilationError> errors_;
+    bool recoveryStopped_{};
     size_t currentIfLabelIndex_{};
     size_t currentWhileLabelIndex_{};
 
+    // abstract syntax tree state
+    bool buildAst_{};
+    Arena arena_;
+    std::vector<const Ast::Subroutine*> subroutineStack_;
+    std::vector<const Ast::Statement*> statementStack_;
+    std::vector<const Ast::Expression*> expressionStack_;
+    // the string constants of the class that is lowered if they are pooled
+    std::optional<StringPool> stringPool_;
+
+    // inlining state
+    struct InlinedFrame {
+        // the caller's local variable that holds the first argument, followed by the locals of the callee
+        int localBase;
+        // 1 for methods, whose first argument (this) is held by pointer 1
+        int firstArgument;
+        int nArgs;
+    };
+
+    const Ast::Class* currentClass_{};
+    int currentSubroutineLocalCount_{};
+    const Inliner* inliner_{};
+    std::optional<InlinedFrame> inlinedFrame_;
+
+    // the array variable whose base address is held by pointer 1 (only tracked within a statement)
+    std::optional<std::pair<VMWriter::Segment, int>> thatArray_;
+    // the reused values of the basic block that is compiled
+    const ValueNumbering* valueNumbering_{};
+
+    void processClass();
+    void processClassBody();
+    bool recordError(const CompilationError& error);
+    void synchronize(bool withinBlock);
+
     void compileClassVarDec();
     void compileSubroutineDec();
     void compileParameterList();
@@ -50,6 +172,54 @@ private:
     void compileTerm();
     int compileExpressionList();
 
+    void compileSubroutine(const Ast::Class& astClass, const Ast::Subroutine& subroutine);
+    void compileStatements(const Ast::List<const Ast::Statement*>& statements);
+    size_t skipStatements(const Ast::List<const Ast::Statement*>& statements);
+    void compileLet(const Ast::LetStatement& statement);
+    bool compileArrayElementAssignment(const Ast::LetStatement& statement);
+    void compileIf(const Ast::IfStatement& statement);
+    void compileCompactIf(const Ast::IfStatement& statement);
+    void compileWhile(const Ast::WhileStatement& statement);
+    void compileCompactWhile(const Ast::WhileStatement& statement, size_t whileLabelIndex);
+    void writeBranch(const Ast::Expression& condition, std::string_view label, bool jumpIfTrue);
+    void compileDo(const Ast::DoStatement& statement);
+    void compileReturn(const Ast::ReturnStatement& statement);
+    void compileExpression(const Ast::Expression& expression);
+    void compileUncachedExpression(const Ast::Expression& expression);
+    bool compileReducedStrengthOp(const Ast::BinaryOp& binaryOp);
+    void compileArrayElement(const Ast::ArrayElement& arrayElement);
+    bool setsThat(const Ast::Expression& expression, std::optional<std::pair<VMWriter::Segment, int>> array) const;
+    void compileSubroutineCall(const Ast::SubroutineCall& call);
+    void compileInlinedCall(const Ast::SubroutineCall& call, const Inliner::Candidate& callee);
+    int inlinedLocalCount(const Ast::Subroutine& subroutine) const;
+    std::pair<VMWriter::Segment, int> locate(const Ast::Variable& variable) const;
+
+    Ast::List<const Ast::Statement*> buildStatements();
+    const Ast::Statement* buildLet();
+    const Ast::Statement* buildIf();
+    const Ast::Statement* buildWhile();
+    const Ast::Statement* buildDo();
+    const Ast::Statement* buildReturn();
+    const Ast::Expression* buildExpression();
+    const Ast::Expression* buildTerm();
+    const Ast::SubroutineCall* buildSubroutineCall(std::string_view identifier, char followingSymbol);
+    Ast::List<const Ast::Expression*> buildArgumentList();
+    const Ast::Variable* buildVariable(std::string_view identifier);
+    const Ast::Expression* makeUnaryOp(char opSymbol, const Ast::Expression* operand);
+    const Ast::Expression* makeBinaryOp(char opSymbol, const Ast::Expression* leftOperand, const Ast::Expression* rightOperand);
+
+    template<typename T>
+    Ast::List<T> moveToArena(std::vector<T>& stack, size_t first);
+
+    void writeSubroutineEntry(std::string_view className, std::string_view subroutineName, 
+        Tokenizer::KeyWordType subroutineType, int nLocals, int nFields);
+    void writeIntConstant(int value);
+    void writeStringConstant(std::string_view value);
+    void writeKeywordConstant(Tokenizer::KeyWordType keyword);
+    void writeStringPoolGuard(std::string_view className);
+    void writeStringPoolInitializer(std::string_view className);
+    void writeOp(char opSymbol);
+
     bool classVarDecEncountered() const;
     bool subroutineDecEncountered() const;
     bool typeEncountered() const;
@@ -65,7 +235,7 @@ private:
     bool tryParseKeyword(std::initializer_list<Tokenizer::KeyWordType> validKeywordTypes) const;
     void parseIdentifier() const;
     bool tryParseIdentifier() const;
-    void parseIdentifierAsVariableDefinition(SymbolTable::SymbolKind kind, const std::string& type);
+    void parseIdentifierAsVariableDefinition(SymbolTable::SymbolKind kind, std::string_view type);
     void parseIdentifierAsSubroutineDefinition();
     void parseIdentifierAsClassName();
     void parseIdentifierAsClassNameDefinition();
@@ -77,12 +247,12 @@ private:
     bool tryParseUnaryOpSymbol() const;
     bool tryParseIntConst() const;
     bool tryParseStringConst() const;
-    void parseSubroutineReturnType();
-    std::string parseVariableType();
+    std::string_view parseSubroutineReturnType();
+    std::string_view parseVariableType();
     void processSubroutineCall();
-    bool tryProcessAssignmentArrayElementAccess(const std::string& arrayVarName);
-    void processExpressionArrayElementAccess(const std::string& arrayVarName);
-    void processForeignMethodCall(const std::string& prefixName);
-    void processFunctionCall(const std::string& prefixName);
-    void processOwnMethodCall(const std::string& functionName);
+    bool tryProcessAssignmentArrayElementAccess(std::string_view arrayVarName);
+    void processExpressionArrayElementAccess(std::string_view arrayVarName);
+    void processForeignMethodCall(std::string_view prefixName);
+    void processFunctionCall(std::string_view prefixName);
+    void processOwnMethodCall(std::string_view functionName);
 };
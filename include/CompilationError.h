@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace JackCompiler {
+    class CompilationError;
+}
+
+/**
+ * \brief An error in the compiled Jack code (like a syntax error or an undefined variable) that refers to
+ * the line it occurred on.
+ */
+class JackCompiler::CompilationError : public std::runtime_error {
+public:
+    /**
+     * \brief Creates a new compilation error whose description starts with the line number.
+     * \param line The line the error occurred on
+     * \param message The description of the error (without the line number)
+     */
+    CompilationError(size_t line, const std::string& message)
+        : std::runtime_error{"On line " + std::to_string(line) + ": " + message}, line_{line}, message_{message} {}
+
+    /**
+     * \brief Gets the line the error occurred on.
+     * \return The line number
+     */
+    size_t line() const { return line_; }
+
+    /**
+     * \brief Gets the description of the error without the line number.
+     * \return The description
+     */
+    const std::string& message() const { return message_; }
+
+private:
+    size_t line_;
+    std::string message_;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace JackCompiler {
+    /**
+     * \brief Options that control how Jack code is compiled. With the default options the
+     * generated code is identical to the one produced by the reference compiler of the nand2tetris-course.
+     */
+    struct CompilationOptions {
+        // Parse each class into an abstract syntax tree before generating code instead of
+        // generating code while parsing. Implied by the AST-based optimizations below (all except the
+        // peephole optimizer), so it does not have to be set for them.
+        bool buildAst{false};
+
+        // Buffer the instructions of each function and remove redundant ones with a peephole optimizer.
+        bool peephole{false};
+
+        // Evaluate operations whose operands are compile-time constants at compile-time.
+        bool foldConstants{false};
+
+        // Replace multiplications and divisions by constants with cheaper instruction sequences where
+        // a cost model estimates them to be faster than calling Math.multiply or Math.divide.
+        bool reduceStrength{false};
+
+        // Store the distinct string constants of each class in generated static variables that are
+        // initialized once instead of building a new string every time a string constant is evaluated.
+        bool poolStrings{false};
+
+        // Generate no code for statements that can never be executed, i.e. statements following a return
+        // or an infinite loop and branches whose condition is constant.
+        bool eliminateDeadCode{false};
+
+        // Replace calls of small subroutines that do not call other subroutines with their bodies if the
+        // subroutine consists of at most this number of statements and expressions, 0 disables inlining.
+        // When compiling a directory the subroutines of all classes are considered.
+        size_t inlineThreshold{0};
+
+        // Generate no code for subroutines that are not reachable from Main.main (or Sys.init) and report
+        // the reachability of all subroutines. Only applies when a directory (i.e. a whole program) is compiled.
+        bool eliminateDeadSubroutines{false};
+
+        // Lower if- and while-statements with a single conditional jump (inverting conditions and checking
+        // loop conditions at the end of the loop) instead of using the reference compiler's labels and jumps.
+        bool compactControlFlow{false};
+
+        // Access array elements with constant indices through the offset of the THAT-segment, reuse pointer 1 for
+        // further accesses to the same array within a statement and assign array elements without saving the value
+        // in temp 0 if it can be computed without changing pointer 1.
+        bool optimizeArrayAccess{false};
+
+        // Keep values that are computed several times within a basic block in temp 1 to 7 instead of computing them
+        // again, if this is estimated to be faster.
+        bool eliminateCommonSubexpressions{false};
+
+        // The number of errors after which the compilation stops, 0 for no limit. The parser recovers from errors
+        // by skipping to the end of the statement or declaration (or to the next subroutine), so that all errors
+        // of a class can be reported at once.
+        size_t maxErrors{0};
+
+        // The number of threads that compile the files of a directory, 0 for the number of hardware threads. The
+        // generated code and the reported errors do not depend on the number of threads.
+        size_t jobs{0};
+
+        // Keep a manifest of the compiled files next to the generated .vm-files and skip files whose tokens and outputs
+        // have not changed since the last compilation with the same compiler version and options. Options that change
+        // the generated code have to be included in ContentHash::of(const CompilationOptions&).
+        bool incremental{false};
+
+        // A directory that stores the outputs of compiled files by the hashes of their sources and the options, so that
+        // identical sources are only compiled once, even by different processes. Empty to disable the cache.
+        std::string cacheDirectory;
+
+        // The size of all outputs in the cache directory above which the least recently used ones are removed.
+        std::uintmax_t cacheSize{256 * 1024 * 1024};
+    };
+}
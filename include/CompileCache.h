@@ -0,0 +1,92 @@
+#pragma once
+#include "ContentHash.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace JackCompiler {
+    class CompileCache;
+}
+
+/**
+ * \brief Stores the outputs of compiled files by the hash of their source and of the compiler version and
+ * options, so that identical sources (e.g. in several checkouts of the same library) are only compiled once.
+ * The cache is either kept in a directory or in memory (e.g. by a compile-server). Several processes (and
+ * threads) can use the same directory at once: entries are written to temporary files that are renamed once
+ * they are complete, and every entry contains the hash of its output, so that incomplete or corrupt entries
+ * are ignored.
+ */
+class JackCompiler::CompileCache {
+public:
+    /**
+     * \brief Opens a cache directory and creates it if it does not exist.
+     * \param directoryPath 
+     * \param maxSize The size of all entries above which the least recently used entries are removed
+     */
+    CompileCache(const std::filesystem::path& directoryPath, std::uintmax_t maxSize);
+
+    /**
+     * \brief Creates an empty cache that is kept in memory.
+     * \param maxSize The size of all entries above which the least recently used entries are removed
+     */
+    explicit CompileCache(std::uintmax_t maxSize);
+
+    /**
+     * \brief Gets the output of a source (and marks the entry as recently used).
+     * \param sourceHash The hash of the bytes of the source
+     * \param configuration The hash of the compiler version and the options
+     * \return The output or nothing if the cache does not contain it
+     */
+    std::optional<std::string> load(ContentHash::Hash sourceHash, ContentHash::Hash configuration);
+
+    /**
+     * \brief Adds the output of a source. Errors are ignored, since the cache is only an optimization.
+     * \param sourceHash The hash of the bytes of the source
+     * \param configuration The hash of the compiler version and the options
+     * \param output 
+     */
+    void store(ContentHash::Hash sourceHash, ContentHash::Hash configuration, std::string_view output);
+
+    /**
+     * \brief Removes the least recently used entries until the size of all entries is below the maximum size
+     * (and temporary files that have been left behind by interrupted processes).
+     */
+    void evict();
+
+    size_t hits() const { return hits_; }
+
+    size_t misses() const { return misses_; }
+
+private:
+    struct MemoryEntry {
+        std::string output;
+        // the number of the last load or store that has used the entry
+        std::uint64_t lastUse;
+    };
+
+    // empty if the cache is kept in memory
+    std::filesystem::path directoryPath_;
+    std::uintmax_t maxSize_;
+    // distinguishes the temporary files of concurrent processes
+    std::string temporarySuffix_;
+    std::atomic<size_t> hits_{};
+    std::atomic<size_t> misses_{};
+    std::atomic<size_t> stores_{};
+
+    std::mutex memoryMutex_;
+    std::unordered_map<std::string, MemoryEntry> memoryEntries_;
+    std::uintmax_t memorySize_{};
+    std::uint64_t uses_{};
+
+    static std::string keyOf(ContentHash::Hash sourceHash, ContentHash::Hash configuration);
+    std::filesystem::path entryPath(const std::string& key) const;
+    std::optional<std::string> loadFromDirectory(const std::string& key);
+    void storeInDirectory(const std::string& key, std::string_view output);
+    void evictFromDirectory();
+    void evictFromMemory();
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "CompilationOptions.h"
+#include <chrono>
+#include <ostream>
+#include <string>
+
+/**
+ * \brief A compile-server that keeps running between compilations and serves compile-requests that thin clients
+ * send over a Unix domain socket, so that build systems that compile many small directories do not pay for
+ * starting a new process every time. The server compiles several requests at once and keeps the outputs of
+ * compiled files in memory, so that unchanged sources are not compiled again. Only available on platforms with
+ * Unix domain sockets.
+ */
+namespace JackCompiler::CompileServer {
+    /**
+     * \brief The time after which a server without requests stops by default.
+     */
+    constexpr std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT{std::chrono::minutes{10}};
+
+    /**
+     * \brief Checks if the platform supports the compile-server.
+     * \return True if Unix domain sockets are available, otherwise false
+     */
+    bool isSupported();
+
+    /**
+     * \brief Checks if a server is listening on a socket.
+     * \param socketPath 
+     * \return True if a connection to the socket can be established, otherwise false
+     */
+    bool isRunning(const std::string& socketPath);
+
+    /**
+     * \brief Listens on a socket and serves compile-requests until no request has been received for the idle timeout.
+     * Only the user who started the server can connect to the socket. The socket is removed when the server stops.
+     * \param socketPath The path of the socket, which must not be used by a running server
+     * \param options The options of the server: jobs is the number of requests that are compiled at once (0 for the
+     * number of hardware threads) and cacheSize the size of the outputs that are kept in memory
+     * \param idleTimeout The time without requests after which the server stops
+     * \param logStream The stream messages of the server are written to
+     * \return 0 if the server has stopped after the idle timeout, -1 if it could not be started
+     */
+    int serve(const std::string& socketPath, const CompilationOptions& options, std::chrono::milliseconds idleTimeout,
+        std::ostream& logStream);
+
+    /**
+     * \brief Sends a compile-request to a server and waits until the compilation has finished. The server compiles
+     * the file or directory like JackCompiler::compile.
+     * \param socketPath The path of the socket the server listens on
+     * \param inputPathName The path to a .jack file or the path to a directory containing .jack files (relative paths
+     * are resolved by the client)
+     * \param options The options that control the compilation, a request with a cache directory uses it instead of the
+     * outputs the server keeps in memory (a relative cache directory is resolved by the client as well)
+     * \param reportStream The stream the report of the compilation is written to
+     * \return 0 if the compilation was successful, -1 if it has failed, the server could not be reached or a path
+     * contains a line break
+     */
+    int request(const std::string& socketPath, const std::string& inputPathName, const CompilationOptions& options,
+        std::ostream& reportStream);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Ast.h"
+#include <optional>
+
+/**
+ * \brief Functions that evaluate Jack operations on compile-time constants the same way the Hack
+ * virtual-machine (and the Math-class of the Jack OS) would evaluate them at runtime, i.e. on 16-bit
+ * two's complement integers where true is -1 and false (and null) is 0.
+ */
+namespace JackCompiler::ConstantFolding {
+    constexpr int TRUE_VALUE = -1;
+    constexpr int FALSE_VALUE = 0;
+
+    /**
+     * \brief Gets the value of an expression if it is a compile-time constant.
+     * \param expression 
+     * \return The value of an integer constant, true, false or null, otherwise nothing
+     */
+    std::optional<int> valueOf(const Ast::Expression& expression);
+
+    /**
+     * \brief Evaluates a unary operation.
+     * \param op '-' or '~'
+     * \param operand 
+     * \return The result
+     */
+    int evaluate(char op, int operand);
+
+    /**
+     * \brief Evaluates a binary operation.
+     * \param op One of + - * / & | < > =
+     * \param left 
+     * \param right 
+     * \return The result or nothing if the result depends on the runtime (e.g. division by zero)
+     */
+    std::optional<int> evaluate(char op, int left, int right);
+
+    /**
+     * \brief Gets the number of instructions needed to push the value of a constant expression.
+     * \param expression An integer constant, true, false or null
+     * \return The number of instructions
+     */
+    int instructionCount(const Ast::Expression& expression);
+}
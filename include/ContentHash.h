@@ -0,0 +1,52 @@
+#pragma once
+#include "CompilationOptions.h"
+#include "TokenBuffer.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * \brief Functions that compute 64-bit FNV-1a hashes of the inputs and outputs of a compilation, which
+ * are used to detect whether a file has to be compiled again. The hashes detect changes, they are not
+ * meant to resist deliberate collisions.
+ */
+namespace JackCompiler::ContentHash {
+    using Hash = std::uint64_t;
+
+    /**
+     * \brief Hashes the bytes of a file.
+     * \param bytes 
+     * \return The hash
+     */
+    Hash of(std::string_view bytes);
+
+    /**
+     * \brief Hashes the tokens of a file, so that changes of whitespace and comments do not change the hash.
+     * \param tokenBuffer 
+     * \return The hash
+     */
+    Hash of(const TokenBuffer& tokenBuffer);
+
+    /**
+     * \brief Hashes the version of the compiler and all options that change the generated code (but not
+     * options like the number of threads or errors).
+     * \param options 
+     * \return The hash
+     */
+    Hash of(const CompilationOptions& options);
+
+    /**
+     * \brief Formats a hash as 16 hexadecimal digits.
+     * \param hash 
+     * \return The digits
+     */
+    std::string toString(Hash hash);
+
+    /**
+     * \brief Parses a hash formatted by toString.
+     * \param digits 
+     * \return The hash or nothing if the digits are invalid
+     */
+    std::optional<Hash> fromString(std::string_view digits);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace JackCompiler {
+    class DirectoryWatcher;
+}
+
+/**
+ * \brief Watches the files of a directory (without subdirectories) for changes using inotify. Only available
+ * on Linux.
+ */
+class JackCompiler::DirectoryWatcher {
+public:
+    /**
+     * \brief The files that have been changed (written, created, moved or deleted) in a burst of changes.
+     */
+    struct Changes {
+        // sorted and without duplicates
+        std::vector<std::string> fileNames;
+        // when the first change of the burst has been noticed
+        std::chrono::steady_clock::time_point firstChange;
+    };
+
+    /**
+     * \brief Checks if the platform supports watching directories.
+     * \return True if inotify is available, otherwise false
+     */
+    static bool isSupported();
+
+    /**
+     * \brief Starts to watch a directory. Throws a runtime_error if the directory cannot be watched.
+     * \param directoryPath 
+     */
+    explicit DirectoryWatcher(const std::filesystem::path& directoryPath);
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    ~DirectoryWatcher();
+
+    /**
+     * \brief Waits for changes. Once a file has been changed, further changes are collected until no file has
+     * been changed for the debounce time, so that an editor that saves a file in several steps (or saves
+     * several files at once) causes a single burst.
+     * \param timeout The maximum time to wait for the first change
+     * \param debounce The time without changes that ends a burst
+     * \return The changes, which contain no files if no file has been changed before the timeout
+     */
+    Changes waitForChanges(std::chrono::milliseconds timeout, std::chrono::milliseconds debounce);
+
+private:
+    int fileDescriptor_{-1};
+};
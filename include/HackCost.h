@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * \brief The estimated number of Hack instructions a straightforward VM-translator emits per VM command,
+ * which the optimizations use to decide if a rewrite pays off.
+ */
+namespace JackCompiler::HackCost {
+    constexpr int PUSH_COST = 7;
+    // local, argument, this and that add the index to a base address
+    constexpr int INDEXED_PUSH_COST = 10;
+    constexpr int POP_COST = 5;
+    constexpr int BINARY_ARITHMETIC_COST = 5;
+    // eq, gt and lt need a jump
+    constexpr int COMPARISON_COST = 14;
+    constexpr int UNARY_ARITHMETIC_COST = 3;
+    // pushing the constant operand, saving and restoring the caller's frame and the 16 iterations of
+    // the shift-and-add loop of Math.multiply (the same estimate is used for Math.divide, which is faster
+    // for small quotients but recurses for large ones)
+    constexpr int CALL_COST = PUSH_COST + 1000;
+    // adding the base address, setting pointer 1 and pushing that 0
+    constexpr int ARRAY_ACCESS_COST = BINARY_ARITHMETIC_COST + POP_COST + INDEXED_PUSH_COST + INDEXED_PUSH_COST;
+}
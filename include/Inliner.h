@@ -0,0 +1,46 @@
+#pragma once
+#include "Ast.h"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace JackCompiler {
+    class Inliner;
+}
+
+class JackCompiler::Inliner {
+public:
+    /**
+     * \brief A subroutine whose body can replace calls of it.
+     */
+    struct Candidate {
+        const Ast::Class* astClass;
+        const Ast::Subroutine* subroutine;
+        // static variables can only be accessed from within the class
+        bool accessesStatics;
+    };
+
+    /**
+     * \brief Creates an index of the subroutines of a set of classes (e.g. all classes of a program)
+     * that can be inlined. These are functions and methods that
+     *  - consist of at most sizeThreshold statements and expressions,
+     *  - do not call other subroutines (so they cannot be recursive) and contain no string constants,
+     *  - only return at their end and
+     *  - (methods only) do not access arrays, since the object is accessed through the THAT-segment
+     *    when inlined.
+     * \param classes The classes, which must outlive the inliner
+     * \param sizeThreshold The maximum size of an inlined subroutine
+     */
+    Inliner(const std::vector<const Ast::Class*>& classes, size_t sizeThreshold);
+
+    /**
+     * \brief Finds the subroutine that is called by a subroutine call if it can be inlined.
+     * \param call The subroutine call
+     * \param callerClassName The name of the class that contains the call
+     * \return The subroutine or nullptr if the call cannot be inlined
+     */
+    const Candidate* find(const Ast::SubroutineCall& call, std::string_view callerClassName) const;
+
+private:
+    std::unordered_map<std::string_view, std::unordered_map<std::string_view, Candidate>> candidates_;
+};
@@ -1,14 +1,60 @@
 #pragma once
+#include "CompilationOptions.h"
+#include <functional>
 #include <string>
+#include <istream>
+#include <ostream>
 
 namespace JackCompiler{
+    class CompileCache;
+
     /**
      * \brief Compiles .jack files containing Jack code into .vm files containing Hack virtual-machine
      * language code. If the input-path points to a single .jack files, then exactly one output .jack
      * file with the same name will be created in the input-file's directory. If the input-path
      * points to a directory this will be done for every .jack file contained in the directory.
      * \param inputPathName The path to a .jack file or the path to a directory containing .jack files
+     * \param options The options that control the compilation
      * \return 0 if the compilation was successful, -1 otherwise 
      */
-    int compile(const std::string& inputPathName);
+    int compile(const std::string& inputPathName, const CompilationOptions& options = {});
+
+    /**
+     * \brief Compiles a .jack file or a directory like compile(inputPathName, options), but writes the report
+     * (errors, statistics and messages) to a stream instead of the standard output.
+     * \param inputPathName The path to a .jack file or the path to a directory containing .jack files
+     * \param options The options that control the compilation
+     * \param reportStream The stream the report is written to
+     * \param sharedCache A cache that is used instead of the cache-directory of the options (e.g. an in-memory
+     * cache that is shared by several compilations) or nullptr
+     * \return 0 if the compilation was successful, -1 otherwise
+     */
+    int compile(const std::string& inputPathName, const CompilationOptions& options, std::ostream& reportStream,
+        CompileCache* sharedCache = nullptr);
+
+    /**
+     * \brief Compiles a directory and then watches it: Whenever .jack files are changed, only the changed files
+     * are compiled again (or the whole directory with whole-program optimizations), and the .vm files of removed
+     * .jack files are removed. Changes that follow each other closely (like the steps of an editor saving a file)
+     * are compiled at once. The report of every compilation is followed by its latency. Requires inotify.
+     * \param directoryPathName The path to a directory containing .jack files
+     * \param options The options that control the compilations
+     * \param reportStream The stream the reports are written to
+     * \param stopRequested Is called regularly and stops watching once it returns true (watches forever if empty)
+     * \return 0 if watching has been stopped, -1 if the directory could not be watched
+     */
+    int watch(const std::string& directoryPathName, const CompilationOptions& options, std::ostream& reportStream,
+        const std::function<bool()>& stopRequested = {});
+
+    /**
+     * \brief Compiles Jack code read from an input-stream (e.g. stdin) into Hack virtual-machine
+     * language code that is written to an output-stream (e.g. stdout). The input is read in fixed-size
+     * chunks and the output is written as it is produced, so the memory usage does not grow with the
+     * length of the input. Compilation errors are reported on stderr.
+     * \param inputStream The stream containing the Jack code of a class
+     * \param outputStream The stream the VM code is written to
+     * \param options The options that control the compilation
+     * \return 0 if the compilation was successful, -1 otherwise
+     */
+    int compile(std::istream& inputStream, std::ostream& outputStream, const CompilationOptions& options = {});
 }
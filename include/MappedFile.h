@@ -0,0 +1,46 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace JackCompiler {
+    class MappedFile;
+}
+
+class JackCompiler::MappedFile {
+public:
+    /**
+     * \brief Maps the file at the provided path read-only into memory. On platforms that do not
+     * support memory-mapping, the file's content is read into an internal buffer instead.
+     * Whether the file could be opened can be checked using the bool-conversion operator.
+     * \param path The path of the file to map
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    /**
+     * \brief Checks if the file was opened and mapped successfully.
+     */
+    explicit operator bool() const { return isOpen_; }
+
+    /**
+     * \brief Gets the content of the mapped file. The returned view is valid as long
+     * as this object exists.
+     * \return The file content
+     */
+    std::string_view data() const { return data_; }
+
+private:
+    std::string_view data_;
+    std::string fallbackBuffer_;
+    bool isOpen_{};
+    bool isMapped_{};
+
+    void unmap() noexcept;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace JackCompiler {
+    class OptimizationStatistics;
+}
+
+class JackCompiler::OptimizationStatistics {
+public:
+    /**
+     * \brief What a counter counts: Instructions removed from the output, or occurrences of an optimization
+     * that do not directly correspond to removed instructions (e.g. reused values, whose stores add instructions).
+     */
+    enum class Unit { REMOVED_INSTRUCTIONS, OCCURRENCES };
+
+    /**
+     * \brief Adds to a named counter, e.g. the number of instructions removed by an optimization rule.
+     * Counters are kept in the order in which they were first added.
+     * \param name The name of the counter (must refer to a string with static storage duration)
+     * \param count The amount to add
+     * \param unit What the counter counts
+     */
+    void add(std::string_view name, size_t count, Unit unit = Unit::REMOVED_INSTRUCTIONS);
+
+    /**
+     * \brief Removes all counters (keeping the allocated memory for reuse).
+     */
+    void clear() { counters_.clear(); }
+
+    /**
+     * \brief Adds all counters of other statistics to these statistics.
+     * \param other 
+     */
+    void merge(const OptimizationStatistics& other);
+
+    /**
+     * \brief Gets the value of a named counter.
+     * \param name 
+     * \return The value of the counter (0 if it does not exist)
+     */
+    size_t count(std::string_view name) const;
+
+    /**
+     * \brief Checks if no counter has been added yet.
+     * \return True if there are no counters, otherwise false
+     */
+    bool empty() const { return counters_.empty(); }
+
+    /**
+     * \brief Writes a human-readable report with one line per counter, under a heading for each unit.
+     * \param outputStream 
+     */
+    void print(std::ostream& outputStream) const;
+
+private:
+    struct Counter {
+        std::string_view name;
+        size_t count;
+        Unit unit;
+    };
+
+    std::vector<Counter> counters_;
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include "OptimizationStatistics.h"
+#include "VMWriter.h"
+#include <vector>
+
+/**
+ * \brief A peephole optimizer that removes redundant virtual-machine instructions of a single function.
+ * A window slides over the instructions and every rule of a rule-table whose pattern matches the end of
+ * the window rewrites it (e.g. "push local 0" directly followed by "pop local 0" is removed).
+ * Afterwards labels that are not referenced by any goto are removed and the rules are applied again
+ * until nothing changes anymore.
+ */
+namespace JackCompiler::PeepholeOptimizer {
+    /**
+     * \brief Optimizes the instructions of a function in place.
+     * \param instructions The instructions of the function (including the function-declaration)
+     * \param statistics Record the number of instructions removed per rule
+     */
+    void optimize(std::vector<VMWriter::Instruction>& instructions, OptimizationStatistics& statistics);
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "CompilationEngine.h"
+#include "CompilationError.h"
+#include "CompilationOptions.h"
+#include "OptimizationStatistics.h"
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace JackCompiler {
+    class SourceCompiler;
+}
+
+/**
+ * \brief Compiles the Jack code of classes held in memory into VM code held in memory, without accessing files
+ * or printing anything, so that the compiler can be embedded into other programs. The compilation engine is
+ * reused for all classes, so that the memory it allocates is only allocated once. A source compiler must only
+ * be used by one thread at a time, compileSource() can be called by any number of threads at once.
+ */
+class JackCompiler::SourceCompiler {
+public:
+    /**
+     * \brief The outcome of the compilation of a class.
+     */
+    struct Result {
+        // the VM code of the class, empty if the compilation has failed
+        std::string output;
+        // the errors in the order of their occurrence
+        std::vector<CompilationError> errors;
+        OptimizationStatistics statistics;
+
+        /**
+         * \brief Checks if the class has been compiled without errors.
+         * \return True if the output is valid, otherwise false
+         */
+        bool succeeded() const { return errors.empty(); }
+    };
+
+    SourceCompiler() = default;
+
+    SourceCompiler(const SourceCompiler&) = delete;
+    SourceCompiler& operator=(const SourceCompiler&) = delete;
+
+    /**
+     * \brief Compiles a class into a result whose memory is reused (e.g. the result of the previous class).
+     * Whole-program options only apply to the class itself: its own subroutines are inlined, no subroutines
+     * are eliminated.
+     * \param source The Jack code of the class
+     * \param options The options that control the compilation
+     * \param result The result, which is overwritten
+     */
+    void compile(std::string_view source, const CompilationOptions& options, Result& result);
+
+    /**
+     * \brief Compiles a class like compile(source, options, result) into a new result.
+     * \param source The Jack code of the class
+     * \param options The options that control the compilation
+     * \return The result
+     */
+    Result compile(std::string_view source, const CompilationOptions& options = {}) {
+        Result result;
+        compile(source, options, result);
+        return result;
+    }
+
+private:
+    /**
+     * \brief Appends the written characters to a string, so that the output of a compilation is written
+     * directly into the memory of the result.
+     */
+    class OutputBuffer : public std::streambuf {
+    public:
+        std::string* output{};
+
+    protected:
+        int_type overflow(int_type character) override;
+        std::streamsize xsputn(const char* characters, std::streamsize count) override;
+    };
+
+    OutputBuffer outputBuffer_;
+    std::ostream outputStream_{&outputBuffer_};
+    std::optional<CompilationEngine> engine_;
+};
+
+namespace JackCompiler {
+    /**
+     * \brief Compiles the Jack code of a class held in memory like SourceCompiler::compile(). Can be called
+     * by several threads at once, every thread reuses its own source compiler.
+     * \param source The Jack code of the class
+     * \param options The options that control the compilation
+     * \return The result
+     */
+    SourceCompiler::Result compileSource(std::string_view source, const CompilationOptions& options = {});
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "VMWriter.h"
+#include <optional>
+#include <vector>
+
+/**
+ * \brief Functions that replace calls of Math.multiply and Math.divide with a constant operand by
+ * cheaper sequences of virtual-machine instructions. A cost model estimates the number of Hack
+ * instructions that each alternative executes, a replacement is only used if it is cheaper than the call.
+ */
+namespace JackCompiler::StrengthReduction {
+    /**
+     * \brief Gets a sequence of instructions that multiplies the value on top of the stack by a constant
+     * (temp 0 is used as scratch-space). Like Math.multiply, the result wraps around on overflow.
+     * \param constant 
+     * \return The instructions or nothing if calling Math.multiply is cheaper
+     */
+    std::optional<std::vector<VMWriter::Instruction>> multiplication(int constant);
+
+    /**
+     * \brief Gets a sequence of instructions that divides the value on top of the stack by a constant.
+     * \param constant 
+     * \return The instructions or nothing if calling Math.divide is cheaper (or required to get the same result)
+     */
+    std::optional<std::vector<VMWriter::Instruction>> division(int constant);
+
+    /**
+     * \brief Estimates the number of Hack instructions that are executed by a sequence of instructions
+     * that neither contains calls nor jumps.
+     * \param instructions 
+     * \return The estimated cost
+     */
+    int cost(const std::vector<VMWriter::Instruction>& instructions);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace JackCompiler {
+    class StringInterner;
+}
+
+class JackCompiler::StringInterner {
+public:
+    /**
+     * \brief Gets a stable view of a string that is equal to the provided one. Every distinct
+     * string is copied exactly once into an internal arena, further calls with an equal string
+     * return a view of the same memory. All returned views remain valid as long as the interner exists.
+     * \param string The string to intern
+     * \return The interned string
+     */
+    std::string_view intern(std::string_view string);
+
+    /**
+     * \brief Gets the number of distinct strings that have been interned.
+     * \return The number of interned strings
+     */
+    size_t size() const { return strings_.size(); }
+
+private:
+    static constexpr size_t BLOCK_SIZE = 4096;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t currentBlockSize_{};
+    size_t currentBlockUsed_{};
+    std::unordered_set<std::string_view> strings_;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "Ast.h"
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace JackCompiler {
+    class StringPool;
+}
+
+class JackCompiler::StringPool {
+public:
+    /**
+     * \brief The name of the generated function (within the class) that builds all strings of the pool.
+     * It cannot clash with a Jack subroutine since '$' is not allowed in Jack identifiers.
+     */
+    static constexpr std::string_view INITIALIZER_NAME = "$initStringPool";
+
+    /**
+     * \brief Collects the distinct string constants of a class. Each of them is stored in a static
+     * variable that is appended to the static variables declared by the class.
+     * \param astClass The class, which must outlive the pool
+     */
+    explicit StringPool(const Ast::Class& astClass);
+
+    /**
+     * \brief Gets the distinct string constants in the order of their first occurrence.
+     * \return The string constants
+     */
+    const std::vector<std::string_view>& strings() const { return strings_; }
+
+    /**
+     * \brief Gets the index of the static variable that holds a string constant of the class.
+     * \param value The string constant
+     * \return The index within the static segment
+     */
+    int staticIndex(std::string_view value) const { return firstStaticIndex_ + indices_.at(value); }
+
+    /**
+     * \brief Gets the index of the static variable that holds the first string of the pool, which
+     * is null until the pool has been initialized.
+     * \return The index within the static segment
+     */
+    int firstStaticIndex() const { return firstStaticIndex_; }
+
+    /**
+     * \brief Checks if a subroutine uses string constants and therefore has to make sure that the
+     * pool is initialized before executing its statements.
+     * \param subroutine A subroutine of the class
+     * \return True if the subroutine uses string constants, otherwise false
+     */
+    bool isUsedBy(const Ast::Subroutine& subroutine) const { return users_.count(&subroutine) > 0; }
+
+private:
+    int firstStaticIndex_;
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, int> indices_;
+    std::unordered_set<const Ast::Subroutine*> users_;
+};
@@ -1,5 +1,6 @@
 #pragma once
-#include <string>
+#include <array>
+#include <string_view>
 #include <unordered_map>
 
 namespace JackCompiler {
@@ -12,6 +13,21 @@ namespace JackCompiler {
          */
         enum class SymbolKind { STATIC, FIELD, ARG, VAR, NONE };
 
+        /**
+         * \brief The properties of a defined identifier.
+         */
+        struct IdentifierEntry {
+            SymbolKind kind{};
+            std::string_view type;
+            int index{};
+        };
+
+        /**
+         * \brief Removes all identifiers of both scopes so that the table can be reused for another class
+         * (keeping the allocated memory of the tables).
+         */
+        void reset();
+
         /**
          * \brief Starts a new subroutine scope by resetting the subroutine table and
          * variable counts.
@@ -20,12 +36,13 @@ namespace JackCompiler {
 
         /**
          * \brief Defines a new identifier of the given name, type and kind and
-         * assigns it a running index.
+         * assigns it a running index. The table only stores views of the name and type,
+         * so both must remain valid as long as the table is used.
          * \param name 
          * \param type 
          * \param kind 
          */
-        void define(const std::string& name, const std::string& type, SymbolKind kind);
+        void define(std::string_view name, std::string_view type, SymbolKind kind);
 
         /**
          * \brief Gets the number of variables of the given type defined in the
@@ -40,35 +57,36 @@ namespace JackCompiler {
          * \param name 
          * \return The kind of the identifier
          */
-        SymbolKind kindOf(const std::string& name);
+        SymbolKind kindOf(std::string_view name) const;
 
         /**
          * \brief Gets the type of the named identifier in the current scope.
          * \param name 
          * \return The type of the identifier
          */
-        std::string typeOf(const std::string& name);
+        std::string_view typeOf(std::string_view name) const;
 
         /**
          * \brief The index that was assigned to the named identifier.
          * \param name 
          * \return The index of the identifier
          */
-        int indexOf(const std::string& name);
+        int indexOf(std::string_view name) const;
 
-    private:
-        struct IdentifierEntry {
-            SymbolKind kind{};
-            std::string type;
-            int index{};
-        };
+        /**
+         * \brief Looks up the kind, type and index of the named identifier in the current scope at once.
+         * \param name 
+         * \return The identifier's entry or nullptr if the identifier is not defined
+         */
+        const IdentifierEntry* find(std::string_view name) const;
 
+    private:
         bool classScope_ = true;
 
-        std::unordered_map<std::string, IdentifierEntry> classScopeTable_;
-        std::unordered_map<SymbolKind, int> classScopeVarCount_;
+        std::unordered_map<std::string_view, IdentifierEntry> classScopeTable_;
+        std::unordered_map<std::string_view, IdentifierEntry> subroutineScopeTable_;
 
-        std::unordered_map<std::string, IdentifierEntry> subroutineScopeTable_;
-        std::unordered_map<SymbolKind, int> subroutineScopeVarCount_;
+        // variable counts indexed by SymbolKind
+        std::array<int, 4> varCounts_{};
     };
 }
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+/**
+ * \brief Functions that run independent tasks (like the compilation of the files of a directory) on
+ * several threads.
+ */
+namespace JackCompiler::TaskScheduler {
+    /**
+     * \brief Gets the number of threads used if no number is specified, i.e. the number of concurrent
+     * threads supported by the hardware.
+     * \return The number of threads (at least 1)
+     */
+    size_t defaultJobCount();
+
+    /**
+     * \brief Runs tasks on a pool of threads and waits until all of them have finished. The tasks are
+     * distributed round-robin to one queue per thread in the order of their indices, so the most expensive
+     * tasks should come first. Each thread takes the tasks from the front of its own queue, a thread whose
+     * queue is empty steals from the back of the queues of other threads. The calling thread is one of the
+     * threads. If a task throws an exception, no further tasks are started and the first exception is
+     * rethrown after all running tasks have finished.
+     * \param taskCount The number of tasks
+     * \param jobs The maximum number of threads, 0 for the default number
+     * \param task The function that runs the task with the given index (called concurrently)
+     */
+    void run(size_t taskCount, size_t jobs, const std::function<void(size_t)>& task);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "CompilationError.h"
+#include "Tokenizer.h"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace JackCompiler {
+    class TokenBuffer;
+}
+
+class JackCompiler::TokenBuffer {
+public:
+    /**
+     * \brief Lexes all tokens of a contiguous buffer containing Jack code up front and stores them
+     * as parallel arrays (token-type, keyword-type or symbol, source-offset, length and line number).
+     * Tokens refer to the buffer's memory which therefore must outlive the token-buffer.
+     * Lexing stops at the first invalid token and the error is recorded, so that a tokenizer walking the
+     * token-buffer throws it when it advances to that token.
+     * \param source
+     */
+    explicit TokenBuffer(std::string_view source);
+
+    /**
+     * \brief Gets the number of tokens.
+     * \return The number of tokens
+     */
+    size_t size() const { return tokenTypes_.size(); }
+
+    /**
+     * \brief Gets the type of a token.
+     * \param index The index of the token
+     * \return The token-type
+     */
+    Tokenizer::TokenType tokenType(size_t index) const { return static_cast<Tokenizer::TokenType>(tokenTypes_[index]); }
+
+    /**
+     * \brief Gets the keyword-type of a token. Must only be called if the token's type is KEYWORD.
+     * \param index The index of the token
+     * \return The keyword-type
+     */
+    Tokenizer::KeyWordType keyWord(size_t index) const { return static_cast<Tokenizer::KeyWordType>(codes_[index]); }
+
+    /**
+     * \brief Gets the symbol of a token. Must only be called if the token's type is SYMBOL.
+     * \param index The index of the token
+     * \return The symbol
+     */
+    char symbol(size_t index) const { return static_cast<char>(codes_[index]); }
+
+    /**
+     * \brief Gets the text of a token as it appears in the source.
+     * \param index The index of the token
+     * \return The token's text
+     */
+    std::string_view text(size_t index) const { return source_.substr(offsets_[index], lengths_[index]); }
+
+    /**
+     * \brief Gets the line number of a token.
+     * \param index The index of the token
+     * \return The line number
+     */
+    size_t line(size_t index) const { return lines_[index]; }
+
+    /**
+     * \brief Gets the error that stopped lexing after the last token.
+     * \return The error or nullptr if the whole buffer was lexed
+     */
+    const CompilationError* error() const { return error_ ? &*error_ : nullptr; }
+
+private:
+    std::string_view source_;
+    std::vector<std::uint8_t> tokenTypes_;
+    std::vector<std::uint8_t> codes_;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::uint32_t> lengths_;
+    std::vector<std::uint32_t> lines_;
+    std::optional<CompilationError> error_;
+};
@@ -1,8 +1,14 @@
 #pragma once
+#include "StringInterner.h"
 #include <regex>
+#include <string>
+#include <string_view>
+#include <istream>
+#include <array>
 
 namespace JackCompiler {
     class Tokenizer;
+    class TokenBuffer;
 }
 
 class JackCompiler::Tokenizer {
@@ -20,25 +26,84 @@ public:
         FIELD, LET, DO, IF, ELSE, WHILE, RETURN, TRUE, FALSE, NULL_, THIS
     };
 
+    /**
+     * \brief The available lexer implementations. SCANNER is a single-pass, table-driven
+     * character-class scanner, REGEX is the original std::regex based lexer which is kept
+     * to be able to compare both implementations.
+     */
+    enum class LexerMode { SCANNER, REGEX };
+
+    /**
+     * \brief The number of bytes the scanner reads from an input-stream at once by default.
+     */
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 16 * 1024;
+
     /**
      * \brief Creates a new tokenizer for a provided input-stream and gets ready to parse the
-     * first token (if one exists).
+     * first token (if one exists). The scanner reads the stream in fixed-size chunks, so its memory
+     * usage only depends on the chunk-size and the longest token, not on the length of the input.
      * \param inputStream
+     * \param lexerMode The lexer implementation that should be used
+     * \param chunkSize The number of bytes the scanner reads at once (ignored by the regex-lexer)
+     */
+    explicit Tokenizer(std::istream& inputStream, LexerMode lexerMode = LexerMode::SCANNER,
+        size_t chunkSize = DEFAULT_CHUNK_SIZE)
+        : inputStream_{&inputStream}, lexerMode_{lexerMode}, currentLineNr_{lexerMode == LexerMode::SCANNER ? size_t{1} : size_t{0}},
+          chunkSize_{chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE} { updateNextToken(); }
+
+    /**
+     * \brief Creates a new tokenizer that lexes directly from a contiguous buffer containing
+     * Jack code (e.g. a memory-mapped file) and gets ready to parse the first token (if one exists).
+     * Tokens refer to the buffer's memory which therefore must outlive the tokenizer.
+     * \param source
+     */
+    explicit Tokenizer(std::string_view source)
+        : lexerMode_{LexerMode::SCANNER}, source_{source}, currentLineNr_{1} { updateNextToken(); }
+
+    /**
+     * \brief Creates a new tokenizer that walks the tokens of a pre-lexed token-buffer by index
+     * and gets ready to parse the first token (if one exists). The token-buffer must outlive the tokenizer.
+     * \param tokenBuffer
      */
-    explicit Tokenizer(std::istream& inputStream) : inputStream_{inputStream} { updateNextToken(); }
+    explicit Tokenizer(const TokenBuffer& tokenBuffer)
+        : lexerMode_{LexerMode::SCANNER}, tokenBuffer_{&tokenBuffer} { updateNextToken(); }
+
+    /**
+     * \brief Starts to lex another contiguous buffer like a tokenizer created for it, so that the tokenizer
+     * can be reused. Views of tokens of the previous input must not be used afterwards.
+     * \param source
+     */
+    void reset(std::string_view source);
 
     /**
      * \brief Checks if there exists another valid token in the input-stream.
      * \return True if another token exists, otherwise false
      */
-    bool hasMoreTokens() const { return !nextToken_.empty(); }
+    bool hasMoreTokens() const { return !nextToken_.empty() || invalidTokenAhead_; }
 
     /**
      * \brief Sets the current token to the next token encountered
-     * in the input-stream. Will throw a runtime_error if no next token exists.
+     * in the input-stream. Will throw a CompilationError if no next token exists or the input
+     * contains an invalid token.
      */
     void advance();
 
+    /**
+     * \brief Checks if advancing has failed because of an error in the input, after which the
+     * tokenizer cannot advance any further.
+     * \return True if advancing has failed, otherwise false
+     */
+    bool failed() const { return failed_; }
+
+    /**
+     * \brief Gets the symbol of a token following the current token without advancing. The next
+     * token (distance 1) can always be examined, tokens further ahead are only available when walking
+     * a pre-lexed token-buffer.
+     * \param distance The distance of the token from the current token
+     * \return The symbol or '\0' if the token is not a symbol or does not exist
+     */
+    char peekSymbol(size_t distance = 1) const;
+
     /**
      * \brief Gets the type of the current token.
      * \return The token-type
@@ -62,43 +127,81 @@ public:
     /**
      * \brief Gets the identifier that is the current token. Most
      * only be called if the current token's type is IDENTIFIER.
+     * The returned view remains valid as long as the tokenizer exists: When lexing from a buffer
+     * it refers to the buffer's memory, otherwise the identifier is interned, so that every
+     * distinct identifier is only stored once.
      * \return The identifier
      */
-    std::string identifier() const { return currentToken_; }
+    std::string_view identifier() const { return currentToken_; }
 
     /**
      * \brief Gets the integer-value that is represented by the current token.
      * Must only be called if the current token's type is INT_CONST.
      * \return The integer-value
      */
-    int intVal() const { return std::stoi(currentToken_); }
+    int intVal() const;
 
     /**
-     * \brief Gets the string-value that is represented by the current token 
+     * \brief Gets the string-value that is represented by the current token
      * (without the enclosing double quotes). Most only be called if the current
-     * token's type is STRING_CONST.
+     * token's type is STRING_CONST. Unless the tokenizer lexes from a buffer, the returned
+     * view is only valid until the next call of advance().
      * \return The string-value
      */
-    std::string stringVal() const { return currentToken_.substr(1, currentToken_.size() - 2); }
-    
+    std::string_view stringVal() const { return currentToken_.substr(1, currentToken_.size() - 2); }
+
     /**
      * \brief Gets the line number of the current token.
      * \return The line number
      */
-    size_t getCurrentLine() const { return currentLineNr_; }
+    size_t getCurrentLine() const { return currentTokenLineNr_; }
 
 private:
-    std::istream& inputStream_;
-    std::string currentToken_;
-    std::string currentLine_;
-    std::smatch currentKeywordMatch_;
-    std::sregex_token_iterator currentLineTokenIterator_;
+    std::istream* inputStream_{};
+    LexerMode lexerMode_;
+    std::string_view source_;
     size_t currentLineNr_{};
+    size_t currentTokenLineNr_{};
+    size_t nextTokenLineNr_{};
+    std::string_view currentToken_;
     TokenType currentTokenType_{};
     KeyWordType currentKeyWordType_{};
-    std::string nextToken_;
+    std::string_view nextToken_;
+    bool failed_{};
+    StringInterner identifierInterner_;
+
+    // token-buffer state
+    const TokenBuffer* tokenBuffer_{};
+    size_t nextTokenIndex_{};
+    // the token-buffer's lexing stopped at the next token because of an error
+    bool invalidTokenAhead_{};
+
+    // scanner state
+    size_t sourcePos_{};
+    size_t chunkSize_{};
+    std::array<std::string, 2> chunkBuffers_;
+    size_t chunkBufferIndex_{};
+    bool endOfInput_{};
+    bool inLineComment_{};
+    bool inBlockComment_{};
+    size_t blockCommentStartLine_{};
+    bool nextTokenValid_{};
+    TokenType nextTokenType_{};
+    KeyWordType nextKeyWordType_{};
+
+    // regex-lexer state
+    std::string currentLine_;
+    std::sregex_token_iterator currentLineTokenIterator_;
+    std::array<std::string, 2> regexTokenBuffers_;
+    size_t regexTokenBufferIndex_{};
 
     void parseCurrentToken();
     void updateNextToken();
-};
+    void updateNextTokenRegex();
+    void scanNextToken();
+    bool skipWhitespaceAndComments();
+    bool readNextChunk(size_t chunkBufferIndex);
+    bool moreInputAvailable() const { return inputStream_ != nullptr && !endOfInput_; }
 
+    friend class TokenBuffer;
+};
@@ -1,5 +1,9 @@
 #pragma once
+#include "Arena.h"
+#include "OptimizationStatistics.h"
 #include <ostream>
+#include <string_view>
+#include <vector>
 
 namespace JackCompiler {
     class VMWriter {
@@ -14,71 +18,202 @@ namespace JackCompiler {
          */
         enum class Command { ADD, SUB, NEG, EQ, GT, LT, AND, OR, NOT };
 
+        /**
+         * \brief A single virtual-machine instruction.
+         */
+        struct Instruction {
+            enum class Type { PUSH, POP, ARITHMETIC, LABEL, GOTO, IF_GOTO, CALL, FUNCTION, RETURN };
+
+            Type type{};
+            Segment segment{};
+            Command command{};
+            // the index (PUSH, POP), the number of arguments (CALL) or the number of locals (FUNCTION)
+            int value{};
+            // the label (LABEL, GOTO, IF_GOTO) or the (class-)name (CALL, FUNCTION)
+            std::string_view name;
+            // the subroutine-name (CALL, FUNCTION) if the class-name is provided separately
+            std::string_view subroutineName;
+
+            // Factories that initialize all members of an instruction of a specific type. The class-name of a
+            // call or function may also be its full name, if no subroutine-name is provided.
+            static constexpr Instruction push(Segment segment, int index) {
+                return {Type::PUSH, segment, Command{}, index, {}, {}};
+            }
+
+            static constexpr Instruction pop(Segment segment, int index) {
+                return {Type::POP, segment, Command{}, index, {}, {}};
+            }
+
+            static constexpr Instruction arithmetic(Command command) {
+                return {Type::ARITHMETIC, Segment{}, command, 0, {}, {}};
+            }
+
+            static constexpr Instruction label(std::string_view name) {
+                return {Type::LABEL, Segment{}, Command{}, 0, name, {}};
+            }
+
+            static constexpr Instruction goTo(std::string_view name) {
+                return {Type::GOTO, Segment{}, Command{}, 0, name, {}};
+            }
+
+            static constexpr Instruction ifGoTo(std::string_view name) {
+                return {Type::IF_GOTO, Segment{}, Command{}, 0, name, {}};
+            }
+
+            static constexpr Instruction call(std::string_view className, std::string_view subroutineName, int nArgs) {
+                return {Type::CALL, Segment{}, Command{}, nArgs, className, subroutineName};
+            }
+
+            static constexpr Instruction function(std::string_view className, std::string_view subroutineName, int nLocals) {
+                return {Type::FUNCTION, Segment{}, Command{}, nLocals, className, subroutineName};
+            }
+
+            static constexpr Instruction returnFromFunction() {
+                return {Type::RETURN, Segment{}, Command{}, 0, {}, {}};
+            }
+        };
+
         /**
          * \brief Creates a new VMWriter object that provides functionality to write 
          * Hack virtual-machine language constructs to a provided output-stream.
          * \param outputStream 
          */
-        explicit VMWriter(std::ostream& outputStream) : outputStream_{outputStream} {}
+        explicit VMWriter(std::ostream& outputStream) : outputStream_{&outputStream} {}
+
+        /**
+         * \brief Creates a new VMWriter object that buffers the instructions of each function and
+         * runs the peephole optimizer over them before they are written to a provided output-stream.
+         * \param outputStream 
+         * \param statistics The statistics that record the number of instructions removed per rule
+         */
+        VMWriter(std::ostream& outputStream, OptimizationStatistics& statistics) 
+            : outputStream_{&outputStream}, statistics_{&statistics} {}
+
+        /**
+         * \brief Discards all buffered instructions and starts writing to another output-stream, so that the
+         * writer (and the memory it has allocated) can be reused for another class.
+         * \param outputStream 
+         * \param statistics The statistics of the peephole optimizer or nullptr if it should not be used
+         */
+        void reset(std::ostream& outputStream, OptimizationStatistics* statistics);
 
         /**
          * \brief Writes a push command to the output-stream.
          * \param segment The source RAM-segment (or the pseudo-segment CONST)
          * \param index The index in the RAM-segment (or the value to be pushed if segment is CONST)
          */
-        void writePush(Segment segment, int index) const;
+        void writePush(Segment segment, int index);
 
         /**
          * \brief Writes a pop command to the output-stream.
          * \param segment The target RAM-segment (must not be CONST)
          * \param index The index in the RAM-segment
          */
-        void writePop(Segment segment, int index) const;
+        void writePop(Segment segment, int index);
 
         /**
          * \brief Writes an arithmetic command to the output-stream.
          * \param command The type of command
          */
-        void writeArithmetic(Command command) const;
+        void writeArithmetic(Command command);
 
         /**
          * \brief Writes a label to the output-stream.
          * \param label The name of the label
          */
-        void writeLabel(const std::string& label) const;
+        void writeLabel(std::string_view label);
 
         /**
          * \brief Writes a goto-statement to the output-stream.
          * \param label The target-label of the goto
          */
-        void writeGoto(const std::string& label) const;
+        void writeGoto(std::string_view label);
 
         /**
          * \brief Writes a goto-if-statement to the output-stream.
          * \param label The target of the goto-if
          */
-        void writeIf(const std::string& label) const;
+        void writeIf(std::string_view label);
 
         /**
          * \brief Write a function-call-statement to the output-stream. 
          * \param name The name of the function
          * \param nArgs The number of arguments of the function
          */
-        void writeCall(const std::string& name, int nArgs) const;
+        void writeCall(std::string_view name, int nArgs);
+
+        /**
+         * \brief Write a function-call-statement for the function <className>.<subroutineName>
+         * to the output-stream.
+         * \param className The name of the class the function belongs to
+         * \param subroutineName The name of the function within its class
+         * \param nArgs The number of arguments of the function
+         */
+        void writeCall(std::string_view className, std::string_view subroutineName, int nArgs);
 
         /**
          * \brief Write a function-declaration-statement to the output-stream.
          * \param name The name of the function
          * \param nLocals The number of local variables of the function
          */
-        void writeFunction(const std::string& name, int nLocals) const;
+        void writeFunction(std::string_view name, int nLocals);
+
+        /**
+         * \brief Write a function-declaration-statement for the function <className>.<subroutineName>
+         * to the output-stream.
+         * \param className The name of the class the function belongs to
+         * \param subroutineName The name of the function within its class
+         * \param nLocals The number of local variables of the function
+         */
+        void writeFunction(std::string_view className, std::string_view subroutineName, int nLocals);
 
         /**
          * \brief Write a return-statement to the output-stream.
          */
-        void writeReturn() const;
+        void writeReturn();
+
+        /**
+         * \brief Writes an instruction to the output-stream.
+         * \param instruction 
+         */
+        void writeInstruction(const Instruction& instruction) { emit(instruction); }
+
+        /**
+         * \brief Enables or disables the suppression of instructions. Suppressed instructions are
+         * only counted, but not written.
+         * \param suppressed 
+         */
+        void setSuppressed(bool suppressed) { suppressed_ = suppressed; }
+
+        /**
+         * \brief Checks if instructions are currently suppressed.
+         * \return True if instructions are suppressed, otherwise false
+         */
+        bool suppressed() const { return suppressed_; }
+
+        /**
+         * \brief Gets the number of instructions that have been suppressed so far.
+         * \return The number of suppressed instructions
+         */
+        size_t suppressedInstructionCount() const { return suppressedInstructionCount_; }
+
+        /**
+         * \brief Optimizes and writes all buffered instructions to the output-stream. Must be
+         * called after the last instruction has been written if the peephole optimizer is used.
+         */
+        void flush();
 
     private:
-        std::ostream& outputStream_;
+        std::ostream* outputStream_;
+        // the peephole optimizer is used if statistics are provided
+        OptimizationStatistics* statistics_{};
+        std::vector<Instruction> instructions_;
+        // storage for the names of buffered instructions
+        Arena nameArena_;
+        bool suppressed_{};
+        size_t suppressedInstructionCount_{};
+
+        void emit(const Instruction& instruction);
+        void write(const Instruction& instruction);
     };
 }
@@ -0,0 +1,50 @@
+#pragma once
+#include "Ast.h"
+#include <unordered_map>
+
+namespace JackCompiler {
+    class ValueNumbering;
+}
+
+class JackCompiler::ValueNumbering {
+public:
+    /**
+     * \brief The temp-variables that hold reused values (temp 0 is used as scratch-space by other lowerings).
+     */
+    static constexpr int FIRST_TEMP_INDEX = 1;
+    static constexpr int LAST_TEMP_INDEX = 7;
+
+    /**
+     * \brief How an expression of the basic block is compiled: Either it is computed and additionally stored
+     * in a temp-variable, or its value is loaded from the temp-variable instead of computing it again.
+     */
+    struct Reuse {
+        bool load;
+        int tempIndex;
+    };
+
+    /**
+     * \brief Numbers the values computed by a basic block, i.e. a sequence of let-, do- and return-statements
+     * that may be followed by the condition of an if-statement, and decides which repeated values are kept in
+     * temp-variables. Values that depend on fields, static variables or array elements are not reused across
+     * assignments to them or calls, values held in temp-variables are not reused across calls (including the
+     * ones of Math.multiply, Math.divide and String.new), since the callee may use the temp-segment as well.
+     * A value is only reused if the estimated number of executed Hack instructions decreases.
+     * \param statements The statements of the block, which must outlive the value numbering
+     * \param condition The condition that ends the block or nullptr
+     */
+    ValueNumbering(const Ast::List<const Ast::Statement*>& statements, const Ast::Expression* condition);
+
+    /**
+     * \brief Gets how an expression of the basic block is compiled.
+     * \param expression
+     * \return The reuse of its value or nullptr if it is computed as usual
+     */
+    const Reuse* find(const Ast::Expression& expression) const {
+        const auto reuse = reuses_.find(&expression);
+        return reuse != reuses_.cend() ? &reuse->second : nullptr;
+    }
+
+private:
+    std::unordered_map<const Ast::Expression*, Reuse> reuses_;
+};
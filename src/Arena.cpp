@@ -0,0 +1,50 @@
+#include "Arena.h"
+#include <algorithm>
+
+using std::unique_ptr;
+using std::max;
+using std::uintptr_t;
+
+namespace JackCompiler {
+    void Arena::reset() {
+        currentBlockIndex_ = 0;
+        current_ = blocks_.empty() ? nullptr : blocks_.front().data.get();
+        end_ = blocks_.empty() ? nullptr : current_ + blocks_.front().size;
+    }
+
+    size_t Arena::capacity() const {
+        size_t bytes{};
+
+        for(const auto& block : blocks_) {
+            bytes += block.size;
+        }
+
+        return bytes;
+    }
+
+    void* Arena::allocateFromNextBlock(size_t size, size_t alignment) {
+        const auto requiredSize = size + alignment - 1;
+
+        // blocks kept by reset() are reused if they are large enough
+        auto nextBlockIndex = (current_ == nullptr ? 0 : currentBlockIndex_ + 1);
+
+        while(nextBlockIndex < blocks_.size() && blocks_[nextBlockIndex].size < requiredSize) {
+            ++nextBlockIndex;
+        }
+
+        if(nextBlockIndex == blocks_.size()) {
+            // objects that are larger than a block get a block of their own
+            const auto blockSize = max(blockSize_, requiredSize);
+            // the memory is not value-initialized, every object is constructed in place
+            blocks_.push_back({unique_ptr<char[]>{new char[blockSize]}, blockSize});
+        }
+
+        currentBlockIndex_ = nextBlockIndex;
+        current_ = blocks_[currentBlockIndex_].data.get();
+        end_ = current_ + blocks_[currentBlockIndex_].size;
+
+        const auto alignedAddress = (reinterpret_cast<uintptr_t>(current_) + alignment - 1) & ~(alignment - 1);
+        current_ = reinterpret_cast<char*>(alignedAddress + size);
+        return reinterpret_cast<void*>(alignedAddress);
+    }
+}
@@ -0,0 +1,151 @@
+#include "BuildManifest.h"
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <system_error>
+
+using std::string;
+using std::string_view;
+using std::ifstream;
+using std::ofstream;
+using std::istringstream;
+using std::error_code;
+namespace fs = std::filesystem;
+
+namespace JackCompiler {
+    namespace {
+        constexpr string_view MANIFEST_HEADER{"jack-compiler-manifest 1"};
+
+        // modification times are only stored if they are older than this, since a file could be modified again
+        // within the resolution of the file system's timestamps without changing its modification time
+        constexpr std::chrono::seconds MODIFICATION_TIME_RESOLUTION{2};
+
+        std::int64_t timeOf(fs::file_time_type time) {
+            return static_cast<std::int64_t>(time.time_since_epoch().count());
+        }
+    }
+
+    BuildManifest BuildManifest::load(const fs::path& directoryPath, ContentHash::Hash configuration) {
+        BuildManifest manifest{configuration};
+        ifstream manifestFile{directoryPath / FILE_NAME};
+        string line;
+
+        if(!std::getline(manifestFile, line) || line != MANIFEST_HEADER || !std::getline(manifestFile, line) ||
+           line != "configuration " + ContentHash::toString(configuration)) {
+            return manifest;
+        }
+
+        while(std::getline(manifestFile, line)) {
+            // sourceSize sourceTime sourceHash tokenHash outputSize outputTime outputHash fileName
+            istringstream fields{line};
+            Entry entry;
+            string sourceHash;
+            string tokenHash;
+            string outputHash;
+            string fileName;
+
+            fields >> entry.sourceSize >> entry.sourceTime >> sourceHash >> tokenHash >> entry.outputSize 
+                   >> entry.outputTime >> outputHash;
+            fields.ignore(1);
+            std::getline(fields, fileName);
+
+            const auto parsedSourceHash = ContentHash::fromString(sourceHash);
+            const auto parsedTokenHash = ContentHash::fromString(tokenHash);
+            const auto parsedOutputHash = ContentHash::fromString(outputHash);
+
+            if(!fields.eof() || fileName.empty() || !parsedSourceHash || !parsedTokenHash || !parsedOutputHash) {
+                // an invalid manifest cannot be trusted at all
+                return BuildManifest{configuration};
+            }
+
+            entry.sourceHash = *parsedSourceHash;
+            entry.tokenHash = *parsedTokenHash;
+            entry.outputHash = *parsedOutputHash;
+            manifest.set(fileName, entry);
+        }
+
+        return manifest;
+    }
+
+    bool BuildManifest::save(const fs::path& directoryPath) const {
+        const auto manifestPath = directoryPath / FILE_NAME;
+        // concurrent writers (e.g. requests of the compile server) must not share a temporary file
+        std::random_device randomDevice;
+        const auto random = (static_cast<ContentHash::Hash>(randomDevice()) << 32) | randomDevice();
+        auto temporaryPath = manifestPath;
+        temporaryPath += ".tmp." + ContentHash::toString(random);
+        error_code error;
+
+        {
+            ofstream manifestFile{temporaryPath};
+            manifestFile << MANIFEST_HEADER << '\n' << "configuration " << ContentHash::toString(configuration_) << '\n';
+
+            for(const auto& [fileName, entry] : entries_) {
+                manifestFile << entry.sourceSize << ' ' << entry.sourceTime << ' ' << ContentHash::toString(entry.sourceHash) << ' '
+                             << ContentHash::toString(entry.tokenHash) << ' ' << entry.outputSize << ' ' << entry.outputTime << ' '
+                             << ContentHash::toString(entry.outputHash) << ' ' << fileName << '\n';
+            }
+
+            if(!manifestFile.flush()) {
+                manifestFile.close();
+                fs::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        fs::rename(temporaryPath, manifestPath, error);
+
+        if(error) {
+            error_code removeError;
+            fs::remove(temporaryPath, removeError);
+        }
+
+        return !error;
+    }
+
+    const BuildManifest::Entry* BuildManifest::find(string_view fileName) const {
+        const auto entry = entries_.find(fileName);
+        return entry != entries_.cend() ? &entry->second : nullptr;
+    }
+
+    void BuildManifest::erase(string_view fileName) {
+        if(const auto entry = entries_.find(fileName); entry != entries_.end()) {
+            entries_.erase(entry);
+        }
+    }
+
+    std::int64_t BuildManifest::modificationTimeOf(const fs::path& path) {
+        error_code error;
+        const auto time = fs::last_write_time(path, error);
+
+        if(error || time > fs::file_time_type::clock::now() - MODIFICATION_TIME_RESOLUTION) {
+            return 0;
+        }
+
+        return timeOf(time);
+    }
+
+    bool BuildManifest::isOutputUpToDate(const Entry& entry, const fs::path& outputPath) {
+        error_code error;
+        const auto size = fs::file_size(outputPath, error);
+
+        if(error || size != entry.outputSize) {
+            return false;
+        }
+
+        if(entry.outputTime != 0 && timeOf(fs::last_write_time(outputPath, error)) == entry.outputTime && !error) {
+            return true;
+        }
+
+        // without a reliable modification time the output has to be read
+        ifstream outputFile{outputPath, std::ios::binary};
+
+        if(!outputFile) {
+            return false;
+        }
+
+        const string output{std::istreambuf_iterator<char>{outputFile}, std::istreambuf_iterator<char>{}};
+        return ContentHash::of(output) == entry.outputHash;
+    }
+}
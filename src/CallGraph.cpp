@@ -0,0 +1,126 @@
+#include "CallGraph.h"
+#include <algorithm>
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::ostream;
+using std::unordered_map;
+
+namespace JackCompiler {
+    namespace {
+        const string SYSTEM_ENTRY_POINT{"Sys.init"};
+        const string PROGRAM_ENTRY_POINT{"Main.main"};
+
+        string qualifiedName(string_view className, string_view subroutineName) {
+            string name{className};
+            name += '.';
+            name += subroutineName;
+            return name;
+        }
+
+        /**
+         * \brief Adds the subroutines called by statements to a list of callees. The body of an inlined
+         * subroutine replaces its call, so the calls generated for that body are made by the caller.
+         */
+        void addCallees(const Ast::List<const Ast::Statement*>& statements, string_view className,
+                        const Inliner* inliner, vector<string>& callees) {
+            Ast::forEachExpression(statements, [&] (const Ast::Expression& expression) {
+                if(const auto* call = expression.as<Ast::SubroutineCall>()) {
+                    const auto* candidate = inliner != nullptr ? inliner->find(*call, className) : nullptr;
+
+                    if(candidate == nullptr) {
+                        callees.push_back(qualifiedName(call->className, call->subroutineName));
+                    }
+                    else {
+                        addCallees(candidate->subroutine->statements, candidate->astClass->name, inliner, callees);
+                    }
+                }
+                else if(const auto* binaryOp = expression.as<Ast::BinaryOp>()) {
+                    if(binaryOp->op == '*') {
+                        callees.emplace_back("Math.multiply");
+                    }
+                    else if(binaryOp->op == '/') {
+                        callees.emplace_back("Math.divide");
+                    }
+                }
+                else if(expression.kind == Ast::Expression::Kind::STRING_CONST) {
+                    callees.emplace_back("String.new");
+                    callees.emplace_back("String.appendChar");
+                }
+            });
+        }
+    }
+
+    CallGraph::CallGraph(const vector<const Ast::Class*>& classes, const Inliner* inliner) {
+        unordered_map<string, const Ast::Subroutine*> subroutines;
+        unordered_map<const Ast::Subroutine*, vector<string>> callees;
+
+        for(const auto* astClass : classes) {
+            for(const auto* subroutine : astClass->subroutines) {
+                subroutines.emplace(qualifiedName(astClass->name, subroutine->name), subroutine);
+                auto& subroutineCallees = callees[subroutine];
+
+                if(subroutine->type == Tokenizer::KeyWordType::CONSTRUCTOR) {
+                    subroutineCallees.emplace_back("Memory.alloc");
+                }
+
+                addCallees(subroutine->statements, astClass->name, inliner, subroutineCallees);
+            }
+        }
+
+        subroutineCount_ = subroutines.size();
+
+        if(subroutines.count(SYSTEM_ENTRY_POINT) > 0) {
+            entryPoint_ = SYSTEM_ENTRY_POINT;
+        }
+        else if(subroutines.count(PROGRAM_ENTRY_POINT) > 0) {
+            entryPoint_ = PROGRAM_ENTRY_POINT;
+        }
+        else {
+            return;
+        }
+
+        vector<const Ast::Subroutine*> pending{subroutines.at(entryPoint_)};
+        reachable_.insert(pending.back());
+
+        while(!pending.empty()) {
+            const auto* subroutine = pending.back();
+            pending.pop_back();
+
+            for(const auto& callee : callees.at(subroutine)) {
+                // calls of subroutines that are not part of the program (e.g. of the OS) are ignored
+                const auto it = subroutines.find(callee);
+
+                if(it != subroutines.end() && reachable_.insert(it->second).second) {
+                    pending.push_back(it->second);
+                }
+            }
+        }
+
+        for(const auto& [name, subroutine] : subroutines) {
+            if(reachable_.count(subroutine) == 0) {
+                unreachableNames_.push_back(name);
+            }
+        }
+
+        std::sort(unreachableNames_.begin(), unreachableNames_.end());
+    }
+
+    void CallGraph::printReport(ostream& outputStream) const {
+        if(!hasEntryPoint()) {
+            outputStream << "Reachability: Neither " << SYSTEM_ENTRY_POINT << " nor " << PROGRAM_ENTRY_POINT 
+                         << " exists, all subroutines are kept.\n";
+            return;
+        }
+
+        outputStream << "Reachability (from " << entryPoint_ << "): " << reachable_.size() << " of " 
+                     << subroutineCount_ << " subroutines reachable\n";
+
+        for(const auto& name : unreachableNames_) {
+            outputStream << "  unreachable: " << name << '\n';
+        }
+
+        outputStream.flush();
+    }
+}
@@ -0,0 +1,217 @@
+#include "CharScanner.h"
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JACK_COMPILER_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define JACK_COMPILER_SIMD_SSE2
+#endif
+
+#if defined(_MSC_VER) && (defined(JACK_COMPILER_SIMD_AVX2) || defined(JACK_COMPILER_SIMD_SSE2))
+#include <intrin.h>
+#endif
+
+using std::string_view;
+using std::uint32_t;
+
+namespace JackCompiler::CharScanner {
+    namespace {
+        constexpr bool isWhitespace(char c) {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+#if defined(JACK_COMPILER_SIMD_AVX2) || defined(JACK_COMPILER_SIMD_SSE2)
+        inline unsigned countTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        inline size_t popCount(uint32_t mask) {
+#ifdef _MSC_VER
+            return __popcnt(mask);
+#else
+            return static_cast<size_t>(__builtin_popcount(mask));
+#endif
+        }
+
+        // mask of the bits below the lowest set bit of a non-zero mask
+        inline uint32_t bitsBelowLowest(uint32_t mask) {
+            return (mask & (0 - mask)) - 1;
+        }
+
+#ifdef JACK_COMPILER_SIMD_AVX2
+        struct Simd {
+            using Vector = __m256i;
+            static constexpr size_t WIDTH = 32;
+            static constexpr uint32_t FULL_MASK = 0xFFFFFFFFu;
+
+            static Vector load(const char* data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+            static Vector broadcast(char c) { return _mm256_set1_epi8(c); }
+            static Vector equal(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+            static Vector bitOr(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+            static Vector bitAnd(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+            static Vector subtract(Vector a, Vector b) { return _mm256_sub_epi8(a, b); }
+            static Vector minUnsigned(Vector a, Vector b) { return _mm256_min_epu8(a, b); }
+            static uint32_t mask(Vector a) { return static_cast<uint32_t>(_mm256_movemask_epi8(a)); }
+        };
+#else
+        struct Simd {
+            using Vector = __m128i;
+            static constexpr size_t WIDTH = 16;
+            static constexpr uint32_t FULL_MASK = 0xFFFFu;
+
+            static Vector load(const char* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+            static Vector broadcast(char c) { return _mm_set1_epi8(c); }
+            static Vector equal(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+            static Vector bitOr(Vector a, Vector b) { return _mm_or_si128(a, b); }
+            static Vector bitAnd(Vector a, Vector b) { return _mm_and_si128(a, b); }
+            static Vector subtract(Vector a, Vector b) { return _mm_sub_epi8(a, b); }
+            static Vector minUnsigned(Vector a, Vector b) { return _mm_min_epu8(a, b); }
+            static uint32_t mask(Vector a) { return static_cast<uint32_t>(_mm_movemask_epi8(a)); }
+        };
+#endif
+#endif
+    }
+
+    namespace Scalar {
+        size_t skipWhitespace(string_view text, size_t pos, size_t& newlineCount) {
+            for(; pos < text.size() && isWhitespace(text[pos]); ++pos) {
+                if(text[pos] == '\n') {
+                    ++newlineCount;
+                }
+            }
+
+            return pos;
+        }
+
+        size_t find(string_view text, size_t pos, char c) {
+            for(; pos < text.size() && text[pos] != c; ++pos) {}
+            return pos;
+        }
+
+        size_t findEither(string_view text, size_t pos, char c1, char c2) {
+            for(; pos < text.size() && text[pos] != c1 && text[pos] != c2; ++pos) {}
+            return pos;
+        }
+
+        size_t findBlockCommentEnd(string_view text, size_t pos, size_t& newlineCount) {
+            for(; pos < text.size(); ++pos) {
+                if(text[pos] == '*' && pos + 1 < text.size() && text[pos + 1] == '/') {
+                    return pos;
+                }
+
+                if(text[pos] == '\n') {
+                    ++newlineCount;
+                }
+            }
+
+            return text.size();
+        }
+    }
+
+#if defined(JACK_COMPILER_SIMD_AVX2) || defined(JACK_COMPILER_SIMD_SSE2)
+    size_t skipWhitespace(string_view text, size_t pos, size_t& newlineCount) {
+        // Most whitespace-runs are short, so the first bytes are checked without SIMD.
+        if(pos < text.size() && !isWhitespace(text[pos])) {
+            return pos;
+        }
+
+        const auto space = Simd::broadcast(' ');
+        const auto newline = Simd::broadcast('\n');
+        const auto tab = Simd::broadcast('\t');
+        const auto controlWhitespaceRange = Simd::broadcast('\r' - '\t');
+
+        for(; pos + Simd::WIDTH <= text.size(); pos += Simd::WIDTH) {
+            const auto chunk = Simd::load(text.data() + pos);
+            // '\t', '\n', '\v', '\f' and '\r' are consecutive: c is one of them if (c - '\t') <= ('\r' - '\t') (unsigned)
+            const auto offset = Simd::subtract(chunk, tab);
+            const auto isControlWhitespace = Simd::equal(Simd::minUnsigned(offset, controlWhitespaceRange), offset);
+            const auto whitespaceMask = Simd::mask(Simd::bitOr(Simd::equal(chunk, space), isControlWhitespace));
+            const auto newlineMask = Simd::mask(Simd::equal(chunk, newline));
+
+            if(const auto nonWhitespaceMask = ~whitespaceMask & Simd::FULL_MASK; nonWhitespaceMask != 0) {
+                newlineCount += popCount(newlineMask & bitsBelowLowest(nonWhitespaceMask));
+                return pos + countTrailingZeros(nonWhitespaceMask);
+            }
+
+            newlineCount += popCount(newlineMask);
+        }
+
+        return Scalar::skipWhitespace(text, pos, newlineCount);
+    }
+
+    size_t find(string_view text, size_t pos, char c) {
+        const auto target = Simd::broadcast(c);
+
+        for(; pos + Simd::WIDTH <= text.size(); pos += Simd::WIDTH) {
+            if(const auto mask = Simd::mask(Simd::equal(Simd::load(text.data() + pos), target)); mask != 0) {
+                return pos + countTrailingZeros(mask);
+            }
+        }
+
+        return Scalar::find(text, pos, c);
+    }
+
+    size_t findEither(string_view text, size_t pos, char c1, char c2) {
+        const auto target1 = Simd::broadcast(c1);
+        const auto target2 = Simd::broadcast(c2);
+
+        for(; pos + Simd::WIDTH <= text.size(); pos += Simd::WIDTH) {
+            const auto chunk = Simd::load(text.data() + pos);
+
+            if(const auto mask = Simd::mask(Simd::bitOr(Simd::equal(chunk, target1), Simd::equal(chunk, target2)));
+               mask != 0) {
+                return pos + countTrailingZeros(mask);
+            }
+        }
+
+        return Scalar::findEither(text, pos, c1, c2);
+    }
+
+    size_t findBlockCommentEnd(string_view text, size_t pos, size_t& newlineCount) {
+        const auto star = Simd::broadcast('*');
+        const auto slash = Simd::broadcast('/');
+        const auto newline = Simd::broadcast('\n');
+
+        // every chunk is compared together with the chunk shifted by one byte, so one additional byte is required
+        for(; pos + Simd::WIDTH + 1 <= text.size(); pos += Simd::WIDTH) {
+            const auto chunk = Simd::load(text.data() + pos);
+            const auto nextChunk = Simd::load(text.data() + pos + 1);
+            const auto endMask = Simd::mask(Simd::bitAnd(Simd::equal(chunk, star), Simd::equal(nextChunk, slash)));
+            const auto newlineMask = Simd::mask(Simd::equal(chunk, newline));
+
+            if(endMask != 0) {
+                newlineCount += popCount(newlineMask & bitsBelowLowest(endMask));
+                return pos + countTrailingZeros(endMask);
+            }
+
+            newlineCount += popCount(newlineMask);
+        }
+
+        return Scalar::findBlockCommentEnd(text, pos, newlineCount);
+    }
+#else
+    size_t skipWhitespace(string_view text, size_t pos, size_t& newlineCount) {
+        return Scalar::skipWhitespace(text, pos, newlineCount);
+    }
+
+    size_t find(string_view text, size_t pos, char c) {
+        return Scalar::find(text, pos, c);
+    }
+
+    size_t findEither(string_view text, size_t pos, char c1, char c2) {
+        return Scalar::findEither(text, pos, c1, c2);
+    }
+
+    size_t findBlockCommentEnd(string_view text, size_t pos, size_t& newlineCount) {
+        return Scalar::findBlockCommentEnd(text, pos, newlineCount);
+    }
+#endif
+}
@@ -1,30 +1,153 @@
 #include "CompilationEngine.h"
+#include "ConstantFolding.h"
+#include "StrengthReduction.h"
 #include <algorithm>
 #include <array>
+#include <optional>
 #include <sstream>
 
 using std::runtime_error;
 using std::string;
+using std::string_view;
 using std::to_string;
 using std::initializer_list;
 using std::array;
-using std::unordered_map;
 using std::stringstream;
 using std::find;
+using std::optional;
+using std::vector;
+using std::pair;
 
 namespace JackCompiler {
     namespace {
-        const array<char, 9> OPS{'+', '-', '*', '/', '&', '|', '<', '>', '='};
-        const array<char, 2> UNARY_OPS{'-', '~'};
+        constexpr array<char, 9> OPS{'+', '-', '*', '/', '&', '|', '<', '>', '='};
+        constexpr array<char, 2> UNARY_OPS{'-', '~'};
+
+        constexpr string_view STRING_POOL_READY_LABEL{"STRING_POOL_READY"};
+
+        bool terminates(const Ast::List<const Ast::Statement*>& statements);
+
+        /**
+         * \brief Finds the end of the basic block that starts with a statement. Let-, do- and return-statements
+         * are executed in sequence, a basic block ends after a return-statement or with the condition of an
+         * if-statement, which is evaluated before the first jump (unlike the condition of a while-statement).
+         * \param statements 
+         * \param first The index of the first statement of the basic block
+         * \return The index following the last statement of the basic block
+         */
+        size_t findBasicBlockEnd(const Ast::List<const Ast::Statement*>& statements, size_t first) {
+            for(size_t i = first; i < statements.size(); ++i) {
+                switch(statements[i]->kind) {
+                    case Ast::Statement::Kind::LET:
+                    case Ast::Statement::Kind::DO:
+                        break;
+                    case Ast::Statement::Kind::RETURN:
+                    case Ast::Statement::Kind::IF:
+                        return i + 1;
+                    case Ast::Statement::Kind::WHILE:
+                        return std::max(i, first + 1);
+                }
+            }
+
+            return statements.size();
+        }
+
+        /**
+         * \brief Checks if an expression is known to be either true (-1) or false (0). Only for such
+         * expressions negating the value (not) and checking it for being non-zero (if-goto) are equivalent
+         * to checking if it is false. Variables never are, since Jack does not check the types of assigned values.
+         */
+        bool isBoolean(const Ast::Expression& expression) {
+            switch(expression.kind) {
+                case Ast::Expression::Kind::INT_CONST: {
+                    const int value = expression.as<Ast::IntConstant>()->value;
+                    return value == ConstantFolding::TRUE_VALUE || value == ConstantFolding::FALSE_VALUE;
+                }
+                case Ast::Expression::Kind::KEYWORD_CONST: {
+                    const auto keyword = expression.as<Ast::KeywordConstant>()->keyword;
+                    return keyword == Tokenizer::KeyWordType::TRUE || keyword == Tokenizer::KeyWordType::FALSE;
+                }
+                case Ast::Expression::Kind::UNARY_OP: {
+                    const auto* unaryOp = expression.as<Ast::UnaryOp>();
+                    return unaryOp->op == '~' && isBoolean(*unaryOp->operand);
+                }
+                case Ast::Expression::Kind::BINARY_OP: {
+                    const auto* binaryOp = expression.as<Ast::BinaryOp>();
+
+                    switch(binaryOp->op) {
+                        case '<':
+                        case '>':
+                        case '=':
+                            return true;
+                        case '&':
+                        case '|':
+                            return isBoolean(*binaryOp->left) && isBoolean(*binaryOp->right);
+                        default:
+                            return false;
+                    }
+                }
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * \brief Checks if the statements following a statement are unreachable because the statement
+         * always returns or never ends, considering constant conditions.
+         */
+        bool terminates(const Ast::Statement& statement) {
+            switch(statement.kind) {
+                case Ast::Statement::Kind::RETURN:
+                    return true;
+                case Ast::Statement::Kind::IF: {
+                    const auto* ifStatement = statement.as<Ast::IfStatement>();
+
+                    if(const auto value = ConstantFolding::valueOf(*ifStatement->condition)) {
+                        return terminates(*value != 0 ? ifStatement->thenStatements : ifStatement->elseStatements);
+                    }
+
+                    return ifStatement->hasElse && terminates(ifStatement->thenStatements) && 
+                        terminates(ifStatement->elseStatements);
+                }
+                case Ast::Statement::Kind::WHILE: {
+                    const auto value = ConstantFolding::valueOf(*statement.as<Ast::WhileStatement>()->condition);
+                    return value && *value == ConstantFolding::TRUE_VALUE;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        bool terminates(const Ast::List<const Ast::Statement*>& statements) {
+            return std::any_of(statements.begin(), statements.end(), [] (const Ast::Statement* statement) {
+                return terminates(*statement);
+            });
+        }
 
-        const array<Tokenizer::KeyWordType, 4> KEYWORD_CONSTANTS{
+        constexpr array<Tokenizer::KeyWordType, 4> KEYWORD_CONSTANTS{
             Tokenizer::KeyWordType::TRUE,
             Tokenizer::KeyWordType::FALSE,
             Tokenizer::KeyWordType::NULL_,
             Tokenizer::KeyWordType::THIS
         };
 
-        const array<Tokenizer::KeyWordType, 5> STATEMENT_KEYWORD_TYPES{
+        constexpr array<Tokenizer::KeyWordType, 5> STATEMENT_KEYWORD_TYPES{
+            Tokenizer::KeyWordType::LET,
+            Tokenizer::KeyWordType::IF,
+            Tokenizer::KeyWordType::WHILE,
+            Tokenizer::KeyWordType::DO,
+            Tokenizer::KeyWordType::RETURN
+        };
+
+        // the keywords at which parsing resumes after an error within a subroutine or declaration
+        constexpr array<Tokenizer::KeyWordType, 12> SYNCHRONIZING_KEYWORD_TYPES{
+            Tokenizer::KeyWordType::CLASS,
+            Tokenizer::KeyWordType::STATIC,
+            Tokenizer::KeyWordType::FIELD,
+            Tokenizer::KeyWordType::CONSTRUCTOR,
+            Tokenizer::KeyWordType::FUNCTION,
+            Tokenizer::KeyWordType::METHOD,
+            Tokenizer::KeyWordType::VAR,
             Tokenizer::KeyWordType::LET,
             Tokenizer::KeyWordType::IF,
             Tokenizer::KeyWordType::WHILE,
@@ -32,54 +155,238 @@ namespace JackCompiler {
             Tokenizer::KeyWordType::RETURN
         };
 
-        const unordered_map<Tokenizer::KeyWordType, string> KEYWORD_TYPE_TO_STRING{
+        // the keywords at which parsing resumes after an error that ends a subroutine
+        constexpr array<Tokenizer::KeyWordType, 4> SUBROUTINE_SYNCHRONIZING_KEYWORD_TYPES{
+            Tokenizer::KeyWordType::CLASS,
+            Tokenizer::KeyWordType::CONSTRUCTOR,
+            Tokenizer::KeyWordType::FUNCTION,
+            Tokenizer::KeyWordType::METHOD
+        };
+
+        constexpr size_t KEYWORD_TYPE_COUNT = static_cast<size_t>(Tokenizer::KeyWordType::THIS) + 1;
+
+        constexpr array<string_view, KEYWORD_TYPE_COUNT> makeKeywordTypeTable(
+            initializer_list<std::pair<Tokenizer::KeyWordType, string_view>> keywords) {
+            array<string_view, KEYWORD_TYPE_COUNT> table{};
+
+            for(const auto& [keywordType, keyword] : keywords) {
+                table[static_cast<size_t>(keywordType)] = keyword;
+            }
+
+            return table;
+        }
+
+        // indexed by Tokenizer::KeyWordType
+        constexpr auto KEYWORD_TYPE_TO_STRING = makeKeywordTypeTable({
             { Tokenizer::KeyWordType::CLASS,       "class" },
-            { Tokenizer::KeyWordType::CONSTRUCTOR, "constructor" },
-            { Tokenizer::KeyWordType::FUNCTION,    "function" },
             { Tokenizer::KeyWordType::METHOD,      "method" },
-            { Tokenizer::KeyWordType::FIELD,       "field" },
-            { Tokenizer::KeyWordType::STATIC,      "static" },
-            { Tokenizer::KeyWordType::VAR,         "var" },
+            { Tokenizer::KeyWordType::FUNCTION,    "function" },
+            { Tokenizer::KeyWordType::CONSTRUCTOR, "constructor" },
             { Tokenizer::KeyWordType::INT,         "int" },
-            { Tokenizer::KeyWordType::CHAR,        "char" },
             { Tokenizer::KeyWordType::BOOLEAN,     "boolean" },
+            { Tokenizer::KeyWordType::CHAR,        "char" },
             { Tokenizer::KeyWordType::VOID,        "void" },
-            { Tokenizer::KeyWordType::TRUE,        "true" },
-            { Tokenizer::KeyWordType::FALSE,       "false" },
-            { Tokenizer::KeyWordType::NULL_,       "null" },
-            { Tokenizer::KeyWordType::THIS,        "this" },
+            { Tokenizer::KeyWordType::VAR,         "var" },
+            { Tokenizer::KeyWordType::STATIC,      "static" },
+            { Tokenizer::KeyWordType::FIELD,       "field" },
             { Tokenizer::KeyWordType::LET,         "let" },
             { Tokenizer::KeyWordType::DO,          "do" },
             { Tokenizer::KeyWordType::IF,          "if" },
             { Tokenizer::KeyWordType::ELSE,        "else" },
             { Tokenizer::KeyWordType::WHILE,       "while" },
-            { Tokenizer::KeyWordType::RETURN,      "return" }
+            { Tokenizer::KeyWordType::RETURN,      "return" },
+            { Tokenizer::KeyWordType::TRUE,        "true" },
+            { Tokenizer::KeyWordType::FALSE,       "false" },
+            { Tokenizer::KeyWordType::NULL_,       "null" },
+            { Tokenizer::KeyWordType::THIS,        "this" }
+        });
+
+        constexpr bool keywordTableIsComplete(const array<string_view, KEYWORD_TYPE_COUNT>& table) {
+            for(size_t i = 0; i < table.size(); ++i) {
+                if(table[i].empty()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static_assert(keywordTableIsComplete(KEYWORD_TYPE_TO_STRING), "KEYWORD_TYPE_TO_STRING must contain a keyword for every Tokenizer::KeyWordType.");
+
+        // indexed by SymbolTable::SymbolKind (NONE has no segment)
+        constexpr array<VMWriter::Segment, 4> SYMBOL_KIND_TO_SEGMENT{
+            VMWriter::Segment::STATIC, VMWriter::Segment::THIS, VMWriter::Segment::ARG, VMWriter::Segment::LOCAL
         };
 
-        const unordered_map <SymbolTable::SymbolKind, VMWriter::Segment> SYMBOL_KIND_TO_SEGMENT{
-            { SymbolTable::SymbolKind::ARG,    VMWriter::Segment::ARG },
-            { SymbolTable::SymbolKind::VAR,    VMWriter::Segment::LOCAL },
-            { SymbolTable::SymbolKind::FIELD,  VMWriter::Segment::THIS },
-            { SymbolTable::SymbolKind::STATIC, VMWriter::Segment::STATIC }
+        constexpr size_t SYMBOL_TABLE_SIZE = 128;
+
+        struct SymbolCommand {
+            bool mapped;
+            VMWriter::Command command;
         };
 
-        const unordered_map <char, VMWriter::Command> OP_SYMBOL_TO_COMMAND{
+        using SymbolCommandTable = array<SymbolCommand, SYMBOL_TABLE_SIZE>;
+
+        constexpr SymbolCommandTable makeSymbolCommandTable(initializer_list<std::pair<char, VMWriter::Command>> symbolCommands) {
+            SymbolCommandTable table{};
+
+            for(const auto& [symbol, command] : symbolCommands) {
+                table[static_cast<unsigned char>(symbol)] = {true, command};
+            }
+
+            return table;
+        }
+
+        // indexed by symbol, only maps the symbols of binary operations except '*' and '/'
+        constexpr auto OP_SYMBOL_TO_COMMAND = makeSymbolCommandTable({
             { '+', VMWriter::Command::ADD },
             { '-', VMWriter::Command::SUB },
             { '&', VMWriter::Command::AND },
             { '|', VMWriter::Command::OR },
             { '<', VMWriter::Command::LT },
             { '>', VMWriter::Command::GT },
-            { '=', VMWriter::Command::EQ },
-        };
+            { '=', VMWriter::Command::EQ }
+        });
 
-        const unordered_map<char, VMWriter::Command> UNARY_OP_SYMBOL_TO_COMMAND{
+        // indexed by symbol, only maps the symbols of unary operations
+        constexpr auto UNARY_OP_SYMBOL_TO_COMMAND = makeSymbolCommandTable({
             { '-', VMWriter::Command::NEG },
             { '~', VMWriter::Command::NOT }
-        };
+        });
+
+        constexpr string_view keywordTypeToString(Tokenizer::KeyWordType keywordType) {
+            return KEYWORD_TYPE_TO_STRING[static_cast<size_t>(keywordType)];
+        }
+
+        VMWriter::Segment symbolKindToSegment(SymbolTable::SymbolKind kind) {
+            return SYMBOL_KIND_TO_SEGMENT.at(static_cast<size_t>(kind));
+        }
+
+        /**
+         * \brief Gets the command of an operation's symbol, a symbol without a command is an error of the compiler.
+         */
+        constexpr VMWriter::Command symbolToCommand(const SymbolCommandTable& table, char symbol) {
+            const auto index = static_cast<unsigned char>(symbol);
+
+            if(index >= SYMBOL_TABLE_SIZE || !table[index].mapped) {
+                throw runtime_error{"No VM command is defined for the symbol '" + string(1, symbol) + "'."};
+            }
+
+            return table[index].command;
+        }
+    }
+
+    void CompilationEngine::reset(string_view source, std::ostream& outputStream, const CompilationOptions& options) {
+        options_ = options;
+        statistics_.clear();
+        symbolTable_.reset();
+        vmWriter_.reset(outputStream, options.peephole ? &statistics_ : nullptr);
+        className_ = {};
+        currentSubroutineName_ = {};
+        currentSubroutineReturnType_ = {};
+        currentSubroutineType_ = {};
+        errors_.clear();
+        recoveryStopped_ = false;
+        currentIfLabelIndex_ = 0;
+        currentWhileLabelIndex_ = 0;
+
+        buildAst_ = false;
+        arena_.reset();
+        subroutineStack_.clear();
+        statementStack_.clear();
+        expressionStack_.clear();
+        stringPool_.reset();
+
+        currentClass_ = nullptr;
+        currentSubroutineLocalCount_ = 0;
+        inliner_ = nullptr;
+        inlinedFrame_.reset();
+        thatArray_.reset();
+        valueNumbering_ = nullptr;
+
+        // lexing the first token may fail, so the tokenizer is reset last
+        tokenizer_.reset(source);
     }
 
     void CompilationEngine::compileClass() {
+        // optimizations of expressions and statements require the abstract syntax tree
+        if(options_.buildAst || options_.foldConstants || options_.reduceStrength || options_.poolStrings || 
+            options_.eliminateDeadCode || options_.inlineThreshold > 0 || options_.compactControlFlow || 
+            options_.optimizeArrayAccess || options_.eliminateCommonSubexpressions) {
+            const auto& astClass = parseClass();
+
+            if(options_.inlineThreshold > 0) {
+                // without other classes only the subroutines of this class can be inlined
+                const Inliner inliner{{&astClass}, options_.inlineThreshold};
+                lowerClass(astClass, &inliner);
+            }
+            else {
+                lowerClass(astClass);
+            }
+        }
+        else {
+            processClass();
+            vmWriter_.flush();
+        }
+    }
+
+    const Ast::Class& CompilationEngine::parseClass() {
+        buildAst_ = true;
+        processClass();
+        buildAst_ = false;
+
+        return *arena_.create<Ast::Class>(className_, symbolTable_.varCount(SymbolTable::SymbolKind::FIELD),
+            symbolTable_.varCount(SymbolTable::SymbolKind::STATIC), moveToArena(subroutineStack_, 0));
+    }
+
+    void CompilationEngine::lowerClass(const Ast::Class& astClass, const Inliner* inliner, const CallGraph* callGraph) {
+        currentClass_ = &astClass;
+        inliner_ = inliner;
+
+        if(options_.poolStrings) {
+            stringPool_.emplace(astClass);
+        }
+
+        for(const auto* subroutine : astClass.subroutines) {
+            if(callGraph != nullptr && !callGraph->isReachable(*subroutine)) {
+                // the subroutine is compiled without output to report the number of removed instructions
+                const auto suppressedInstructionCount = vmWriter_.suppressedInstructionCount();
+
+                vmWriter_.setSuppressed(true);
+                compileSubroutine(astClass, *subroutine);
+                vmWriter_.setSuppressed(false);
+
+                statistics_.add("unreachable subroutine", vmWriter_.suppressedInstructionCount() - suppressedInstructionCount);
+            }
+            else {
+                compileSubroutine(astClass, *subroutine);
+            }
+        }
+
+        if(stringPool_ && !stringPool_->strings().empty()) {
+            writeStringPoolInitializer(astClass.name);
+        }
+
+        stringPool_.reset();
+        vmWriter_.flush();
+    }
+
+    void CompilationEngine::processClass() {
+        try {
+            processClassBody();
+        }
+        catch(const CompilationError& error) {
+            // errors outside of declarations and statements cannot be recovered from
+            recordError(error);
+            throw;
+        }
+
+        if(!errors_.empty()) {
+            throw errors_.front();
+        }
+    }
+
+    void CompilationEngine::processClassBody() {
         tokenizer_.advance();
 
         parseKeyword(Tokenizer::KeyWordType::CLASS);
@@ -90,17 +397,100 @@ namespace JackCompiler {
         tokenizer_.advance();
 
         while(classVarDecEncountered()) {
-            compileClassVarDec();
+            try {
+                compileClassVarDec();
+            }
+            catch(const CompilationError& error) {
+                if(!recordError(error)) {
+                    throw;
+                }
+
+                synchronize(true);
+            }
         }
 
         while(subroutineDecEncountered()) {
-            compileSubroutineDec();
+            const auto statementCount = statementStack_.size();
+            const auto expressionCount = expressionStack_.size();
+
+            try {
+                compileSubroutineDec();
+            }
+            catch(const CompilationError& error) {
+                if(!recordError(error)) {
+                    throw;
+                }
+
+                statementStack_.resize(statementCount);
+                expressionStack_.resize(expressionCount);
+                synchronize(false);
+            }
         }
 
         parseSymbol('}');
 
         if(tokenizer_.hasMoreTokens()) {
-            throw runtime_error{"Illegal occurence of tokens after the end of the class definition."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Illegal occurence of tokens after the end of the class definition."};
+        }
+    }
+
+    bool CompilationEngine::recordError(const CompilationError& error) {
+        // the error has already been recorded where it could not be recovered from
+        if(recoveryStopped_) {
+            return false;
+        }
+
+        errors_.push_back(error);
+
+        // the tokenizer cannot advance past an error in the input
+        recoveryStopped_ = tokenizer_.failed() || (options_.maxErrors > 0 && errors_.size() >= options_.maxErrors);
+
+        // the code of a class with errors would be invalid anyway
+        vmWriter_.setSuppressed(true);
+
+        return !recoveryStopped_;
+    }
+
+    void CompilationEngine::synchronize(bool withinBlock) {
+        // Tokens are skipped until a keyword that starts a subroutine is encountered, within a block also until the
+        // start of the next declaration or statement, the end of the current one (';') or the end of the block ('}').
+        // Nested blocks are skipped as a whole.
+        const auto* keywordsBegin = withinBlock ? SYNCHRONIZING_KEYWORD_TYPES.cbegin() : SUBROUTINE_SYNCHRONIZING_KEYWORD_TYPES.cbegin();
+        const auto* keywordsEnd = withinBlock ? SYNCHRONIZING_KEYWORD_TYPES.cend() : SUBROUTINE_SYNCHRONIZING_KEYWORD_TYPES.cend();
+        size_t depth{};
+
+        while(true) {
+            if(depth == 0) {
+                if(tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD && 
+                   std::find(keywordsBegin, keywordsEnd, tokenizer_.keyWord()) != keywordsEnd) {
+                    return;
+                }
+
+                if(withinBlock && tryParseSymbol('}')) {
+                    return;
+                }
+
+                if(withinBlock && tryParseSymbol(';')) {
+                    if(tokenizer_.hasMoreTokens()) {
+                        tokenizer_.advance();
+                    }
+
+                    return;
+                }
+            }
+
+            if(tryParseSymbol('{')) {
+                ++depth;
+            }
+            else if(tryParseSymbol('}') && depth > 0) {
+                --depth;
+            }
+
+            if(!tokenizer_.hasMoreTokens()) {
+                return;
+            }
+
+            tokenizer_.advance();
         }
     }
 
@@ -135,7 +525,7 @@ namespace JackCompiler {
             Tokenizer::KeyWordType::METHOD});
         currentSubroutineType_ = tokenizer_.keyWord();
         tokenizer_.advance();
-        parseSubroutineReturnType();
+        currentSubroutineReturnType_ = parseSubroutineReturnType();
 
         tokenizer_.advance();
         parseIdentifierAsSubroutineDefinition();
@@ -179,25 +569,31 @@ namespace JackCompiler {
         tokenizer_.advance();
 
         while(varDecEncountered()) {
-            compileVarDec();
-        }
+            try {
+                compileVarDec();
+            }
+            catch(const CompilationError& error) {
+                if(!recordError(error)) {
+                    throw;
+                }
 
-        vmWriter_.writeFunction(className_ + "." + currentSubroutineName_, 
-            symbolTable_.varCount(SymbolTable::SymbolKind::VAR));
+                synchronize(true);
+            }
+        }
 
-        if(currentSubroutineType_ == Tokenizer::KeyWordType::METHOD) {
-            vmWriter_.writePush(VMWriter::Segment::ARG, 0);
-            vmWriter_.writePop(VMWriter::Segment::POINTER, 0);
+        if(buildAst_) {
+            const auto statements = buildStatements();
 
+            subroutineStack_.push_back(arena_.create<Ast::Subroutine>(currentSubroutineType_, currentSubroutineName_,
+                currentSubroutineReturnType_, symbolTable_.varCount(SymbolTable::SymbolKind::ARG),
+                symbolTable_.varCount(SymbolTable::SymbolKind::VAR), statements));
         }
-        else if(currentSubroutineType_ == Tokenizer::KeyWordType::CONSTRUCTOR) {
-            vmWriter_.writePush(VMWriter::Segment::CONST, 
-                symbolTable_.varCount(SymbolTable::SymbolKind::FIELD));
-            vmWriter_.writeCall("Memory.alloc", 1);
-            vmWriter_.writePop(VMWriter::Segment::POINTER, 0);
-        }
+        else {
+            writeSubroutineEntry(className_, currentSubroutineName_, currentSubroutineType_,
+                symbolTable_.varCount(SymbolTable::SymbolKind::VAR), symbolTable_.varCount(SymbolTable::SymbolKind::FIELD));
 
-        compileStatements();
+            compileStatements();
+        }
 
         parseSymbol('}');
         tokenizer_.advance();
@@ -223,25 +619,33 @@ namespace JackCompiler {
 
     void CompilationEngine::compileStatements() {
         while(statementEncountered()) {
-            switch(tokenizer_.keyWord()) {
-                case Tokenizer::KeyWordType::LET:
-                    compileLet();
-                    break;
-                case Tokenizer::KeyWordType::IF:
-                    compileIf();
-                    break;
-                case Tokenizer::KeyWordType::WHILE:
-                    compileWhile();
-                    break;
-                case Tokenizer::KeyWordType::DO:
-                    compileDo();
-                    break;
-                case Tokenizer::KeyWordType::RETURN:
-                    compileReturn();
-                    break;
-                default:
-                    throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + 
-                        ": Invalid statement."};
+            try {
+                switch(tokenizer_.keyWord()) {
+                    case Tokenizer::KeyWordType::LET:
+                        compileLet();
+                        break;
+                    case Tokenizer::KeyWordType::IF:
+                        compileIf();
+                        break;
+                    case Tokenizer::KeyWordType::WHILE:
+                        compileWhile();
+                        break;
+                    case Tokenizer::KeyWordType::DO:
+                        compileDo();
+                        break;
+                    case Tokenizer::KeyWordType::RETURN:
+                        compileReturn();
+                        break;
+                    default:
+                        throw CompilationError{tokenizer_.getCurrentLine(), "Invalid statement."};
+                }
+            }
+            catch(const CompilationError& error) {
+                if(!recordError(error)) {
+                    throw;
+                }
+
+                synchronize(true);
             }
         }
     }
@@ -251,7 +655,13 @@ namespace JackCompiler {
         tokenizer_.advance();
         parseIdentifier();
         const auto identifier = tokenizer_.identifier();
-        const auto segment = SYMBOL_KIND_TO_SEGMENT.at(symbolTable_.kindOf(identifier));
+
+        if(symbolTable_.kindOf(identifier) == SymbolTable::SymbolKind::NONE) {
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Undefined variable '" + string{identifier} + "'."};
+        }
+
+        const auto segment = symbolKindToSegment(symbolTable_.kindOf(identifier));
         const auto index = symbolTable_.indexOf(identifier);
 
         tokenizer_.advance();
@@ -402,16 +812,7 @@ namespace JackCompiler {
 
             compileTerm();
 
-            switch(opSymbol) {
-                case '*':
-                    vmWriter_.writeCall("Math.multiply", 2);
-                    break;
-                case '/':
-                    vmWriter_.writeCall("Math.divide", 2);
-                    break;
-                default:
-                    vmWriter_.writeArithmetic(OP_SYMBOL_TO_COMMAND.at(opSymbol));
-            }
+            writeOp(opSymbol);
         }
     }
 
@@ -432,7 +833,7 @@ namespace JackCompiler {
 
             compileTerm();
 
-            vmWriter_.writeArithmetic(UNARY_OP_SYMBOL_TO_COMMAND.at(symbol));
+            vmWriter_.writeArithmetic(symbolToCommand(UNARY_OP_SYMBOL_TO_COMMAND, symbol));
         }
         else if(tryParseIntConst()) {
             // integer constant
@@ -442,73 +843,55 @@ namespace JackCompiler {
         }
         else if(tryParseStringConst()) {
             // string constant
-            const auto stringValue = tokenizer_.stringVal();
-
-            vmWriter_.writePush(VMWriter::Segment::CONST, stringValue.size());
-            vmWriter_.writeCall("String.new", 1);
-
-            for(auto c : stringValue) {
-                vmWriter_.writePush(VMWriter::Segment::CONST, c);
-                vmWriter_.writeCall("String.appendChar", 2);
-            }
+            writeStringConstant(tokenizer_.stringVal());
 
             tokenizer_.advance();
         }
         else if(tryParseKeyword({Tokenizer::KeyWordType::TRUE, Tokenizer::KeyWordType::FALSE, 
             Tokenizer::KeyWordType::NULL_, Tokenizer::KeyWordType::THIS})) {
             // keyWord OR integerConstant OR stringConstant
-            const auto keyword = tokenizer_.keyWord();
-
-            if(keyword == Tokenizer::KeyWordType::TRUE) {
-                vmWriter_.writePush(VMWriter::Segment::CONST, 0);
-                vmWriter_.writeArithmetic(VMWriter::Command::NOT);
-            }
-            else if(keyword == Tokenizer::KeyWordType::FALSE || keyword == Tokenizer::KeyWordType::NULL_) {
-                vmWriter_.writePush(VMWriter::Segment::CONST, 0);
-            }
-            else {
-                vmWriter_.writePush(VMWriter::Segment::POINTER, 0);
-            }
+            writeKeywordConstant(tokenizer_.keyWord());
 
             tokenizer_.advance();
         }
         else if(tryParseIdentifier()) {
+            // varName OR varName[expression] OR subroutineCall, told apart by the symbol following the identifier
             const auto identifier = tokenizer_.identifier();
+            const auto followingSymbol = tokenizer_.peekSymbol();
             tokenizer_.advance();
 
-            if(const auto kind = symbolTable_.kindOf(identifier); kind != SymbolTable::SymbolKind::NONE) {
-                // varName OR varName[expression] OR varName.methodName(expressionList)
-                if(tryParseSymbol('[')) {
-                    // [expression]
-                    tokenizer_.advance();
-                    processExpressionArrayElementAccess(identifier);
-                }
-                else if(tryParseSymbol('.')) {
-                    // .methodName(expressionList)
-                    tokenizer_.advance();
-                    processForeignMethodCall(identifier);
-                }
-                else {
-                    // >empty<
-                    vmWriter_.writePush(SYMBOL_KIND_TO_SEGMENT.at(kind), symbolTable_.indexOf(identifier));
-                }
+            if(followingSymbol == '[') {
+                // [expression]
+                tokenizer_.advance();
+                processExpressionArrayElementAccess(identifier);
             }
-            else {
-                // methodName(expressionList) OR className.functionName(expressionList)
-                if(tryParseSymbol('.')) {
-                    // .functionName(expressionList)
-                    tokenizer_.advance();
+            else if(followingSymbol == '(') {
+                // methodName(expressionList)
+                processOwnMethodCall(identifier);
+            }
+            else if(followingSymbol == '.') {
+                // .methodName(expressionList) OR .functionName(expressionList)
+                tokenizer_.advance();
+
+                if(symbolTable_.kindOf(identifier) == SymbolTable::SymbolKind::NONE) {
                     processFunctionCall(identifier);
                 }
                 else {
-                    // methodName(expressionList)
-                    processOwnMethodCall(identifier);
+                    processForeignMethodCall(identifier);
                 }
             }
+            else if(const auto kind = symbolTable_.kindOf(identifier); kind != SymbolTable::SymbolKind::NONE) {
+                // >empty<
+                vmWriter_.writePush(symbolKindToSegment(kind), symbolTable_.indexOf(identifier));
+            }
+            else {
+                throw CompilationError{tokenizer_.getCurrentLine(),
+                    "Undefined variable '" + string{identifier} + "'."};
+            }
         }
         else {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + 
-                ": Invalid term-construct."};
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid term-construct."};
         }
     }
 
@@ -531,8 +914,8 @@ namespace JackCompiler {
 
     void CompilationEngine::processSubroutineCall() {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) +
-                ": Invalid subroutine-call."};
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid subroutine-call."};
         }
 
         const auto identifier = tokenizer_.identifier();
@@ -561,20 +944,20 @@ namespace JackCompiler {
                 processForeignMethodCall(identifier);
             }
             else {
-                throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) +
-                    ": Invalid subroutine-call."};
+                throw CompilationError{tokenizer_.getCurrentLine(),
+                    "Invalid subroutine-call."};
             }
         }
     }
 
-    bool CompilationEngine::tryProcessAssignmentArrayElementAccess(const std::string& arrayVarName) {
+    bool CompilationEngine::tryProcessAssignmentArrayElementAccess(string_view arrayVarName) {
         if(tryParseSymbol('[')) {
             tokenizer_.advance();
             compileExpression();
 
             parseSymbol(']');
 
-            vmWriter_.writePush(SYMBOL_KIND_TO_SEGMENT.at(symbolTable_.kindOf(arrayVarName)), 
+            vmWriter_.writePush(symbolKindToSegment(symbolTable_.kindOf(arrayVarName)), 
                 symbolTable_.indexOf(arrayVarName));
             vmWriter_.writeArithmetic(VMWriter::Command::ADD);
             tokenizer_.advance();
@@ -584,12 +967,12 @@ namespace JackCompiler {
         return false;
     }
 
-    void CompilationEngine::processExpressionArrayElementAccess(const std::string& arrayVarName) {
+    void CompilationEngine::processExpressionArrayElementAccess(string_view arrayVarName) {
         compileExpression();
 
         parseSymbol(']');
 
-        vmWriter_.writePush(SYMBOL_KIND_TO_SEGMENT.at(symbolTable_.kindOf(arrayVarName)), 
+        vmWriter_.writePush(symbolKindToSegment(symbolTable_.kindOf(arrayVarName)), 
             symbolTable_.indexOf(arrayVarName));
         vmWriter_.writeArithmetic(VMWriter::Command::ADD);
         vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
@@ -599,12 +982,12 @@ namespace JackCompiler {
     }
 
 
-    void CompilationEngine::processForeignMethodCall(const std::string& prefixName) {
+    void CompilationEngine::processForeignMethodCall(string_view prefixName) {
         parseIdentifierAsSubroutineName();
         const auto calledSubroutineName = tokenizer_.identifier();
         tokenizer_.advance();
 
-        vmWriter_.writePush(SYMBOL_KIND_TO_SEGMENT.at(symbolTable_.kindOf(prefixName)), 
+        vmWriter_.writePush(symbolKindToSegment(symbolTable_.kindOf(prefixName)), 
             symbolTable_.indexOf(prefixName));
 
         parseSymbol('(');
@@ -614,12 +997,12 @@ namespace JackCompiler {
 
         parseSymbol(')');
 
-        vmWriter_.writeCall(symbolTable_.typeOf(prefixName) + "." + calledSubroutineName, nrArgs + 1);
+        vmWriter_.writeCall(symbolTable_.typeOf(prefixName), calledSubroutineName, nrArgs + 1);
 
         tokenizer_.advance();
     }
 
-    void CompilationEngine::processFunctionCall(const std::string& prefixName) {
+    void CompilationEngine::processFunctionCall(string_view prefixName) {
         parseIdentifierAsSubroutineName();
         const auto functionName = tokenizer_.identifier();
         tokenizer_.advance();
@@ -630,12 +1013,12 @@ namespace JackCompiler {
 
         parseSymbol(')');
 
-        vmWriter_.writeCall(prefixName + "." + functionName, nrArgs);
+        vmWriter_.writeCall(prefixName, functionName, nrArgs);
         tokenizer_.advance();
     }
 
 
-    void CompilationEngine::processOwnMethodCall(const string& functionName) {
+    void CompilationEngine::processOwnMethodCall(string_view functionName) {
         vmWriter_.writePush(VMWriter::Segment::POINTER, 0);
 
         parseSymbol('(');
@@ -645,70 +1028,1143 @@ namespace JackCompiler {
 
         parseSymbol(')');
 
-        vmWriter_.writeCall(className_ + "." + functionName, nrArgs + 1);
+        vmWriter_.writeCall(className_, functionName, nrArgs + 1);
 
         tokenizer_.advance();
     }
 
-    bool CompilationEngine::classVarDecEncountered() const {
-        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
-            (tokenizer_.keyWord() == Tokenizer::KeyWordType::STATIC ||
-                tokenizer_.keyWord() == Tokenizer::KeyWordType::FIELD);
-    }
+    void CompilationEngine::compileSubroutine(const Ast::Class& astClass, const Ast::Subroutine& subroutine) {
+        currentIfLabelIndex_ = 0;
+        currentWhileLabelIndex_ = 0;
 
+        // the arguments and locals of inlined subroutines are stored in additional local variables
+        currentSubroutineLocalCount_ = subroutine.nLocals;
+        writeSubroutineEntry(astClass.name, subroutine.name, subroutine.type, subroutine.nLocals + inlinedLocalCount(subroutine), 
+            astClass.nFields);
 
-    bool CompilationEngine::subroutineDecEncountered() const {
-        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
-            (tokenizer_.keyWord() == Tokenizer::KeyWordType::CONSTRUCTOR ||
-                tokenizer_.keyWord() == Tokenizer::KeyWordType::FUNCTION ||
-                tokenizer_.keyWord() == Tokenizer::KeyWordType::METHOD);
-    }
+        if(stringPool_ && stringPool_->isUsedBy(subroutine)) {
+            writeStringPoolGuard(astClass.name);
+        }
 
-    bool CompilationEngine::typeEncountered() const {
-        return tokenizer_.tokenType() == Tokenizer::TokenType::IDENTIFIER ||
-            (tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
-            (tokenizer_.keyWord() == Tokenizer::KeyWordType::INT ||
-                tokenizer_.keyWord() == Tokenizer::KeyWordType::CHAR ||
-                tokenizer_.keyWord() == Tokenizer::KeyWordType::BOOLEAN));
+        compileStatements(subroutine.statements);
     }
 
-    bool CompilationEngine::varDecEncountered() const {
-        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
-            tokenizer_.keyWord() == Tokenizer::KeyWordType::VAR;
-    }
+    void CompilationEngine::compileStatements(const Ast::List<const Ast::Statement*>& statements) {
+        // the statements may be nested in an if-statement whose condition ends a basic block
+        const auto* enclosingValueNumbering = valueNumbering_;
+        optional<ValueNumbering> valueNumbering;
+        size_t basicBlockEnd{};
 
-    bool CompilationEngine::statementEncountered() const {
-        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
-            std::find(STATEMENT_KEYWORD_TYPES.cbegin(), STATEMENT_KEYWORD_TYPES.cend(),
-                tokenizer_.keyWord()) != STATEMENT_KEYWORD_TYPES.cend();
-    }
+        for(size_t i = 0; i < statements.size(); ++i) {
+            const auto* statement = statements[i];
 
-    bool CompilationEngine::termEncountered() const {
-        switch(tokenizer_.tokenType()) {
-            case Tokenizer::TokenType::INT_CONST:
-                return true;
-            case Tokenizer::TokenType::STRING_CONST:
-                return true;
-            case Tokenizer::TokenType::KEYWORD:
-                return std::find(KEYWORD_CONSTANTS.cbegin(), KEYWORD_CONSTANTS.cend(),
-                    tokenizer_.keyWord()) != KEYWORD_CONSTANTS.cend();
-            case Tokenizer::TokenType::SYMBOL:
-                return tokenizer_.symbol() == '(' || std::find(UNARY_OPS.cbegin(), UNARY_OPS.cend(),
-                    tokenizer_.symbol()) != UNARY_OPS.cend();
-            case Tokenizer::TokenType::IDENTIFIER:
-                return true;
-        }
+            // statements may be the target of jumps, so the content of pointer 1 is unknown
+            thatArray_.reset();
 
-        return false;
-    }
+            if(i >= basicBlockEnd) {
+                valueNumbering.reset();
+                basicBlockEnd = findBasicBlockEnd(statements, i);
 
-    void CompilationEngine::parseSymbol(char expectedSymbol) const {
-        if(tokenizer_.tokenType() != Tokenizer::TokenType::SYMBOL) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected a symbol-token."};
-        }
+                // values are neither reused within inlined subroutines nor when compiling unreachable code
+                if(options_.eliminateCommonSubexpressions && !inlinedFrame_ && !vmWriter_.suppressed() && 
+                   statement->kind != Ast::Statement::Kind::WHILE) {
+                    const auto* ifStatement = statements[basicBlockEnd - 1]->as<Ast::IfStatement>();
+                    const Ast::List<const Ast::Statement*> basicBlock{statements.begin() + i, basicBlockEnd - i - (ifStatement != nullptr ? 1 : 0)};
+                    valueNumbering.emplace(basicBlock, ifStatement != nullptr ? ifStatement->condition : nullptr);
+                }
 
-        if(const auto symbol = tokenizer_.symbol();  symbol != expectedSymbol) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected symbol \"" +
+                valueNumbering_ = valueNumbering ? &*valueNumbering : nullptr;
+            }
+
+            switch(statement->kind) {
+                case Ast::Statement::Kind::LET:
+                    compileLet(*statement->as<Ast::LetStatement>());
+                    break;
+                case Ast::Statement::Kind::IF:
+                    compileIf(*statement->as<Ast::IfStatement>());
+                    break;
+                case Ast::Statement::Kind::WHILE:
+                    compileWhile(*statement->as<Ast::WhileStatement>());
+                    break;
+                case Ast::Statement::Kind::DO:
+                    compileDo(*statement->as<Ast::DoStatement>());
+                    break;
+                case Ast::Statement::Kind::RETURN:
+                    compileReturn(*statement->as<Ast::ReturnStatement>());
+                    break;
+            }
+
+            if(options_.eliminateDeadCode && i + 1 < statements.size() && terminates(*statement)) {
+                const Ast::List<const Ast::Statement*> unreachableStatements{statements.begin() + i + 1, statements.size() - i - 1};
+                statistics_.add("unreachable statement", skipStatements(unreachableStatements));
+                break;
+            }
+        }
+
+        thatArray_.reset();
+        valueNumbering_ = enclosingValueNumbering;
+    }
+
+    size_t CompilationEngine::skipStatements(const Ast::List<const Ast::Statement*>& statements) {
+        // The skipped statements are compiled without elimination, so that the number of suppressed
+        // instructions equals the number of instructions that would have been generated. This also
+        // keeps the labels of the following statements unchanged.
+        const bool suppressed = vmWriter_.suppressed();
+        const bool eliminateDeadCode = options_.eliminateDeadCode;
+        const auto suppressedInstructionCount = vmWriter_.suppressedInstructionCount();
+
+        vmWriter_.setSuppressed(true);
+        options_.eliminateDeadCode = false;
+
+        compileStatements(statements);
+
+        vmWriter_.setSuppressed(suppressed);
+        options_.eliminateDeadCode = eliminateDeadCode;
+
+        return vmWriter_.suppressedInstructionCount() - suppressedInstructionCount;
+    }
+
+    void CompilationEngine::compileLet(const Ast::LetStatement& statement) {
+        if(options_.optimizeArrayAccess && statement.index != nullptr && compileArrayElementAssignment(statement)) {
+            return;
+        }
+
+        const auto [segment, index] = locate(*statement.target);
+
+        if(statement.index != nullptr) {
+            compileExpression(*statement.index);
+            vmWriter_.writePush(segment, index);
+            vmWriter_.writeArithmetic(VMWriter::Command::ADD);
+
+            compileExpression(*statement.value);
+
+            vmWriter_.writePop(VMWriter::Segment::TEMP, 0);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+            vmWriter_.writePush(VMWriter::Segment::TEMP, 0);
+            vmWriter_.writePop(VMWriter::Segment::THAT, 0);
+        }
+        else {
+            compileExpression(*statement.value);
+            vmWriter_.writePop(segment, index);
+        }
+    }
+
+    bool CompilationEngine::compileArrayElementAssignment(const Ast::LetStatement& statement) {
+        const auto array = locate(*statement.target);
+        const auto constantIndex = ConstantFolding::valueOf(*statement.index);
+
+        if(constantIndex && *constantIndex >= 0) {
+            // the value may access further elements of the same array through pointer 1
+            if(setsThat(*statement.value, array)) {
+                return false;
+            }
+
+            vmWriter_.writePush(array.first, array.second);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+            thatArray_ = array;
+
+            compileExpression(*statement.value);
+
+            vmWriter_.writePop(VMWriter::Segment::THAT, *constantIndex);
+
+            // push constant, add, pop temp 0, push temp 0
+            statistics_.add("array access", 4);
+        }
+        else {
+            if(setsThat(*statement.value, std::nullopt)) {
+                return false;
+            }
+
+            compileExpression(*statement.index);
+            vmWriter_.writePush(array.first, array.second);
+            vmWriter_.writeArithmetic(VMWriter::Command::ADD);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+            thatArray_.reset();
+
+            compileExpression(*statement.value);
+
+            vmWriter_.writePop(VMWriter::Segment::THAT, 0);
+
+            // pop temp 0, push temp 0
+            statistics_.add("array access", 2);
+        }
+
+        return true;
+    }
+
+    void CompilationEngine::compileIf(const Ast::IfStatement& statement) {
+        if(options_.eliminateDeadCode) {
+            if(const auto value = ConstantFolding::valueOf(*statement.condition)) {
+                // the labels of the following statements remain unchanged
+                ++currentIfLabelIndex_;
+
+                // the condition, if-goto, goto and the labels (and the goto to the end of the else-branch)
+                size_t removedInstructions = static_cast<size_t>(ConstantFolding::instructionCount(*statement.condition)) + 
+                    (statement.hasElse ? 6 : 4);
+
+                if(*value != 0) {
+                    compileStatements(statement.thenStatements);
+                    removedInstructions += skipStatements(statement.elseStatements);
+                }
+                else {
+                    removedInstructions += skipStatements(statement.thenStatements);
+                    compileStatements(statement.elseStatements);
+                }
+
+                statistics_.add("constant condition", removedInstructions);
+                return;
+            }
+        }
+
+        if(options_.compactControlFlow && (statement.hasElse || isBoolean(*statement.condition))) {
+            compileCompactIf(statement);
+            return;
+        }
+
+        compileExpression(*statement.condition);
+
+        const auto ifLabelIndex = currentIfLabelIndex_++;
+        const auto ifTrueLabel = "IF_TRUE" + to_string(ifLabelIndex);
+        const auto ifFalseLabel = "IF_FALSE" + to_string(ifLabelIndex);
+
+        vmWriter_.writeIf(ifTrueLabel);
+        vmWriter_.writeGoto(ifFalseLabel);
+        vmWriter_.writeLabel(ifTrueLabel);
+
+        compileStatements(statement.thenStatements);
+
+        if(statement.hasElse) {
+            const auto ifEndLabel = "IF_END" + to_string(ifLabelIndex);
+            vmWriter_.writeGoto(ifEndLabel);
+            vmWriter_.writeLabel(ifFalseLabel);
+
+            compileStatements(statement.elseStatements);
+
+            vmWriter_.writeLabel(ifEndLabel);
+        }
+        else {
+            vmWriter_.writeLabel(ifFalseLabel);
+        }
+    }
+
+    void CompilationEngine::compileCompactIf(const Ast::IfStatement& statement) {
+        const auto ifLabelIndex = currentIfLabelIndex_++;
+        const auto ifEndLabel = "IF_END" + to_string(ifLabelIndex);
+        const auto* condition = statement.condition;
+        const auto* negatedCondition = condition->as<Ast::UnaryOp>();
+
+        if(!statement.hasElse || (negatedCondition != nullptr && negatedCondition->op == '~' && isBoolean(*negatedCondition->operand))) {
+            // jump over the then-branch if the (boolean) condition is false
+            const auto ifFalseLabel = "IF_FALSE" + to_string(ifLabelIndex);
+            writeBranch(*condition, ifFalseLabel, false);
+
+            compileStatements(statement.thenStatements);
+
+            if(statement.hasElse) {
+                vmWriter_.writeGoto(ifEndLabel);
+                vmWriter_.writeLabel(ifFalseLabel);
+
+                compileStatements(statement.elseStatements);
+
+                vmWriter_.writeLabel(ifEndLabel);
+            }
+            else {
+                vmWriter_.writeLabel(ifFalseLabel);
+            }
+        }
+        else {
+            // the else-branch comes first, so that any condition can be used without negating it
+            const auto ifTrueLabel = "IF_TRUE" + to_string(ifLabelIndex);
+            writeBranch(*condition, ifTrueLabel, true);
+
+            compileStatements(statement.elseStatements);
+
+            vmWriter_.writeGoto(ifEndLabel);
+            vmWriter_.writeLabel(ifTrueLabel);
+
+            compileStatements(statement.thenStatements);
+
+            vmWriter_.writeLabel(ifEndLabel);
+        }
+    }
+
+    void CompilationEngine::compileCompactWhile(const Ast::WhileStatement& statement, size_t whileLabelIndex) {
+        // the condition is checked at the end of the loop, so that every iteration only needs one jump
+        const auto whileConditionLabel = "WHILE_EXP" + to_string(whileLabelIndex);
+        const auto whileBodyLabel = "WHILE_BODY" + to_string(whileLabelIndex);
+
+        vmWriter_.writeGoto(whileConditionLabel);
+        vmWriter_.writeLabel(whileBodyLabel);
+
+        compileStatements(statement.statements);
+
+        vmWriter_.writeLabel(whileConditionLabel);
+        thatArray_.reset();
+        writeBranch(*statement.condition, whileBodyLabel, true);
+    }
+
+    void CompilationEngine::writeBranch(const Ast::Expression& condition, string_view label, bool jumpIfTrue) {
+        // negations of boolean conditions are folded into the sense of the jump
+        if(const auto* unaryOp = condition.as<Ast::UnaryOp>()) {
+            if(unaryOp->op == '~' && isBoolean(*unaryOp->operand)) {
+                writeBranch(*unaryOp->operand, label, !jumpIfTrue);
+                return;
+            }
+        }
+
+        compileExpression(condition);
+
+        if(!jumpIfTrue) {
+            vmWriter_.writeArithmetic(VMWriter::Command::NOT);
+        }
+
+        vmWriter_.writeIf(label);
+    }
+
+    void CompilationEngine::compileWhile(const Ast::WhileStatement& statement) {
+        const auto whileLabelIndex = currentWhileLabelIndex_++;
+        const auto whileConditionLabel = "WHILE_EXP" + to_string(whileLabelIndex);
+        const auto whileEndLabel = "WHILE_END" + to_string(whileLabelIndex);
+
+        if(options_.eliminateDeadCode) {
+            if(const auto value = ConstantFolding::valueOf(*statement.condition)) {
+                // the condition, not, if-goto and the label at the end
+                size_t removedInstructions = static_cast<size_t>(ConstantFolding::instructionCount(*statement.condition)) + 3;
+
+                // the condition is negated, so only true continues the loop
+                if(*value == ConstantFolding::TRUE_VALUE) {
+                    // an infinite loop (which can only be left by returning)
+                    vmWriter_.writeLabel(whileConditionLabel);
+                    compileStatements(statement.statements);
+                    vmWriter_.writeGoto(whileConditionLabel);
+                }
+                else {
+                    // the label of the condition, the loop body and the goto to the condition
+                    removedInstructions += 2 + skipStatements(statement.statements);
+                }
+
+                statistics_.add("constant condition", removedInstructions);
+                return;
+            }
+        }
+
+        if(options_.compactControlFlow && isBoolean(*statement.condition)) {
+            compileCompactWhile(statement, whileLabelIndex);
+            return;
+        }
+
+        vmWriter_.writeLabel(whileConditionLabel);
+
+        compileExpression(*statement.condition);
+
+        vmWriter_.writeArithmetic(VMWriter::Command::NOT);
+        vmWriter_.writeIf(whileEndLabel);
+
+        compileStatements(statement.statements);
+
+        vmWriter_.writeGoto(whileConditionLabel);
+        vmWriter_.writeLabel(whileEndLabel);
+    }
+
+    void CompilationEngine::compileDo(const Ast::DoStatement& statement) {
+        compileSubroutineCall(*statement.call);
+
+        // the dummy value returned by the called subroutine is ignored
+        vmWriter_.writePop(VMWriter::Segment::TEMP, 0);
+    }
+
+    void CompilationEngine::compileReturn(const Ast::ReturnStatement& statement) {
+        if(statement.value != nullptr) {
+            compileExpression(*statement.value);
+        }
+        else {
+            vmWriter_.writePush(VMWriter::Segment::CONST, 0);
+        }
+
+        vmWriter_.writeReturn();
+    }
+
+    void CompilationEngine::compileExpression(const Ast::Expression& expression) {
+        const auto* reuse = valueNumbering_ != nullptr && !inlinedFrame_ ? valueNumbering_->find(expression) : nullptr;
+
+        if(reuse == nullptr) {
+            compileUncachedExpression(expression);
+        }
+        else if(reuse->load) {
+            vmWriter_.writePush(VMWriter::Segment::TEMP, reuse->tempIndex);
+            // storing the value adds instructions, so the loads are not removed instructions
+            statistics_.add("reused value", 1, OptimizationStatistics::Unit::OCCURRENCES);
+        }
+        else {
+            compileUncachedExpression(expression);
+            vmWriter_.writePop(VMWriter::Segment::TEMP, reuse->tempIndex);
+            vmWriter_.writePush(VMWriter::Segment::TEMP, reuse->tempIndex);
+        }
+    }
+
+    void CompilationEngine::compileUncachedExpression(const Ast::Expression& expression) {
+        switch(expression.kind) {
+            case Ast::Expression::Kind::INT_CONST:
+                writeIntConstant(expression.as<Ast::IntConstant>()->value);
+                break;
+            case Ast::Expression::Kind::STRING_CONST:
+                if(stringPool_) {
+                    vmWriter_.writePush(VMWriter::Segment::STATIC, stringPool_->staticIndex(expression.as<Ast::StringConstant>()->value));
+                }
+                else {
+                    writeStringConstant(expression.as<Ast::StringConstant>()->value);
+                }
+
+                break;
+            case Ast::Expression::Kind::KEYWORD_CONST:
+                if(inlinedFrame_ && inlinedFrame_->firstArgument > 0 && 
+                   expression.as<Ast::KeywordConstant>()->keyword == Tokenizer::KeyWordType::THIS) {
+                    vmWriter_.writePush(VMWriter::Segment::POINTER, 1);
+                }
+                else {
+                    writeKeywordConstant(expression.as<Ast::KeywordConstant>()->keyword);
+                }
+
+                break;
+            case Ast::Expression::Kind::VARIABLE: {
+                const auto [segment, index] = locate(*expression.as<Ast::Variable>());
+                vmWriter_.writePush(segment, index);
+                break;
+            }
+            case Ast::Expression::Kind::ARRAY_ELEMENT: {
+                const auto* arrayElement = expression.as<Ast::ArrayElement>();
+
+                if(options_.optimizeArrayAccess) {
+                    compileArrayElement(*arrayElement);
+                    break;
+                }
+
+                compileExpression(*arrayElement->index);
+
+                const auto [segment, index] = locate(*arrayElement->array);
+                vmWriter_.writePush(segment, index);
+                vmWriter_.writeArithmetic(VMWriter::Command::ADD);
+                vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+                vmWriter_.writePush(VMWriter::Segment::THAT, 0);
+                break;
+            }
+            case Ast::Expression::Kind::SUBROUTINE_CALL:
+                compileSubroutineCall(*expression.as<Ast::SubroutineCall>());
+                break;
+            case Ast::Expression::Kind::UNARY_OP: {
+                const auto* unaryOp = expression.as<Ast::UnaryOp>();
+
+                compileExpression(*unaryOp->operand);
+
+                vmWriter_.writeArithmetic(symbolToCommand(UNARY_OP_SYMBOL_TO_COMMAND, unaryOp->op));
+                break;
+            }
+            case Ast::Expression::Kind::BINARY_OP: {
+                const auto* binaryOp = expression.as<Ast::BinaryOp>();
+
+                if(options_.reduceStrength && compileReducedStrengthOp(*binaryOp)) {
+                    break;
+                }
+
+                compileExpression(*binaryOp->left);
+                compileExpression(*binaryOp->right);
+
+                writeOp(binaryOp->op);
+                break;
+            }
+        }
+    }
+
+    bool CompilationEngine::compileReducedStrengthOp(const Ast::BinaryOp& binaryOp) {
+        const auto leftValue = ConstantFolding::valueOf(*binaryOp.left);
+        const auto rightValue = ConstantFolding::valueOf(*binaryOp.right);
+        const Ast::Expression* operand{};
+        optional<vector<VMWriter::Instruction>> instructions;
+
+        if(binaryOp.op == '*' && rightValue) {
+            operand = binaryOp.left;
+            instructions = StrengthReduction::multiplication(*rightValue);
+        }
+        else if(binaryOp.op == '*' && leftValue) {
+            // the constant has no side-effects, so the operands can be swapped
+            operand = binaryOp.right;
+            instructions = StrengthReduction::multiplication(*leftValue);
+        }
+        else if(binaryOp.op == '/' && rightValue) {
+            operand = binaryOp.left;
+            instructions = StrengthReduction::division(*rightValue);
+        }
+
+        if(!instructions) {
+            return false;
+        }
+
+        compileExpression(*operand);
+
+        for(const auto& instruction : *instructions) {
+            vmWriter_.writeInstruction(instruction);
+        }
+
+        return true;
+    }
+
+    void CompilationEngine::compileArrayElement(const Ast::ArrayElement& arrayElement) {
+        const auto array = locate(*arrayElement.array);
+        const auto constantIndex = ConstantFolding::valueOf(*arrayElement.index);
+
+        if(!constantIndex || *constantIndex < 0) {
+            compileExpression(*arrayElement.index);
+            vmWriter_.writePush(array.first, array.second);
+            vmWriter_.writeArithmetic(VMWriter::Command::ADD);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+            vmWriter_.writePush(VMWriter::Segment::THAT, 0);
+            thatArray_.reset();
+            return;
+        }
+
+        if(thatArray_ == array) {
+            // push constant, push array, add, pop pointer 1
+            statistics_.add("array access", 4);
+        }
+        else {
+            vmWriter_.writePush(array.first, array.second);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+            thatArray_ = array;
+
+            // push constant, add
+            statistics_.add("array access", 2);
+        }
+
+        vmWriter_.writePush(VMWriter::Segment::THAT, *constantIndex);
+    }
+
+    bool CompilationEngine::setsThat(const Ast::Expression& expression, std::optional<pair<VMWriter::Segment, int>> array) const {
+        bool changesPointer{};
+        bool containsArrayElement{};
+        bool containsCall{};
+
+        Ast::forEachExpression(expression, [&] (const Ast::Expression& subexpression) {
+            if(const auto* arrayElement = subexpression.as<Ast::ArrayElement>()) {
+                // only elements of the given array with constant indices are accessed without changing pointer 1
+                const auto constantIndex = ConstantFolding::valueOf(*arrayElement->index);
+                changesPointer |= !array || locate(*arrayElement->array) != *array || !constantIndex || *constantIndex < 0;
+                containsArrayElement = true;
+            }
+            else if(const auto* call = subexpression.as<Ast::SubroutineCall>()) {
+                // called subroutines restore pointer 1, inlined ones do not, and calls may change the array variable
+                changesPointer |= inliner_ != nullptr && !inlinedFrame_ && inliner_->find(*call, currentClass_->name) != nullptr;
+                containsCall = true;
+            }
+        });
+
+        return changesPointer || (containsArrayElement && containsCall);
+    }
+
+    void CompilationEngine::compileSubroutineCall(const Ast::SubroutineCall& call) {
+        // inlined subroutines do not contain calls, so inlining is never nested
+        if(inliner_ != nullptr && !inlinedFrame_) {
+            if(const auto* callee = inliner_->find(call, currentClass_->name)) {
+                compileInlinedCall(call, *callee);
+                return;
+            }
+        }
+
+        if(call.receiver != nullptr) {
+            compileExpression(*call.receiver);
+        }
+
+        for(const auto* argument : call.arguments) {
+            compileExpression(*argument);
+        }
+
+        const auto nrArgs = static_cast<int>(call.arguments.size()) + (call.receiver != nullptr ? 1 : 0);
+        vmWriter_.writeCall(call.className, call.subroutineName, nrArgs);
+
+        // the called subroutine may change the array variable
+        thatArray_.reset();
+    }
+
+    void CompilationEngine::compileInlinedCall(const Ast::SubroutineCall& call, const Inliner::Candidate& callee) {
+        const auto& subroutine = *callee.subroutine;
+        const int firstArgument = call.receiver != nullptr ? 1 : 0;
+        const int nArgs = subroutine.nArgs - firstArgument;
+        const int localBase = currentSubroutineLocalCount_;
+
+        if(call.receiver != nullptr) {
+            compileExpression(*call.receiver);
+        }
+
+        for(const auto* argument : call.arguments) {
+            compileExpression(*argument);
+        }
+
+        for(int i = nArgs - 1; i >= 0; --i) {
+            vmWriter_.writePop(VMWriter::Segment::LOCAL, localBase + i);
+        }
+
+        if(call.receiver != nullptr) {
+            // the fields of the object are accessed through the THAT-segment
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 1);
+            thatArray_.reset();
+        }
+
+        // like a called subroutine, the inlined one starts with locals that are 0
+        for(int i = 0; i < subroutine.nLocals; ++i) {
+            vmWriter_.writePush(VMWriter::Segment::CONST, 0);
+            vmWriter_.writePop(VMWriter::Segment::LOCAL, localBase + nArgs + i);
+        }
+
+        inlinedFrame_ = InlinedFrame{localBase, firstArgument, nArgs};
+
+        // the last statement is the only return-statement, its value remains on the stack like a returned value
+        const auto& statements = subroutine.statements;
+        compileStatements({statements.begin(), statements.size() - 1});
+
+        if(const auto* value = statements[statements.size() - 1]->as<Ast::ReturnStatement>()->value) {
+            compileExpression(*value);
+        }
+        else {
+            vmWriter_.writePush(VMWriter::Segment::CONST, 0);
+        }
+
+        inlinedFrame_.reset();
+        statistics_.add("inlined call", 1);
+    }
+
+    int CompilationEngine::inlinedLocalCount(const Ast::Subroutine& subroutine) const {
+        int count{};
+
+        if(inliner_ != nullptr) {
+            Ast::forEachExpression(subroutine.statements, [this, &count] (const Ast::Expression& expression) {
+                if(const auto* call = expression.as<Ast::SubroutineCall>()) {
+                    if(const auto* callee = inliner_->find(*call, currentClass_->name)) {
+                        const int firstArgument = call->receiver != nullptr ? 1 : 0;
+                        count = std::max(count, callee->subroutine->nArgs - firstArgument + callee->subroutine->nLocals);
+                    }
+                }
+            });
+        }
+
+        return count;
+    }
+
+    pair<VMWriter::Segment, int> CompilationEngine::locate(const Ast::Variable& variable) const {
+        if(inlinedFrame_) {
+            switch(variable.segment) {
+                case VMWriter::Segment::ARG:
+                    return {VMWriter::Segment::LOCAL, inlinedFrame_->localBase + variable.index - inlinedFrame_->firstArgument};
+                case VMWriter::Segment::LOCAL:
+                    return {VMWriter::Segment::LOCAL, inlinedFrame_->localBase + inlinedFrame_->nArgs + variable.index};
+                case VMWriter::Segment::THIS:
+                    return {VMWriter::Segment::THAT, variable.index};
+                default:
+                    break;
+            }
+        }
+
+        return {variable.segment, variable.index};
+    }
+
+    Ast::List<const Ast::Statement*> CompilationEngine::buildStatements() {
+        const auto first = statementStack_.size();
+
+        while(statementEncountered()) {
+            const auto expressionCount = expressionStack_.size();
+            const auto statementCount = statementStack_.size();
+
+            try {
+                switch(tokenizer_.keyWord()) {
+                    case Tokenizer::KeyWordType::LET:
+                        statementStack_.push_back(buildLet());
+                        break;
+                    case Tokenizer::KeyWordType::IF:
+                        statementStack_.push_back(buildIf());
+                        break;
+                    case Tokenizer::KeyWordType::WHILE:
+                        statementStack_.push_back(buildWhile());
+                        break;
+                    case Tokenizer::KeyWordType::DO:
+                        statementStack_.push_back(buildDo());
+                        break;
+                    case Tokenizer::KeyWordType::RETURN:
+                        statementStack_.push_back(buildReturn());
+                        break;
+                    default:
+                        throw CompilationError{tokenizer_.getCurrentLine(), "Invalid statement."};
+                }
+            }
+            catch(const CompilationError& error) {
+                if(!recordError(error)) {
+                    throw;
+                }
+
+                // the statement is dropped together with the partially built statements and expressions it contains
+                statementStack_.resize(statementCount);
+                expressionStack_.resize(expressionCount);
+                synchronize(true);
+            }
+        }
+
+        return moveToArena(statementStack_, first);
+    }
+
+    const Ast::Statement* CompilationEngine::buildLet() {
+        parseKeyword(Tokenizer::KeyWordType::LET);
+        tokenizer_.advance();
+        parseIdentifier();
+
+        const auto* target = buildVariable(tokenizer_.identifier());
+        const Ast::Expression* index{};
+
+        tokenizer_.advance();
+
+        if(tryParseSymbol('[')) {
+            tokenizer_.advance();
+            index = buildExpression();
+
+            parseSymbol(']');
+            tokenizer_.advance();
+        }
+
+        parseSymbol('=');
+        tokenizer_.advance();
+
+        const auto* value = buildExpression();
+
+        parseSymbol(';');
+        tokenizer_.advance();
+
+        return arena_.create<Ast::LetStatement>(target, index, value);
+    }
+
+    const Ast::Statement* CompilationEngine::buildIf() {
+        parseKeyword(Tokenizer::KeyWordType::IF);
+        tokenizer_.advance();
+        parseSymbol('(');
+        tokenizer_.advance();
+
+        const auto* condition = buildExpression();
+
+        parseSymbol(')');
+        tokenizer_.advance();
+        parseSymbol('{');
+        tokenizer_.advance();
+
+        const auto thenStatements = buildStatements();
+
+        parseSymbol('}');
+        tokenizer_.advance();
+
+        Ast::List<const Ast::Statement*> elseStatements;
+        const auto hasElse = tryParseKeyword(Tokenizer::KeyWordType::ELSE);
+
+        if(hasElse) {
+            tokenizer_.advance();
+            parseSymbol('{');
+            tokenizer_.advance();
+
+            elseStatements = buildStatements();
+
+            parseSymbol('}');
+            tokenizer_.advance();
+        }
+
+        return arena_.create<Ast::IfStatement>(condition, thenStatements, elseStatements, hasElse);
+    }
+
+    const Ast::Statement* CompilationEngine::buildWhile() {
+        parseKeyword(Tokenizer::KeyWordType::WHILE);
+        tokenizer_.advance();
+        parseSymbol('(');
+        tokenizer_.advance();
+
+        const auto* condition = buildExpression();
+
+        parseSymbol(')');
+        tokenizer_.advance();
+        parseSymbol('{');
+        tokenizer_.advance();
+
+        const auto statements = buildStatements();
+
+        parseSymbol('}');
+        tokenizer_.advance();
+
+        return arena_.create<Ast::WhileStatement>(condition, statements);
+    }
+
+    const Ast::Statement* CompilationEngine::buildDo() {
+        parseKeyword(Tokenizer::KeyWordType::DO);
+        tokenizer_.advance();
+
+        if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid subroutine-call."};
+        }
+
+        const auto identifier = tokenizer_.identifier();
+        const auto followingSymbol = tokenizer_.peekSymbol();
+        tokenizer_.advance();
+
+        if(followingSymbol != '.' && symbolTable_.kindOf(identifier) != SymbolTable::SymbolKind::NONE) {
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid subroutine-call."};
+        }
+
+        const auto* call = buildSubroutineCall(identifier, followingSymbol);
+
+        parseSymbol(';');
+        tokenizer_.advance();
+
+        return arena_.create<Ast::DoStatement>(call);
+    }
+
+    const Ast::Statement* CompilationEngine::buildReturn() {
+        parseKeyword(Tokenizer::KeyWordType::RETURN);
+        tokenizer_.advance();
+
+        const Ast::Expression* value{};
+
+        if(!tryParseSymbol(';')) {
+            value = buildExpression();
+            parseSymbol(';');
+        }
+
+        tokenizer_.advance();
+
+        return arena_.create<Ast::ReturnStatement>(value);
+    }
+
+    const Ast::Expression* CompilationEngine::buildExpression() {
+        const auto* expression = buildTerm();
+
+        while(tryParseOpSymbol()) {
+            // Jack has no operator precedence, operations are evaluated from left to right
+            const auto opSymbol = tokenizer_.symbol();
+            tokenizer_.advance();
+
+            const auto* rightOperand = buildTerm();
+
+            expression = makeBinaryOp(opSymbol, expression, rightOperand);
+        }
+
+        return expression;
+    }
+
+    const Ast::Expression* CompilationEngine::buildTerm() {
+        if(tryParseSymbol('(')) {
+            // (expression)
+            tokenizer_.advance();
+
+            const auto* expression = buildExpression();
+
+            parseSymbol(')');
+            tokenizer_.advance();
+
+            return expression;
+        }
+
+        if(tryParseUnaryOpSymbol()) {
+            // unaryOp term
+            const auto symbol = tokenizer_.symbol();
+            tokenizer_.advance();
+
+            return makeUnaryOp(symbol, buildTerm());
+        }
+
+        const Ast::Expression* term{};
+
+        if(tryParseIntConst()) {
+            term = arena_.create<Ast::IntConstant>(tokenizer_.intVal());
+        }
+        else if(tryParseStringConst()) {
+            // the string-value is copied, since it may refer to a reused buffer of the tokenizer
+            term = arena_.create<Ast::StringConstant>(arena_.copy(tokenizer_.stringVal()));
+        }
+        else if(tryParseKeyword({Tokenizer::KeyWordType::TRUE, Tokenizer::KeyWordType::FALSE, 
+            Tokenizer::KeyWordType::NULL_, Tokenizer::KeyWordType::THIS})) {
+            term = arena_.create<Ast::KeywordConstant>(tokenizer_.keyWord());
+        }
+        else if(tryParseIdentifier()) {
+            // varName OR varName[expression] OR subroutineCall, told apart by the symbol following the identifier
+            const auto identifier = tokenizer_.identifier();
+            const auto followingSymbol = tokenizer_.peekSymbol();
+            tokenizer_.advance();
+
+            if(followingSymbol == '[') {
+                // [expression]
+                const auto* array = buildVariable(identifier);
+                tokenizer_.advance();
+
+                const auto* index = buildExpression();
+
+                parseSymbol(']');
+                tokenizer_.advance();
+
+                return arena_.create<Ast::ArrayElement>(array, index);
+            }
+
+            if(followingSymbol == '(' || followingSymbol == '.') {
+                return buildSubroutineCall(identifier, followingSymbol);
+            }
+
+            return buildVariable(identifier);
+        }
+        else {
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid term-construct."};
+        }
+
+        tokenizer_.advance();
+        return term;
+    }
+
+    const Ast::SubroutineCall* CompilationEngine::buildSubroutineCall(string_view identifier, char followingSymbol) {
+        if(followingSymbol != '.') {
+            // methodName(expressionList)
+            const auto* receiver = arena_.create<Ast::KeywordConstant>(Tokenizer::KeyWordType::THIS);
+            const auto arguments = buildArgumentList();
+
+            return arena_.create<Ast::SubroutineCall>(className_, identifier, receiver, arguments);
+        }
+
+        // className.functionName(expressionList) OR varName.methodName(expressionList)
+        tokenizer_.advance();
+        parseIdentifierAsSubroutineName();
+        const auto subroutineName = tokenizer_.identifier();
+        tokenizer_.advance();
+
+        if(symbolTable_.kindOf(identifier) == SymbolTable::SymbolKind::NONE) {
+            // The definition of the Jack-language implies that if in an error-free program, an 
+            // identifier is not of type STATIC, FIELD, ARG or VAR then it must be a class-name
+            const auto arguments = buildArgumentList();
+
+            return arena_.create<Ast::SubroutineCall>(identifier, subroutineName, nullptr, arguments);
+        }
+
+        const auto* receiver = buildVariable(identifier);
+        const auto arguments = buildArgumentList();
+
+        return arena_.create<Ast::SubroutineCall>(receiver->type, subroutineName, receiver, arguments);
+    }
+
+    Ast::List<const Ast::Expression*> CompilationEngine::buildArgumentList() {
+        parseSymbol('(');
+        tokenizer_.advance();
+
+        const auto first = expressionStack_.size();
+
+        if(termEncountered()) {
+            expressionStack_.push_back(buildExpression());
+
+            while(tryParseSymbol(',')) {
+                tokenizer_.advance();
+                expressionStack_.push_back(buildExpression());
+            }
+        }
+
+        parseSymbol(')');
+        tokenizer_.advance();
+
+        return moveToArena(expressionStack_, first);
+    }
+
+    const Ast::Variable* CompilationEngine::buildVariable(string_view identifier) {
+        const auto* entry = symbolTable_.find(identifier);
+
+        if(entry == nullptr) {
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Undefined variable '" + string{identifier} + "'."};
+        }
+
+        return arena_.create<Ast::Variable>(identifier, entry->type, symbolKindToSegment(entry->kind), entry->index);
+    }
+
+    const Ast::Expression* CompilationEngine::makeUnaryOp(char opSymbol, const Ast::Expression* operand) {
+        if(options_.foldConstants) {
+            if(const auto value = ConstantFolding::valueOf(*operand)) {
+                const auto* result = arena_.create<Ast::IntConstant>(ConstantFolding::evaluate(opSymbol, *value));
+
+                statistics_.add("constant folding", static_cast<size_t>(ConstantFolding::instructionCount(*operand) + 1 - 
+                    ConstantFolding::instructionCount(*result)));
+                return result;
+            }
+        }
+
+        return arena_.create<Ast::UnaryOp>(opSymbol, operand);
+    }
+
+    const Ast::Expression* CompilationEngine::makeBinaryOp(char opSymbol, const Ast::Expression* leftOperand, 
+        const Ast::Expression* rightOperand) {
+        if(options_.foldConstants) {
+            const auto leftValue = ConstantFolding::valueOf(*leftOperand);
+            const auto rightValue = ConstantFolding::valueOf(*rightOperand);
+
+            if(leftValue && rightValue) {
+                if(const auto value = ConstantFolding::evaluate(opSymbol, *leftValue, *rightValue)) {
+                    const auto* result = arena_.create<Ast::IntConstant>(*value);
+
+                    statistics_.add("constant folding", static_cast<size_t>(ConstantFolding::instructionCount(*leftOperand) + 
+                        ConstantFolding::instructionCount(*rightOperand) + 1 - ConstantFolding::instructionCount(*result)));
+                    return result;
+                }
+            }
+        }
+
+        return arena_.create<Ast::BinaryOp>(opSymbol, leftOperand, rightOperand);
+    }
+
+    template<typename T>
+    Ast::List<T> CompilationEngine::moveToArena(std::vector<T>& stack, size_t first) {
+        const auto count = stack.size() - first;
+        const Ast::List<T> list{arena_.copy(stack.data() + first, count), count};
+
+        stack.resize(first);
+        return list;
+    }
+
+    void CompilationEngine::writeSubroutineEntry(string_view className, string_view subroutineName,
+        Tokenizer::KeyWordType subroutineType, int nLocals, int nFields) {
+        vmWriter_.writeFunction(className, subroutineName, nLocals);
+
+        if(subroutineType == Tokenizer::KeyWordType::METHOD) {
+            vmWriter_.writePush(VMWriter::Segment::ARG, 0);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 0);
+        }
+        else if(subroutineType == Tokenizer::KeyWordType::CONSTRUCTOR) {
+            vmWriter_.writePush(VMWriter::Segment::CONST, nFields);
+            vmWriter_.writeCall("Memory.alloc", 1);
+            vmWriter_.writePop(VMWriter::Segment::POINTER, 0);
+        }
+    }
+
+    void CompilationEngine::writeIntConstant(int value) {
+        if(value >= 0) {
+            vmWriter_.writePush(VMWriter::Segment::CONST, value);
+        }
+        else {
+            // only non-negative constants can be pushed
+            vmWriter_.writePush(VMWriter::Segment::CONST, ~value);
+            vmWriter_.writeArithmetic(VMWriter::Command::NOT);
+        }
+    }
+
+    void CompilationEngine::writeStringConstant(string_view value) {
+        vmWriter_.writePush(VMWriter::Segment::CONST, static_cast<int>(value.size()));
+        vmWriter_.writeCall("String.new", 1);
+
+        for(auto c : value) {
+            vmWriter_.writePush(VMWriter::Segment::CONST, c);
+            vmWriter_.writeCall("String.appendChar", 2);
+        }
+    }
+
+    void CompilationEngine::writeKeywordConstant(Tokenizer::KeyWordType keyword) {
+        if(keyword == Tokenizer::KeyWordType::TRUE) {
+            vmWriter_.writePush(VMWriter::Segment::CONST, 0);
+            vmWriter_.writeArithmetic(VMWriter::Command::NOT);
+        }
+        else if(keyword == Tokenizer::KeyWordType::FALSE || keyword == Tokenizer::KeyWordType::NULL_) {
+            vmWriter_.writePush(VMWriter::Segment::CONST, 0);
+        }
+        else {
+            vmWriter_.writePush(VMWriter::Segment::POINTER, 0);
+        }
+    }
+
+    void CompilationEngine::writeStringPoolGuard(string_view className) {
+        // the first string is null until the pool has been initialized
+        vmWriter_.writePush(VMWriter::Segment::STATIC, stringPool_->firstStaticIndex());
+        vmWriter_.writeIf(STRING_POOL_READY_LABEL);
+        vmWriter_.writeCall(className, StringPool::INITIALIZER_NAME, 0);
+        vmWriter_.writePop(VMWriter::Segment::TEMP, 0);
+        vmWriter_.writeLabel(STRING_POOL_READY_LABEL);
+    }
+
+    void CompilationEngine::writeStringPoolInitializer(string_view className) {
+        vmWriter_.writeFunction(className, StringPool::INITIALIZER_NAME, 0);
+
+        for(const auto value : stringPool_->strings()) {
+            writeStringConstant(value);
+            vmWriter_.writePop(VMWriter::Segment::STATIC, stringPool_->staticIndex(value));
+        }
+
+        vmWriter_.writePush(VMWriter::Segment::CONST, 0);
+        vmWriter_.writeReturn();
+    }
+
+    void CompilationEngine::writeOp(char opSymbol) {
+        switch(opSymbol) {
+            case '*':
+                vmWriter_.writeCall("Math.multiply", 2);
+                break;
+            case '/':
+                vmWriter_.writeCall("Math.divide", 2);
+                break;
+            default:
+                vmWriter_.writeArithmetic(symbolToCommand(OP_SYMBOL_TO_COMMAND, opSymbol));
+        }
+    }
+
+    bool CompilationEngine::classVarDecEncountered() const {
+        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
+            (tokenizer_.keyWord() == Tokenizer::KeyWordType::STATIC ||
+                tokenizer_.keyWord() == Tokenizer::KeyWordType::FIELD);
+    }
+
+
+    bool CompilationEngine::subroutineDecEncountered() const {
+        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
+            (tokenizer_.keyWord() == Tokenizer::KeyWordType::CONSTRUCTOR ||
+                tokenizer_.keyWord() == Tokenizer::KeyWordType::FUNCTION ||
+                tokenizer_.keyWord() == Tokenizer::KeyWordType::METHOD);
+    }
+
+    bool CompilationEngine::typeEncountered() const {
+        return tokenizer_.tokenType() == Tokenizer::TokenType::IDENTIFIER ||
+            (tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
+            (tokenizer_.keyWord() == Tokenizer::KeyWordType::INT ||
+                tokenizer_.keyWord() == Tokenizer::KeyWordType::CHAR ||
+                tokenizer_.keyWord() == Tokenizer::KeyWordType::BOOLEAN));
+    }
+
+    bool CompilationEngine::varDecEncountered() const {
+        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
+            tokenizer_.keyWord() == Tokenizer::KeyWordType::VAR;
+    }
+
+    bool CompilationEngine::statementEncountered() const {
+        return tokenizer_.tokenType() == Tokenizer::TokenType::KEYWORD &&
+            std::find(STATEMENT_KEYWORD_TYPES.cbegin(), STATEMENT_KEYWORD_TYPES.cend(),
+                tokenizer_.keyWord()) != STATEMENT_KEYWORD_TYPES.cend();
+    }
+
+    bool CompilationEngine::termEncountered() const {
+        switch(tokenizer_.tokenType()) {
+            case Tokenizer::TokenType::INT_CONST:
+                return true;
+            case Tokenizer::TokenType::STRING_CONST:
+                return true;
+            case Tokenizer::TokenType::KEYWORD:
+                return std::find(KEYWORD_CONSTANTS.cbegin(), KEYWORD_CONSTANTS.cend(),
+                    tokenizer_.keyWord()) != KEYWORD_CONSTANTS.cend();
+            case Tokenizer::TokenType::SYMBOL:
+                return tokenizer_.symbol() == '(' || std::find(UNARY_OPS.cbegin(), UNARY_OPS.cend(),
+                    tokenizer_.symbol()) != UNARY_OPS.cend();
+            case Tokenizer::TokenType::IDENTIFIER:
+                return true;
+        }
+
+        return false;
+    }
+
+    void CompilationEngine::parseSymbol(char expectedSymbol) const {
+        if(tokenizer_.tokenType() != Tokenizer::TokenType::SYMBOL) {
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected a symbol-token."};
+        }
+
+        if(const auto symbol = tokenizer_.symbol();  symbol != expectedSymbol) {
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected symbol \"" +
                 to_string(expectedSymbol) + "\" but got \"" + to_string(symbol) + "\"."};
         }
     }
@@ -719,11 +2175,11 @@ namespace JackCompiler {
 
     void CompilationEngine::parseOpSymbol() const {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::SYMBOL) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected a symbol-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected a symbol-token."};
         }
 
         if(find(OPS.cbegin(), OPS.cend(), tokenizer_.symbol()) == OPS.cend()) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected operation symbol."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected operation symbol."};
         }
     }
 
@@ -734,11 +2190,11 @@ namespace JackCompiler {
 
     void CompilationEngine::parseUnaryOpSymbol() const {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::SYMBOL) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected a symbol-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected a symbol-token."};
         }
 
         if(find(UNARY_OPS.cbegin(), UNARY_OPS.cend(), tokenizer_.symbol()) == UNARY_OPS.cend()) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected unary-operation symbol."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected unary-operation symbol."};
         }
     }
 
@@ -749,12 +2205,12 @@ namespace JackCompiler {
 
     void CompilationEngine::parseKeyword(Tokenizer::KeyWordType expectedKeywordType) const {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::KEYWORD) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected a keyword-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected a keyword-token."};
         }
 
         if(const auto keyword = tokenizer_.keyWord(); keyword != expectedKeywordType) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected keyword \"" +
-                KEYWORD_TYPE_TO_STRING.at(expectedKeywordType) + "\" but got \"" + KEYWORD_TYPE_TO_STRING.at(keyword) + "\"."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected keyword \"" +
+                string{keywordTypeToString(expectedKeywordType)} + "\" but got \"" + string{keywordTypeToString(keyword)} + "\"."};
         }
     }
 
@@ -764,13 +2220,13 @@ namespace JackCompiler {
 
     void CompilationEngine::parseKeyword(initializer_list<Tokenizer::KeyWordType> validKeywordTypes) const {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::KEYWORD) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected a keyword-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected a keyword-token."};
         }
 
         if(const auto keyword = tokenizer_.keyWord(); find(validKeywordTypes.begin(), 
             validKeywordTypes.end(), keyword) == validKeywordTypes.end()) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) +
-                ": Invalid keyword \"" + KEYWORD_TYPE_TO_STRING.at(keyword) + "\"."};
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid keyword \"" + string{keywordTypeToString(keyword)} + "\"."};
         }
     }
 
@@ -784,15 +2240,15 @@ namespace JackCompiler {
             validKeywordTypes.begin(), validKeywordTypes.end(), tokenizer_.keyWord()) != validKeywordTypes.end();
     }
 
-    void CompilationEngine::parseIdentifierAsVariableDefinition(SymbolTable::SymbolKind kind, const std::string& type) {
+    void CompilationEngine::parseIdentifierAsVariableDefinition(SymbolTable::SymbolKind kind, string_view type) {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected an identifier-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected an identifier-token."};
         }
 
         const auto identifier = tokenizer_.identifier();
 
         if(const auto symbolKind = symbolTable_.kindOf(identifier); symbolKind != SymbolTable::SymbolKind::NONE && symbolKind == kind) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Redefinition of identifier in same scope."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Redefinition of identifier in same scope."};
         }
 
         symbolTable_.define(identifier, type, kind);
@@ -800,28 +2256,28 @@ namespace JackCompiler {
 
     void CompilationEngine::parseIdentifierAsSubroutineDefinition() {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected an identifier-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected an identifier-token."};
         }
 
         if(symbolTable_.kindOf(tokenizer_.identifier()) != SymbolTable::SymbolKind::NONE) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) +
-                ": Invalid definition of a subroutine with the same name as a static/field variable."};
+            throw CompilationError{tokenizer_.getCurrentLine(),
+                "Invalid definition of a subroutine with the same name as a static/field variable."};
         }
     }
 
     void CompilationEngine::parseIdentifier() const {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected an identifier-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected an identifier-token."};
         }
     }
 
     void CompilationEngine::parseIdentifierAsClassName() {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected an identifier-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected an identifier-token."};
         }
 
         if(symbolTable_.kindOf(tokenizer_.identifier()) != SymbolTable::SymbolKind::NONE) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected a class-name."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected a class-name."};
         }
     }
 
@@ -833,7 +2289,7 @@ namespace JackCompiler {
     void CompilationEngine::parseIdentifierAsClassNameDefinition() {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER ||
             symbolTable_.kindOf(tokenizer_.identifier()) != SymbolTable::SymbolKind::NONE) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Invalid class definition."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Invalid class definition."};
         }
 
         className_ = tokenizer_.identifier();
@@ -841,11 +2297,11 @@ namespace JackCompiler {
 
     void CompilationEngine::parseIdentifierAsSubroutineName() {
         if(tokenizer_.tokenType() != Tokenizer::TokenType::IDENTIFIER) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected an identifier-token."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected an identifier-token."};
         }
 
         if(symbolTable_.kindOf(tokenizer_.identifier()) != SymbolTable::SymbolKind::NONE) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Expected an subroutine-name."};
+            throw CompilationError{tokenizer_.getCurrentLine(), "Expected an subroutine-name."};
         }
     }
 
@@ -857,22 +2313,28 @@ namespace JackCompiler {
         return tokenizer_.tokenType() == Tokenizer::TokenType::STRING_CONST;
     }
 
-    std::string CompilationEngine::parseVariableType() {
+    string_view CompilationEngine::parseVariableType() {
         if(tryParseKeyword({Tokenizer::KeyWordType::INT, Tokenizer::KeyWordType::CHAR, Tokenizer::KeyWordType::BOOLEAN})) {
-            return KEYWORD_TYPE_TO_STRING.at(tokenizer_.keyWord());
+            return keywordTypeToString(tokenizer_.keyWord());
         }
 
         if(tryParseIdentifierAsClassName()) {
             return tokenizer_.identifier();
         }
 
-        throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Invalid type."};
+        throw CompilationError{tokenizer_.getCurrentLine(), "Invalid type."};
     }
 
-    void CompilationEngine::parseSubroutineReturnType() {
-        if(!tryParseKeyword({Tokenizer::KeyWordType::VOID, Tokenizer::KeyWordType::INT, 
-            Tokenizer::KeyWordType::CHAR, Tokenizer::KeyWordType::BOOLEAN}) && !tryParseIdentifierAsClassName()) {
-            throw runtime_error{"On line " + to_string(tokenizer_.getCurrentLine()) + ": Invalid subroutine return-type."};
+    string_view CompilationEngine::parseSubroutineReturnType() {
+        if(tryParseKeyword({Tokenizer::KeyWordType::VOID, Tokenizer::KeyWordType::INT, 
+            Tokenizer::KeyWordType::CHAR, Tokenizer::KeyWordType::BOOLEAN})) {
+            return keywordTypeToString(tokenizer_.keyWord());
+        }
+
+        if(tryParseIdentifierAsClassName()) {
+            return tokenizer_.identifier();
         }
+
+        throw CompilationError{tokenizer_.getCurrentLine(), "Invalid subroutine return-type."};
     }
 }
@@ -0,0 +1,225 @@
+#include "CompileCache.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+using std::string;
+using std::string_view;
+using std::optional;
+using std::ifstream;
+using std::ofstream;
+using std::error_code;
+using std::vector;
+using std::lock_guard;
+using std::mutex;
+namespace fs = std::filesystem;
+
+namespace JackCompiler {
+    namespace {
+        constexpr string_view ENTRY_EXTENSION{".vm"};
+        constexpr string_view TEMPORARY_EXTENSION{".tmp"};
+        // the first line of an entry, which is followed by the hash of the output
+        constexpr string_view ENTRY_HEADER{"jack-compiler-cache 1 "};
+        // temporary files of processes that are still running are not removed
+        constexpr std::chrono::hours TEMPORARY_FILE_LIFETIME{1};
+        // evicting stops well below the maximum size, so that not every compilation has to evict entries
+        constexpr std::uintmax_t EVICTION_PERCENTAGE = 80;
+    }
+
+    CompileCache::CompileCache(const fs::path& directoryPath, std::uintmax_t maxSize)
+        : directoryPath_{directoryPath}, maxSize_{maxSize} {
+        error_code error;
+        fs::create_directories(directoryPath_, error);
+
+        std::random_device randomDevice;
+        const auto random = (static_cast<ContentHash::Hash>(randomDevice()) << 32) | randomDevice();
+        temporarySuffix_ = string{TEMPORARY_EXTENSION} + '.' + ContentHash::toString(random);
+    }
+
+    CompileCache::CompileCache(std::uintmax_t maxSize) : maxSize_{maxSize} {}
+
+    optional<string> CompileCache::load(ContentHash::Hash sourceHash, ContentHash::Hash configuration) {
+        const auto key = keyOf(sourceHash, configuration);
+        optional<string> output;
+
+        if(!directoryPath_.empty()) {
+            output = loadFromDirectory(key);
+        }
+        else {
+            const lock_guard<mutex> lock{memoryMutex_};
+
+            if(const auto entry = memoryEntries_.find(key); entry != memoryEntries_.end()) {
+                entry->second.lastUse = ++uses_;
+                output = entry->second.output;
+            }
+        }
+
+        ++(output ? hits_ : misses_);
+        return output;
+    }
+
+    void CompileCache::store(ContentHash::Hash sourceHash, ContentHash::Hash configuration, string_view output) {
+        const auto key = keyOf(sourceHash, configuration);
+
+        if(!directoryPath_.empty()) {
+            storeInDirectory(key, output);
+            return;
+        }
+
+        const lock_guard<mutex> lock{memoryMutex_};
+        auto& entry = memoryEntries_[key];
+
+        memorySize_ = memorySize_ - entry.output.size() + output.size();
+        entry.output = output;
+        entry.lastUse = ++uses_;
+    }
+
+    void CompileCache::evict() {
+        if(!directoryPath_.empty()) {
+            evictFromDirectory();
+        }
+        else {
+            evictFromMemory();
+        }
+    }
+
+    string CompileCache::keyOf(ContentHash::Hash sourceHash, ContentHash::Hash configuration) {
+        return ContentHash::toString(sourceHash) + ContentHash::toString(configuration);
+    }
+
+    optional<string> CompileCache::loadFromDirectory(const string& key) {
+        const auto path = entryPath(key);
+        ifstream entryFile{path, std::ios::binary};
+        string header;
+
+        if(entryFile && std::getline(entryFile, header) && header.compare(0, ENTRY_HEADER.size(), ENTRY_HEADER) == 0) {
+            const auto outputHash = ContentHash::fromString(string_view{header}.substr(ENTRY_HEADER.size()));
+            string output{std::istreambuf_iterator<char>{entryFile}, std::istreambuf_iterator<char>{}};
+
+            if(outputHash && ContentHash::of(output) == *outputHash) {
+                // the modification time marks when the entry has been used last
+                error_code error;
+                fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+
+                return output;
+            }
+        }
+
+        return {};
+    }
+
+    void CompileCache::storeInDirectory(const string& key, string_view output) {
+        const auto path = entryPath(key);
+        auto temporaryPath = path;
+        temporaryPath += temporarySuffix_ + '.' + std::to_string(stores_++);
+        error_code error;
+
+        fs::create_directories(path.parent_path(), error);
+
+        {
+            ofstream entryFile{temporaryPath, std::ios::binary};
+            entryFile << ENTRY_HEADER << ContentHash::toString(ContentHash::of(output)) << '\n';
+            entryFile.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+            if(!entryFile.flush()) {
+                entryFile.close();
+                fs::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        // if another process has stored the same entry in the meantime, it is replaced by an identical one
+        fs::rename(temporaryPath, path, error);
+
+        if(error) {
+            fs::remove(temporaryPath, error);
+        }
+    }
+
+    void CompileCache::evictFromDirectory() {
+        struct Entry {
+            fs::path path;
+            std::uintmax_t size;
+            fs::file_time_type time;
+        };
+
+        vector<Entry> entries;
+        std::uintmax_t totalSize{};
+        error_code error;
+        const auto now = fs::file_time_type::clock::now();
+
+        for(fs::recursive_directory_iterator item{directoryPath_, error}, end; !error && item != end; item.increment(error)) {
+            if(!item->is_regular_file(error)) {
+                continue;
+            }
+
+            const auto size = item->file_size(error);
+            const auto time = item->last_write_time(error);
+
+            if(error) {
+                // the file has been removed by another process
+                error.clear();
+                continue;
+            }
+
+            if(item->path().extension() == ENTRY_EXTENSION) {
+                entries.push_back({item->path(), size, time});
+                totalSize += size;
+            }
+            else if(item->path().filename().string().find(TEMPORARY_EXTENSION) != string::npos && 
+                    time < now - TEMPORARY_FILE_LIFETIME) {
+                fs::remove(item->path(), error);
+                error.clear();
+            }
+        }
+
+        if(totalSize <= maxSize_) {
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [] (const Entry& lhs, const Entry& rhs) { return lhs.time < rhs.time; });
+
+        for(const auto& entry : entries) {
+            if(totalSize <= maxSize_ / 100 * EVICTION_PERCENTAGE) {
+                break;
+            }
+
+            fs::remove(entry.path, error);
+            totalSize -= entry.size;
+        }
+    }
+
+    void CompileCache::evictFromMemory() {
+        const lock_guard<mutex> lock{memoryMutex_};
+
+        if(memorySize_ <= maxSize_) {
+            return;
+        }
+
+        vector<std::pair<std::uint64_t, const string*>> entries;
+
+        for(const auto& [key, entry] : memoryEntries_) {
+            entries.emplace_back(entry.lastUse, &key);
+        }
+
+        std::sort(entries.begin(), entries.end());
+
+        for(const auto& [lastUse, key] : entries) {
+            if(memorySize_ <= maxSize_ / 100 * EVICTION_PERCENTAGE) {
+                break;
+            }
+
+            const auto entry = memoryEntries_.find(*key);
+            memorySize_ -= entry->second.output.size();
+            memoryEntries_.erase(entry);
+        }
+    }
+
+    fs::path CompileCache::entryPath(const string& key) const {
+        // the entries are distributed to subdirectories by the first two digits, which keeps the directories small
+        return directoryPath_ / key.substr(0, 2) / (key.substr(2) + string{ENTRY_EXTENSION});
+    }
+}
@@ -0,0 +1,533 @@
+#include "CompileServer.h"
+#include "CompileCache.h"
+#include "JackCompiler.h"
+#include "TaskScheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#define JACK_COMPILER_HAS_UNIX_SOCKETS
+#endif
+
+using std::string;
+using std::string_view;
+using std::ostream;
+using std::istringstream;
+using std::ostringstream;
+using std::optional;
+using std::nullopt;
+using std::endl;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::condition_variable;
+using std::deque;
+using std::vector;
+using std::thread;
+using std::atomic;
+namespace fs = std::filesystem;
+namespace chrono = std::chrono;
+
+namespace JackCompiler::CompileServer {
+    namespace {
+#ifdef JACK_COMPILER_HAS_UNIX_SOCKETS
+        constexpr string_view REQUEST_HEADER{"jack-compiler-request 1"};
+        // requests only contain a path and the options
+        constexpr size_t MAX_REQUEST_SIZE = 64 * 1024;
+        // a client that does not send its request in time is disconnected, so that it does not block a thread
+        constexpr chrono::milliseconds MAX_REQUEST_TIME{chrono::seconds{10}};
+
+        /**
+         * \brief Writes a request as lines of names and values, which are terminated by an empty line. Every option
+         * has to be listed. The paths must not contain line breaks.
+         */
+        string encodeRequest(const string& inputPathName, const CompilationOptions& options) {
+            ostringstream request;
+            request << REQUEST_HEADER << '\n'
+                    << "path " << inputPathName << '\n'
+                    << "ast " << options.buildAst << '\n'
+                    << "peephole " << options.peephole << '\n'
+                    << "fold-constants " << options.foldConstants << '\n'
+                    << "reduce-strength " << options.reduceStrength << '\n'
+                    << "pool-strings " << options.poolStrings << '\n'
+                    << "eliminate-dead-code " << options.eliminateDeadCode << '\n'
+                    << "inline " << options.inlineThreshold << '\n'
+                    << "eliminate-dead-subroutines " << options.eliminateDeadSubroutines << '\n'
+                    << "compact-control-flow " << options.compactControlFlow << '\n'
+                    << "optimize-array-access " << options.optimizeArrayAccess << '\n'
+                    << "eliminate-common-subexpressions " << options.eliminateCommonSubexpressions << '\n'
+                    << "max-errors " << options.maxErrors << '\n'
+                    << "jobs " << options.jobs << '\n'
+                    << "incremental " << options.incremental << '\n'
+                    << "cache-directory " << options.cacheDirectory << '\n'
+                    << "cache-size " << options.cacheSize << '\n'
+                    << "\n";
+
+            return request.str();
+        }
+
+        template<typename T>
+        bool parseValue(const string& value, T& field) {
+            istringstream valueStream{value};
+            return static_cast<bool>(valueStream >> field) && valueStream.eof();
+        }
+
+        /**
+         * \brief Reads a request written by encodeRequest.
+         * \return False if the request is invalid
+         */
+        bool decodeRequest(const string& request, string& inputPathName, CompilationOptions& options) {
+            istringstream lines{request};
+            string line;
+
+            if(!std::getline(lines, line) || line != REQUEST_HEADER) {
+                return false;
+            }
+
+            while(std::getline(lines, line) && !line.empty()) {
+                const auto separator = line.find(' ');
+
+                if(separator == string::npos) {
+                    return false;
+                }
+
+                const auto name = line.substr(0, separator);
+                const auto value = line.substr(separator + 1);
+                bool valid{};
+
+                if(name == "path") {
+                    inputPathName = value;
+                    valid = !value.empty();
+                }
+                else if(name == "ast") { valid = parseValue(value, options.buildAst); }
+                else if(name == "peephole") { valid = parseValue(value, options.peephole); }
+                else if(name == "fold-constants") { valid = parseValue(value, options.foldConstants); }
+                else if(name == "reduce-strength") { valid = parseValue(value, options.reduceStrength); }
+                else if(name == "pool-strings") { valid = parseValue(value, options.poolStrings); }
+                else if(name == "eliminate-dead-code") { valid = parseValue(value, options.eliminateDeadCode); }
+                else if(name == "inline") { valid = parseValue(value, options.inlineThreshold); }
+                else if(name == "eliminate-dead-subroutines") { valid = parseValue(value, options.eliminateDeadSubroutines); }
+                else if(name == "compact-control-flow") { valid = parseValue(value, options.compactControlFlow); }
+                else if(name == "optimize-array-access") { valid = parseValue(value, options.optimizeArrayAccess); }
+                else if(name == "eliminate-common-subexpressions") { valid = parseValue(value, options.eliminateCommonSubexpressions); }
+                else if(name == "max-errors") { valid = parseValue(value, options.maxErrors); }
+                else if(name == "jobs") { valid = parseValue(value, options.jobs); }
+                else if(name == "incremental") { valid = parseValue(value, options.incremental); }
+                else if(name == "cache-directory") { options.cacheDirectory = value; valid = true; }
+                else if(name == "cache-size") { valid = parseValue(value, options.cacheSize); }
+
+                if(!valid) {
+                    return false;
+                }
+            }
+
+            return !inputPathName.empty();
+        }
+
+        /**
+         * \brief Closes a socket when it goes out of scope.
+         */
+        class Socket {
+        public:
+            explicit Socket(int fileDescriptor = -1) : fileDescriptor_{fileDescriptor} {}
+
+            Socket(const Socket&) = delete;
+            Socket& operator=(const Socket&) = delete;
+            Socket(Socket&& other) noexcept : fileDescriptor_{other.fileDescriptor_} { other.fileDescriptor_ = -1; }
+            Socket& operator=(Socket&&) = delete;
+
+            ~Socket() {
+                if(fileDescriptor_ != -1) {
+                    ::close(fileDescriptor_);
+                }
+            }
+
+            int get() const { return fileDescriptor_; }
+
+            explicit operator bool() const { return fileDescriptor_ != -1; }
+
+        private:
+            int fileDescriptor_;
+        };
+
+        optional<sockaddr_un> addressOf(const string& socketPath) {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+
+            if(socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+                return {};
+            }
+
+            std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+            return address;
+        }
+
+        Socket connectTo(const string& socketPath) {
+            const auto address = addressOf(socketPath);
+
+            if(!address) {
+                return Socket{};
+            }
+
+            Socket connection{::socket(AF_UNIX, SOCK_STREAM, 0)};
+
+            if(!connection || ::connect(connection.get(), reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) != 0) {
+                return Socket{};
+            }
+
+            return connection;
+        }
+
+        bool sendAll(int fileDescriptor, string_view data) {
+#ifdef MSG_NOSIGNAL
+            // a client that has disconnected must not terminate the server with SIGPIPE
+            constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+            constexpr int SEND_FLAGS = 0;
+#endif
+
+            while(!data.empty()) {
+                const auto sent = ::send(fileDescriptor, data.data(), data.size(), SEND_FLAGS);
+
+                if(sent < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if(sent <= 0) {
+                    return false;
+                }
+
+                data.remove_prefix(static_cast<size_t>(sent));
+            }
+
+            return true;
+        }
+
+        /**
+         * \brief Receives data until the other side stops sending, the terminator has been received or the
+         * maximum size has been exceeded.
+         * \return The data or nothing if the deadline (if any) has passed before
+         */
+        string receive(int fileDescriptor, string_view terminator, size_t maxSize, 
+                       optional<chrono::steady_clock::time_point> deadline = nullopt) {
+            string data;
+            char buffer[4096];
+
+            while(data.size() <= maxSize && (terminator.empty() || data.find(terminator) == string::npos)) {
+                if(deadline) {
+                    const auto remaining = chrono::duration_cast<chrono::milliseconds>(*deadline - chrono::steady_clock::now());
+                    pollfd connectionPoll{fileDescriptor, POLLIN, 0};
+                    const auto ready = remaining.count() > 0 ? ::poll(&connectionPoll, 1, static_cast<int>(remaining.count())) : 0;
+
+                    if(ready < 0 && errno == EINTR) {
+                        continue;
+                    }
+
+                    if(ready <= 0) {
+                        return {};
+                    }
+                }
+
+                const auto received = ::recv(fileDescriptor, buffer, sizeof(buffer), 0);
+
+                if(received < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if(received <= 0) {
+                    break;
+                }
+
+                data.append(buffer, static_cast<size_t>(received));
+            }
+
+            return data;
+        }
+
+        /**
+         * \brief The state of a running server, which is shared by the thread that accepts connections and
+         * the threads that serve requests.
+         */
+        class Server {
+        public:
+            Server(const CompilationOptions& options, chrono::milliseconds requestTimeout) 
+                : cache_{options.cacheSize}, requestTimeout_{requestTimeout} {}
+
+            void serve(int connection) {
+                // a client that only checks if the server is running sends no request
+                const auto request = receive(connection, "\n\n", MAX_REQUEST_SIZE, chrono::steady_clock::now() + requestTimeout_);
+
+                if(request.empty()) {
+                    return;
+                }
+
+                string inputPathName;
+                CompilationOptions options;
+                ostringstream report;
+                int status = -1;
+
+                if(request.size() > MAX_REQUEST_SIZE || !decodeRequest(request, inputPathName, options)) {
+                    report << "Invalid compile-request." << endl;
+                }
+                else {
+                    try {
+                        // a request with a cache directory shares its outputs with the compilations of other processes
+                        status = compile(inputPathName, options, report, options.cacheDirectory.empty() ? &cache_ : nullptr);
+                    }
+                    catch(const std::exception& e) {
+                        report << "The compilation failed: " << e.what() << endl;
+                    }
+                }
+
+                sendAll(connection, std::to_string(status) + '\n' + report.str());
+                ++requests_;
+            }
+
+            size_t requests() const { return requests_; }
+
+        private:
+            CompileCache cache_;
+            chrono::milliseconds requestTimeout_;
+            atomic<size_t> requests_{};
+        };
+
+        /**
+         * \brief The connections that have been accepted but not served yet.
+         */
+        class ConnectionQueue {
+        public:
+            void push(int connection) {
+                {
+                    const lock_guard<mutex> lock{queueMutex_};
+                    connections_.push_back(connection);
+                }
+
+                condition_.notify_one();
+            }
+
+            /**
+             * \brief Waits for the next connection.
+             * \return The connection or nothing if the queue has been closed
+             */
+            optional<int> pop() {
+                unique_lock<mutex> lock{queueMutex_};
+                condition_.wait(lock, [this] { return closed_ || !connections_.empty(); });
+
+                if(connections_.empty()) {
+                    return {};
+                }
+
+                const auto connection = connections_.front();
+                connections_.pop_front();
+                ++busyThreads_;
+
+                return connection;
+            }
+
+            void finish() {
+                const lock_guard<mutex> lock{queueMutex_};
+                --busyThreads_;
+                lastActivity_ = chrono::steady_clock::now();
+            }
+
+            bool isIdle(chrono::milliseconds idleTimeout) {
+                const lock_guard<mutex> lock{queueMutex_};
+                return connections_.empty() && busyThreads_ == 0 && chrono::steady_clock::now() - lastActivity_ >= idleTimeout;
+            }
+
+            void touch() {
+                const lock_guard<mutex> lock{queueMutex_};
+                lastActivity_ = chrono::steady_clock::now();
+            }
+
+            void close() {
+                {
+                    const lock_guard<mutex> lock{queueMutex_};
+                    closed_ = true;
+                }
+
+                condition_.notify_all();
+            }
+
+        private:
+            mutex queueMutex_;
+            condition_variable condition_;
+            deque<int> connections_;
+            size_t busyThreads_{};
+            bool closed_{};
+            chrono::steady_clock::time_point lastActivity_{chrono::steady_clock::now()};
+        };
+#endif
+    }
+
+#ifdef JACK_COMPILER_HAS_UNIX_SOCKETS
+    bool isSupported() {
+        return true;
+    }
+
+    bool isRunning(const string& socketPath) {
+        return static_cast<bool>(connectTo(socketPath));
+    }
+
+    int serve(const string& socketPath, const CompilationOptions& options, chrono::milliseconds idleTimeout, ostream& logStream) {
+        const auto address = addressOf(socketPath);
+
+        if(!address) {
+            logStream << "Invalid socket path \"" << socketPath << "\"." << endl;
+            return -1;
+        }
+
+        if(isRunning(socketPath)) {
+            logStream << "A compile-server is already listening on \"" << socketPath << "\"." << endl;
+            return -1;
+        }
+
+        // the socket of a server that has not stopped regularly is replaced
+        ::unlink(socketPath.c_str());
+
+        Socket listener{::socket(AF_UNIX, SOCK_STREAM, 0)};
+
+        // requests write files with the permissions of the server, so only its user may send them. The socket
+        // is created without permissions for others, so that they cannot connect before it is listening.
+        const auto previousMask = ::umask(S_IRWXG | S_IRWXO);
+        const auto bound = listener && ::bind(listener.get(), reinterpret_cast<const sockaddr*>(&*address), sizeof(*address)) == 0;
+        ::umask(previousMask);
+
+        if(!bound) {
+            logStream << "Could not create the socket \"" << socketPath << "\": " << std::strerror(errno) << endl;
+            return -1;
+        }
+
+        if(::chmod(socketPath.c_str(), S_IRUSR | S_IWUSR) != 0 || ::listen(listener.get(), SOMAXCONN) != 0) {
+            logStream << "Could not listen on the socket \"" << socketPath << "\": " << std::strerror(errno) << endl;
+            ::unlink(socketPath.c_str());
+            return -1;
+        }
+
+        logStream << "Listening on \"" << socketPath << "\"." << endl;
+
+        // a request that takes longer than the idle timeout would delay the shutdown
+        Server server{options, std::min(idleTimeout, MAX_REQUEST_TIME)};
+        ConnectionQueue queue;
+        vector<thread> threads;
+        const auto threadCount = options.jobs > 0 ? options.jobs : TaskScheduler::defaultJobCount();
+
+        for(size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&server, &queue] {
+                while(const auto connection = queue.pop()) {
+                    server.serve(*connection);
+                    ::close(*connection);
+                    queue.finish();
+                }
+            });
+        }
+
+        const auto pollTimeout = std::min(idleTimeout, chrono::milliseconds{chrono::seconds{1}});
+
+        while(!queue.isIdle(idleTimeout)) {
+            pollfd listenerPoll{listener.get(), POLLIN, 0};
+
+            if(::poll(&listenerPoll, 1, static_cast<int>(pollTimeout.count())) > 0) {
+                if(const auto connection = ::accept(listener.get(), nullptr, nullptr); connection != -1) {
+                    queue.touch();
+                    queue.push(connection);
+                }
+            }
+        }
+
+        queue.close();
+
+        for(auto& workerThread : threads) {
+            workerThread.join();
+        }
+
+        ::unlink(socketPath.c_str());
+        logStream << "Stopped after " << idleTimeout.count() << " ms without requests (" << server.requests() 
+                  << (server.requests() == 1 ? " request" : " requests") << " served)." << endl;
+
+        return 0;
+    }
+
+    int request(const string& socketPath, const string& inputPathName, const CompilationOptions& options, ostream& reportStream) {
+        const auto connection = connectTo(socketPath);
+
+        if(!connection) {
+            reportStream << "Could not connect to a compile-server on \"" << socketPath << "\"." << endl;
+            return -1;
+        }
+
+        // the server runs in another working directory
+        const auto absolutePathName = [] (const string& pathName) {
+            std::error_code error;
+            const auto absolutePath = fs::absolute(pathName, error);
+            return error ? pathName : absolutePath.string();
+        };
+
+        auto requestOptions = options;
+
+        if(!requestOptions.cacheDirectory.empty()) {
+            requestOptions.cacheDirectory = absolutePathName(options.cacheDirectory);
+        }
+
+        const auto requestPathName = absolutePathName(inputPathName);
+
+        // the request consists of lines
+        if(requestPathName.find('\n') != string::npos || requestOptions.cacheDirectory.find('\n') != string::npos) {
+            reportStream << "The compile-server cannot compile paths that contain line breaks." << endl;
+            return -1;
+        }
+
+        if(!sendAll(connection.get(), encodeRequest(requestPathName, requestOptions)) ||
+           ::shutdown(connection.get(), SHUT_WR) != 0) {
+            reportStream << "Could not send the compile-request." << endl;
+            return -1;
+        }
+
+        // the response is the status of the compilation followed by its report
+        const auto response = receive(connection.get(), {}, string::npos - 1);
+        const auto statusEnd = response.find('\n');
+        int status{};
+
+        if(statusEnd == string::npos || !parseValue(response.substr(0, statusEnd), status)) {
+            reportStream << "The compile-server has not sent a valid response." << endl;
+            return -1;
+        }
+
+        reportStream << response.substr(statusEnd + 1) << std::flush;
+        return status;
+    }
+#else
+    bool isSupported() {
+        return false;
+    }
+
+    bool isRunning(const string&) {
+        return false;
+    }
+
+    int serve(const string&, const CompilationOptions&, chrono::milliseconds, ostream& logStream) {
+        logStream << "The compile-server requires Unix domain sockets, which this platform does not support." << endl;
+        return -1;
+    }
+
+    int request(const string&, const string&, const CompilationOptions&, ostream& reportStream) {
+        reportStream << "The compile-server requires Unix domain sockets, which this platform does not support." << endl;
+        return -1;
+    }
+#endif
+}
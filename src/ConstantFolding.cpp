@@ -0,0 +1,79 @@
+#include "ConstantFolding.h"
+
+using std::optional;
+using std::nullopt;
+
+namespace JackCompiler::ConstantFolding {
+    namespace {
+        constexpr int MIN_VALUE = -32768;
+
+        constexpr int wrap(int value) {
+            value &= 0xFFFF;
+            return value >= 0x8000 ? value - 0x10000 : value;
+        }
+
+        constexpr int fromBool(bool value) {
+            return value ? TRUE_VALUE : FALSE_VALUE;
+        }
+    }
+
+    optional<int> valueOf(const Ast::Expression& expression) {
+        if(const auto* intConstant = expression.as<Ast::IntConstant>()) {
+            return intConstant->value;
+        }
+
+        if(const auto* keywordConstant = expression.as<Ast::KeywordConstant>()) {
+            switch(keywordConstant->keyword) {
+                case Tokenizer::KeyWordType::TRUE:
+                    return TRUE_VALUE;
+                case Tokenizer::KeyWordType::FALSE:
+                case Tokenizer::KeyWordType::NULL_:
+                    return FALSE_VALUE;
+                default:
+                    break;
+            }
+        }
+
+        return nullopt;
+    }
+
+    int evaluate(char op, int operand) {
+        return wrap(op == '-' ? -operand : ~operand);
+    }
+
+    optional<int> evaluate(char op, int left, int right) {
+        switch(op) {
+            case '+':
+                return wrap(left + right);
+            case '-':
+                return wrap(left - right);
+            case '*':
+                return wrap(left * right);
+            case '/':
+                // Math.divide reports division by zero at runtime and divides absolute values,
+                // which does not work for the smallest value
+                if(right == 0 || left == MIN_VALUE || right == MIN_VALUE) {
+                    return nullopt;
+                }
+
+                return wrap(left / right);
+            case '&':
+                return wrap(left & right);
+            case '|':
+                return wrap(left | right);
+            case '<':
+                return fromBool(left < right);
+            case '>':
+                return fromBool(left > right);
+            case '=':
+                return fromBool(left == right);
+            default:
+                return nullopt;
+        }
+    }
+
+    int instructionCount(const Ast::Expression& expression) {
+        // negative values (including true) are pushed as "push constant ~value; not"
+        return *valueOf(expression) < 0 ? 2 : 1;
+    }
+}
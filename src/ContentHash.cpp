@@ -0,0 +1,93 @@
+#include "ContentHash.h"
+#include <charconv>
+#include <sstream>
+
+using std::optional;
+using std::string;
+using std::string_view;
+
+#ifndef JACK_COMPILER_VERSION
+#define JACK_COMPILER_VERSION "unknown"
+#endif
+
+namespace JackCompiler::ContentHash {
+    namespace {
+        constexpr Hash FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr Hash FNV_PRIME = 1099511628211ull;
+        constexpr size_t HASH_DIGITS = 16;
+
+        Hash combine(Hash hash, string_view bytes) {
+            for(const auto byte : bytes) {
+                hash = (hash ^ static_cast<unsigned char>(byte)) * FNV_PRIME;
+            }
+
+            return hash;
+        }
+    }
+
+    Hash of(string_view bytes) {
+        return combine(FNV_OFFSET_BASIS, bytes);
+    }
+
+    Hash of(const TokenBuffer& tokenBuffer) {
+        auto hash = FNV_OFFSET_BASIS;
+
+        for(size_t i = 0; i < tokenBuffer.size(); ++i) {
+            // tokens are separated by a character that cannot occur within a token
+            hash = combine(hash, tokenBuffer.text(i));
+            hash = combine(hash, string_view{"\n", 1});
+        }
+
+        // a buffer whose lexing stopped early must not hash like its valid prefix
+        if(const auto* error = tokenBuffer.error()) {
+            hash = combine(hash, error->what());
+        }
+
+        return hash;
+    }
+
+    Hash of(const CompilationOptions& options) {
+        // every option that changes the generated code has to be listed
+        std::ostringstream configuration;
+        configuration << "jack-compiler " << JACK_COMPILER_VERSION
+                      << " ast=" << options.buildAst
+                      << " peephole=" << options.peephole
+                      << " fold-constants=" << options.foldConstants
+                      << " reduce-strength=" << options.reduceStrength
+                      << " pool-strings=" << options.poolStrings
+                      << " eliminate-dead-code=" << options.eliminateDeadCode
+                      << " inline=" << options.inlineThreshold
+                      << " eliminate-dead-subroutines=" << options.eliminateDeadSubroutines
+                      << " compact-control-flow=" << options.compactControlFlow
+                      << " optimize-array-access=" << options.optimizeArrayAccess
+                      << " eliminate-common-subexpressions=" << options.eliminateCommonSubexpressions;
+
+        return of(configuration.str());
+    }
+
+    string toString(Hash hash) {
+        string digits(HASH_DIGITS, '0');
+
+        for(auto digit = digits.rbegin(); digit != digits.rend() && hash != 0; ++digit, hash >>= 4) {
+            *digit = "0123456789abcdef"[hash & 0xf];
+        }
+
+        return digits;
+    }
+
+    optional<Hash> fromString(string_view digits) {
+        Hash hash{};
+
+        if(digits.size() != HASH_DIGITS) {
+            return {};
+        }
+
+        const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), hash, 16);
+
+        if(error != std::errc{} || end != digits.data() + digits.size()) {
+            return {};
+        }
+
+        return hash;
+    }
+}
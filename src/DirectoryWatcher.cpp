@@ -0,0 +1,119 @@
+#include "DirectoryWatcher.h"
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#define JACK_COMPILER_HAS_INOTIFY
+#endif
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+namespace fs = std::filesystem;
+namespace chrono = std::chrono;
+
+namespace JackCompiler {
+#ifdef JACK_COMPILER_HAS_INOTIFY
+    namespace {
+        // editors either write files in place or move a temporary file over them
+        constexpr uint32_t WATCHED_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+
+        /**
+         * \brief Waits until events can be read.
+         * \return False if the timeout has expired
+         */
+        bool waitForEvents(int fileDescriptor, chrono::milliseconds timeout) {
+            pollfd eventPoll{fileDescriptor, POLLIN, 0};
+            int result;
+
+            do {
+                result = ::poll(&eventPoll, 1, static_cast<int>(timeout.count()));
+            } while(result < 0 && errno == EINTR);
+
+            return result > 0;
+        }
+
+        void readEvents(int fileDescriptor, vector<string>& fileNames) {
+            alignas(inotify_event) char buffer[16 * 1024];
+
+            while(true) {
+                const auto length = ::read(fileDescriptor, buffer, sizeof(buffer));
+
+                if(length <= 0) {
+                    // the descriptor is non-blocking, so reading stops once all events have been read
+                    return;
+                }
+
+                for(ssize_t offset = 0; offset < length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+
+                    if(event->len > 0) {
+                        fileNames.emplace_back(event->name);
+                    }
+
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+        }
+    }
+
+    bool DirectoryWatcher::isSupported() {
+        return true;
+    }
+
+    DirectoryWatcher::DirectoryWatcher(const fs::path& directoryPath) 
+        : fileDescriptor_{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)} {
+        if(fileDescriptor_ == -1 || ::inotify_add_watch(fileDescriptor_, directoryPath.c_str(), WATCHED_EVENTS) == -1) {
+            const string reason{std::strerror(errno)};
+
+            if(fileDescriptor_ != -1) {
+                ::close(fileDescriptor_);
+            }
+
+            throw runtime_error{"Could not watch the directory " + directoryPath.string() + ": " + reason};
+        }
+    }
+
+    DirectoryWatcher::~DirectoryWatcher() {
+        ::close(fileDescriptor_);
+    }
+
+    DirectoryWatcher::Changes DirectoryWatcher::waitForChanges(chrono::milliseconds timeout, chrono::milliseconds debounce) {
+        Changes changes;
+
+        if(!waitForEvents(fileDescriptor_, timeout)) {
+            return changes;
+        }
+
+        changes.firstChange = chrono::steady_clock::now();
+
+        do {
+            readEvents(fileDescriptor_, changes.fileNames);
+        } while(waitForEvents(fileDescriptor_, debounce));
+
+        std::sort(changes.fileNames.begin(), changes.fileNames.end());
+        changes.fileNames.erase(std::unique(changes.fileNames.begin(), changes.fileNames.end()), changes.fileNames.end());
+
+        return changes;
+    }
+#else
+    bool DirectoryWatcher::isSupported() {
+        return false;
+    }
+
+    DirectoryWatcher::DirectoryWatcher(const fs::path&) {
+        throw runtime_error{"Watching directories requires inotify, which this platform does not support."};
+    }
+
+    DirectoryWatcher::~DirectoryWatcher() = default;
+
+    DirectoryWatcher::Changes DirectoryWatcher::waitForChanges(chrono::milliseconds, chrono::milliseconds) {
+        return {};
+    }
+#endif
+}
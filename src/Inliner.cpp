@@ -0,0 +1,111 @@
+#include "Inliner.h"
+
+using std::vector;
+using std::string_view;
+
+namespace JackCompiler {
+    namespace {
+        struct BodyProperties {
+            size_t size{};
+            size_t returns{};
+            bool containsCalls{};
+            bool containsStrings{};
+            bool accessesArrays{};
+            bool accessesStatics{};
+        };
+
+        void countStatements(const Ast::List<const Ast::Statement*>& statements, BodyProperties& properties) {
+            for(const auto* statement : statements) {
+                ++properties.size;
+
+                if(const auto* let = statement->as<Ast::LetStatement>()) {
+                    properties.accessesArrays |= let->index != nullptr;
+                    properties.accessesStatics |= let->target->segment == VMWriter::Segment::STATIC;
+                }
+                else if(const auto* ifStatement = statement->as<Ast::IfStatement>()) {
+                    countStatements(ifStatement->thenStatements, properties);
+                    countStatements(ifStatement->elseStatements, properties);
+                }
+                else if(const auto* whileStatement = statement->as<Ast::WhileStatement>()) {
+                    countStatements(whileStatement->statements, properties);
+                }
+                else if(statement->kind == Ast::Statement::Kind::RETURN) {
+                    ++properties.returns;
+                }
+            }
+        }
+
+        BodyProperties propertiesOf(const Ast::Subroutine& subroutine) {
+            BodyProperties properties;
+            countStatements(subroutine.statements, properties);
+
+            Ast::forEachExpression(subroutine.statements, [&properties] (const Ast::Expression& expression) {
+                ++properties.size;
+
+                switch(expression.kind) {
+                    case Ast::Expression::Kind::SUBROUTINE_CALL:
+                        properties.containsCalls = true;
+                        break;
+                    case Ast::Expression::Kind::STRING_CONST:
+                        properties.containsStrings = true;
+                        break;
+                    case Ast::Expression::Kind::ARRAY_ELEMENT:
+                        properties.accessesArrays = true;
+                        break;
+                    case Ast::Expression::Kind::VARIABLE:
+                        properties.accessesStatics |= expression.as<Ast::Variable>()->segment == VMWriter::Segment::STATIC;
+                        break;
+                    default:
+                        break;
+                }
+            });
+
+            return properties;
+        }
+    }
+
+    Inliner::Inliner(const vector<const Ast::Class*>& classes, size_t sizeThreshold) {
+        for(const auto* astClass : classes) {
+            for(const auto* subroutine : astClass->subroutines) {
+                if(subroutine->type == Tokenizer::KeyWordType::CONSTRUCTOR || subroutine->statements.empty() || 
+                   subroutine->statements[subroutine->statements.size() - 1]->kind != Ast::Statement::Kind::RETURN) {
+                    continue;
+                }
+
+                const auto properties = propertiesOf(*subroutine);
+
+                if(properties.size > sizeThreshold || properties.returns != 1 || properties.containsCalls || 
+                   properties.containsStrings || 
+                   (properties.accessesArrays && subroutine->type == Tokenizer::KeyWordType::METHOD)) {
+                    continue;
+                }
+
+                candidates_[astClass->name].emplace(subroutine->name, Candidate{astClass, subroutine, properties.accessesStatics});
+            }
+        }
+    }
+
+    const Inliner::Candidate* Inliner::find(const Ast::SubroutineCall& call, string_view callerClassName) const {
+        const auto classIt = candidates_.find(call.className);
+
+        if(classIt == candidates_.end()) {
+            return nullptr;
+        }
+
+        const auto it = classIt->second.find(call.subroutineName);
+
+        if(it == classIt->second.end() || (it->second.accessesStatics && call.className != callerClassName)) {
+            return nullptr;
+        }
+
+        // the call must match the kind of the subroutine (e.g. a method that is called like a function)
+        const bool isMethod = it->second.subroutine->type == Tokenizer::KeyWordType::METHOD;
+
+        if(isMethod != (call.receiver != nullptr) || 
+           static_cast<int>(call.arguments.size()) + (isMethod ? 1 : 0) != it->second.subroutine->nArgs) {
+            return nullptr;
+        }
+
+        return &it->second;
+    }
+}
@@ -1,94 +1,696 @@
 #include "JackCompiler.h"
+#include "BuildManifest.h"
+#include "CallGraph.h"
 #include "CompilationEngine.h"
+#include "CompileCache.h"
+#include "ContentHash.h"
+#include "DirectoryWatcher.h"
+#include "Inliner.h"
+#include "MappedFile.h"
+#include "TaskScheduler.h"
+#include "TokenBuffer.h"
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <vector>
 
 using std::string;
 using std::cout;
+using std::cerr;
+using std::istream;
+using std::ostream;
 using std::endl;
-using std::ifstream;
 using std::ofstream;
 using std::runtime_error;
+using std::unique_ptr;
+using std::make_unique;
+using std::optional;
+using std::vector;
+using std::string_view;
 
 namespace fs = std::filesystem;
+namespace chrono = std::chrono;
 
 namespace JackCompiler {
-    int compile(const string& inputPathName) {
-        const fs::path inputPath{inputPathName};
+    namespace {
+        // editors save a file within a few milliseconds (e.g. by writing a temporary file and renaming it)
+        constexpr chrono::milliseconds WATCH_DEBOUNCE_TIME{5};
+        // how often watching checks if it has to stop
+        constexpr chrono::milliseconds WATCH_STOP_INTERVAL{100};
 
-        if(!fs::is_directory(inputPath) && inputPath.extension() != ".jack") {
-            cout << "Invalid argument: Must be either a path to a *.jack file "
-                    "or a path to a directory (containing *.jack files)." << endl;
-            return -1;
+        void printStatistics(ostream& outputStream, const OptimizationStatistics& statistics) {
+            if(!statistics.empty()) {
+                statistics.print(outputStream);
+                outputStream.flush();
+            }
         }
 
-        if(fs::is_directory(inputPath)) {
-            size_t validFiles{};
+        /**
+         * \brief The errors found in all compiled files, which are reported at once after the compilation.
+         */
+        class Diagnostics {
+        public:
+            explicit Diagnostics(size_t maxErrors) : maxErrors_{maxErrors} {}
 
-            for(const auto& item : fs::directory_iterator(inputPath)) {
-                if(item.path().extension() == ".jack") {
-                    if(ifstream inputFile(item.path()); inputFile) {
-                        fs::path outputPath{item.path()};
-                        outputPath.replace_extension(".vm");
-
-                        if(ofstream outputFile{outputPath}) {
-                            CompilationEngine engine{inputFile, outputFile};
-
-                            try {
-                                engine.compileClass();
-                            }
-                            catch(const runtime_error& e) {
-                                cout << "Compilation error in file " << item.path().filename() 
-                                     << ": " << e.what() << endl;
-                                return -1;
-                            }
-                        }
-                        else {
-                            cout << "Could not create output file " << outputPath << "." << endl;
-                            return -1;
-                        }
+            /**
+             * \brief Adds the errors of a file after its compilation has failed (up to the maximum number of errors).
+             * \param fileName 
+             * \param errors The errors found by the compilation engine (if any has been created)
+             * \param error The error that stopped the compilation
+             */
+            void add(string_view fileName, const vector<CompilationError>& errors, const runtime_error& error) {
+                for(const auto& compilationError : errors) {
+                    addEntry({string{fileName}, compilationError.line(), compilationError.message()});
+                }
+
+                // errors that do not refer to a line (e.g. of a source that is too large) are not recorded by the
+                // compilation engine, neither are errors that stop the compilation before the class is processed
+                if(dynamic_cast<const CompilationError*>(&error) == nullptr) {
+                    addEntry({string{fileName}, 0, error.what()});
+                }
+                else if(errors.empty()) {
+                    const auto& compilationError = static_cast<const CompilationError&>(error);
+                    addEntry({string{fileName}, compilationError.line(), compilationError.message()});
+                }
+            }
+
+            /**
+             * \brief Adds the errors of other diagnostics (up to the maximum number of errors), the errors of
+             * files compiled in parallel are merged in the order of the files.
+             * \param other 
+             */
+            void merge(const Diagnostics& other) {
+                for(const auto& entry : other.entries_) {
+                    addEntry(entry);
+                }
+            }
+
+            bool empty() const { return entries_.empty(); }
+
+            bool limitReached() const { return maxErrors_ > 0 && entries_.size() >= maxErrors_; }
+
+            /**
+             * \brief Prints all errors sorted by file (and by line within each file).
+             * \param outputStream 
+             */
+            void print(ostream& outputStream) {
+                std::stable_sort(entries_.begin(), entries_.end(), [] (const Entry& lhs, const Entry& rhs) {
+                    return lhs.fileName < rhs.fileName;
+                });
+
+                size_t files{};
+
+                for(size_t i = 0; i < entries_.size(); ++i) {
+                    const auto& entry = entries_[i];
+
+                    if(i == 0 || entry.fileName != entries_[i - 1].fileName) {
+                        ++files;
                     }
-                    else {
-                        cout << "Could not open file " << item.path().filename() << "." << endl;
-                        return -1;
+
+                    outputStream << entry.fileName;
+
+                    if(entry.line > 0) {
+                        outputStream << ':' << entry.line;
                     }
 
-                    ++validFiles;
+                    outputStream << ": error: " << entry.message << '\n';
+                }
+
+                outputStream << entries_.size() << (entries_.size() == 1 ? " error" : " errors") << " in " << files 
+                             << (files == 1 ? " file" : " files") << '.';
+
+                if(limitReached()) {
+                    outputStream << " The compilation stopped after " << maxErrors_ << " errors.";
                 }
+
+                outputStream << endl;
             }
 
-            if(validFiles == 0) {
-                cout << "The directory " << inputPath << " does not contain any *.jack files." << endl;
-                return -1;
+        private:
+            struct Entry {
+                string fileName;
+                size_t line;
+                string message;
+            };
+
+            size_t maxErrors_;
+            vector<Entry> entries_;
+
+            void addEntry(Entry entry) {
+                if(!limitReached()) {
+                    entries_.push_back(std::move(entry));
+                }
+            }
+        };
+
+        /**
+         * \brief The outcome of compiling a single file. Files may be compiled in parallel, so nothing is
+         * printed until the results of all files are merged.
+         */
+        struct FileResult {
+            explicit FileResult(size_t maxErrors) : diagnostics{maxErrors} {}
+
+            // describes why the file could not be read or written, which stops the whole compilation
+            string failure;
+            OptimizationStatistics statistics;
+            Diagnostics diagnostics;
+            // the manifest entry of a file that has been compiled incrementally without errors
+            optional<BuildManifest::Entry> entry;
+            // whether an incremental compilation has skipped the file
+            bool upToDate{};
+        };
+
+        /**
+         * \brief Merges the results of all files in the order of the files, so that the report does not depend
+         * on the order in which the files have been compiled.
+         * \return False if a file could not be read or written (the failure has been reported)
+         */
+        bool mergeResults(const vector<FileResult>& results, OptimizationStatistics& statistics, Diagnostics& diagnostics, 
+            ostream& reportStream) {
+            for(const auto& result : results) {
+                if(!result.failure.empty()) {
+                    reportStream << result.failure << endl;
+                    return false;
+                }
+
+                statistics.merge(result.statistics);
+                diagnostics.merge(result.diagnostics);
+            }
+
+            return true;
+        }
+
+        string describeFailure(string_view description, const fs::path& path) {
+            std::ostringstream failure;
+            failure << description << ' ' << path << '.';
+            return failure.str();
+        }
+
+        vector<fs::path> findInputPaths(const fs::path& directoryPath) {
+            vector<fs::path> inputPaths;
+
+            for(const auto& item : fs::directory_iterator(directoryPath)) {
+                if(item.path().extension() == ".jack") {
+                    inputPaths.push_back(item.path());
+                }
+            }
+
+            // the order of the directory entries is unspecified
+            std::sort(inputPaths.begin(), inputPaths.end());
+            return inputPaths;
+        }
+
+        /**
+         * \brief Gets the order in which files are compiled in parallel: The largest files are compiled
+         * first, so that no thread starts a large file when the others are almost done.
+         */
+        vector<size_t> scheduleBySize(const vector<fs::path>& inputPaths) {
+            vector<std::uintmax_t> sizes;
+            vector<size_t> order(inputPaths.size());
+
+            for(const auto& inputPath : inputPaths) {
+                std::error_code error;
+                const auto size = fs::file_size(inputPath, error);
+                sizes.push_back(error ? 0 : size);
             }
+
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&sizes] (size_t lhs, size_t rhs) { return sizes[lhs] > sizes[rhs]; });
+
+            return order;
         }
-        else if(ifstream inputFile{inputPath}) {
+
+        /**
+         * \brief Checks if the source of a file is unchanged without reading it.
+         */
+        bool isSourceUnchanged(const BuildManifest::Entry& entry, const fs::path& inputPath) {
+            std::error_code error;
+            const auto size = fs::file_size(inputPath, error);
+
+            return !error && size == entry.sourceSize && entry.sourceTime != 0 && 
+                BuildManifest::modificationTimeOf(inputPath) == entry.sourceTime;
+        }
+
+        /**
+         * \brief Compiles a single file into a .vm file with the same name. If a manifest is provided, the file
+         * is skipped if neither its tokens nor its output have changed since it has been compiled the last time.
+         * If a cache is provided, the output is taken from the cache if it contains the source.
+         */
+        FileResult compileFile(const fs::path& inputPath, const CompilationOptions& options, const BuildManifest* manifest,
+            CompileCache* cache) {
+            FileResult result{options.maxErrors};
             fs::path outputPath{inputPath};
             outputPath.replace_extension(".vm");
 
-            if(ofstream outputFile{outputPath}) {
-                CompilationEngine engine{inputFile, outputFile};
+            const auto fileName = inputPath.filename().string();
+            const auto* previousEntry = manifest != nullptr ? manifest->find(fileName) : nullptr;
+
+            if(previousEntry != nullptr && isSourceUnchanged(*previousEntry, inputPath) && 
+               BuildManifest::isOutputUpToDate(*previousEntry, outputPath)) {
+                result.entry = *previousEntry;
+                result.entry->outputTime = BuildManifest::modificationTimeOf(outputPath);
+                result.upToDate = true;
+                return result;
+            }
+
+            const MappedFile inputFile{inputPath};
+
+            if(!inputFile) {
+                result.failure = describeFailure("Could not open file", inputPath.filename());
+                return result;
+            }
+
+            // incremental and cached compilations only write the output once it is known to be complete
+            const bool bufferOutput = manifest != nullptr || cache != nullptr;
+            ofstream outputFile;
+            std::ostringstream bufferedOutput;
+
+            if(!bufferOutput) {
+                outputFile.open(outputPath);
+
+                if(!outputFile) {
+                    result.failure = describeFailure("Could not create output file", outputPath);
+                    return result;
+                }
+            }
+
+            optional<TokenBuffer> tokenBuffer;
+            optional<CompilationEngine> engine;
+
+            try {
+                if(!bufferOutput) {
+                    tokenBuffer.emplace(inputFile.data());
+                    engine.emplace(*tokenBuffer, outputFile, options);
+                    engine->compileClass();
+                    result.statistics.merge(engine->statistics());
+                    return result;
+                }
+
+                BuildManifest::Entry entry;
+                entry.sourceSize = inputFile.data().size();
+                entry.sourceTime = BuildManifest::modificationTimeOf(inputPath);
+                entry.sourceHash = ContentHash::of(inputFile.data());
+
+                if(manifest != nullptr) {
+                    tokenBuffer.emplace(inputFile.data());
+                    entry.tokenHash = ContentHash::of(*tokenBuffer);
+
+                    // changes of whitespace and comments do not change the output
+                    if(previousEntry != nullptr && previousEntry->tokenHash == entry.tokenHash && 
+                       BuildManifest::isOutputUpToDate(*previousEntry, outputPath)) {
+                        entry.outputSize = previousEntry->outputSize;
+                        entry.outputHash = previousEntry->outputHash;
+                        entry.outputTime = BuildManifest::modificationTimeOf(outputPath);
+                        result.entry = entry;
+                        result.upToDate = true;
+                        return result;
+                    }
+                }
+
+                const auto configuration = cache != nullptr ? ContentHash::of(options) : ContentHash::Hash{};
+                auto output = cache != nullptr ? cache->load(entry.sourceHash, configuration) : std::nullopt;
+
+                if(!output) {
+                    if(!tokenBuffer) {
+                        tokenBuffer.emplace(inputFile.data());
+                    }
+
+                    engine.emplace(*tokenBuffer, bufferedOutput, options);
+                    engine->compileClass();
+                    result.statistics.merge(engine->statistics());
+                    output = bufferedOutput.str();
+
+                    if(cache != nullptr) {
+                        cache->store(entry.sourceHash, configuration, *output);
+                    }
+                }
+
+                outputFile.open(outputPath);
+
+                if(!outputFile || !outputFile.write(output->data(), static_cast<std::streamsize>(output->size())) || !outputFile.flush()) {
+                    result.failure = describeFailure("Could not create output file", outputPath);
+                    return result;
+                }
+
+                if(manifest != nullptr) {
+                    outputFile.close();
+                    entry.outputSize = output->size();
+                    entry.outputHash = ContentHash::of(*output);
+                    entry.outputTime = BuildManifest::modificationTimeOf(outputPath);
+                    result.entry = entry;
+                }
+            }
+            catch(const runtime_error& e) {
+                result.diagnostics.add(fileName, engine ? engine->errors() : vector<CompilationError>{}, e);
+            }
+
+            return result;
+        }
+
+        /**
+         * \brief Records the results of an incremental compilation in the manifest and writes it.
+         */
+        void updateManifest(BuildManifest& manifest, const fs::path& directoryPath, const vector<fs::path>& inputPaths, 
+            const vector<FileResult>& results, ostream& reportStream) {
+            size_t upToDateFiles{};
+
+            for(size_t i = 0; i < results.size(); ++i) {
+                const auto fileName = inputPaths[i].filename().string();
+
+                if(results[i].entry) {
+                    manifest.set(fileName, *results[i].entry);
+                }
+                else {
+                    manifest.erase(fileName);
+                }
+
+                upToDateFiles += results[i].upToDate ? 1 : 0;
+            }
+
+            if(!manifest.save(directoryPath)) {
+                reportStream << "Could not write the build manifest " << directoryPath / BuildManifest::FILE_NAME << "." << endl;
+            }
+
+            reportStream << upToDateFiles << " of " << results.size() << (results.size() == 1 ? " file is" : " files are") << " up to date." << endl;
+        }
+
+        /**
+         * \brief A file of a program that is compiled as a whole. All files are parsed before
+         * code is generated for any of them, and no output is written before the whole program is compiled.
+         */
+        struct ProgramFile {
+            fs::path inputPath;
+            MappedFile inputFile;
+            optional<TokenBuffer> tokenBuffer;
+            std::ostringstream output;
+            optional<CompilationEngine> engine;
+            const Ast::Class* astClass{};
+
+            explicit ProgramFile(const fs::path& path) : inputPath{path}, inputFile{path} {}
+        };
+
+        int compileProgram(const vector<fs::path>& inputPaths, const CompilationOptions& options, 
+            OptimizationStatistics& statistics, Diagnostics& diagnostics, ostream& reportStream) {
+            const auto order = scheduleBySize(inputPaths);
+            vector<unique_ptr<ProgramFile>> files(inputPaths.size());
+            vector<FileResult> results(inputPaths.size(), FileResult{options.maxErrors});
+
+            TaskScheduler::run(order.size(), options.jobs, [&] (size_t task) {
+                const auto i = order[task];
+                auto& file = *(files[i] = make_unique<ProgramFile>(inputPaths[i]));
+                auto& result = results[i];
+
+                if(!file.inputFile) {
+                    result.failure = describeFailure("Could not open file", file.inputPath.filename());
+                    return;
+                }
 
                 try {
-                    engine.compileClass();
+                    file.tokenBuffer.emplace(file.inputFile.data());
+                    file.engine.emplace(*file.tokenBuffer, file.output, options);
+                    file.astClass = &file.engine->parseClass();
                 }
                 catch(const runtime_error& e) {
-                    cout << "Compilation error: " << e.what() << endl;
+                    result.diagnostics.add(file.inputPath.filename().string(), 
+                        file.engine ? file.engine->errors() : vector<CompilationError>{}, e);
+                }
+            });
+
+            // all files are parsed to report as many errors as possible, but code is only generated for valid programs
+            if(!mergeResults(results, statistics, diagnostics, reportStream) || !diagnostics.empty()) {
+                return -1;
+            }
+
+            vector<const Ast::Class*> classes;
+
+            for(const auto& file : files) {
+                classes.push_back(file->astClass);
+            }
+
+            const Inliner inliner{classes, options.inlineThreshold};
+            const auto* usedInliner = options.inlineThreshold > 0 ? &inliner : nullptr;
+            optional<CallGraph> callGraph;
+
+            if(options.eliminateDeadSubroutines) {
+                callGraph.emplace(classes, usedInliner);
+                callGraph->printReport(reportStream);
+            }
+
+            // the inliner, the call graph and the trees of all classes are only read while code is generated
+            results.assign(inputPaths.size(), FileResult{options.maxErrors});
+
+            TaskScheduler::run(order.size(), options.jobs, [&] (size_t task) {
+                const auto i = order[task];
+                auto& file = *files[i];
+
+                try {
+                    file.engine->lowerClass(*file.astClass, usedInliner, callGraph ? &*callGraph : nullptr);
+                    results[i].statistics.merge(file.engine->statistics());
+                }
+                catch(const runtime_error& e) {
+                    results[i].diagnostics.add(file.inputPath.filename().string(), file.engine->errors(), e);
+                }
+            });
+
+            if(!mergeResults(results, statistics, diagnostics, reportStream) || !diagnostics.empty()) {
+                return -1;
+            }
+
+            // the outputs of a program with errors are left unchanged
+            for(const auto& file : files) {
+                fs::path outputPath{file->inputPath};
+                outputPath.replace_extension(".vm");
+
+                const auto output = file->output.str();
+                ofstream outputFile{outputPath};
+
+                if(!outputFile || !outputFile.write(output.data(), static_cast<std::streamsize>(output.size())) || !outputFile.flush()) {
+                    reportStream << describeFailure("Could not create output file", outputPath) << endl;
                     return -1;
                 }
             }
-            else {
-                cout << "Could not create output file " << outputPath << '.' << endl;
+
+            return 0;
+        }
+    }
+
+    int compile(const string& inputPathName, const CompilationOptions& options) {
+        return compile(inputPathName, options, cout);
+    }
+
+    int compile(const string& inputPathName, const CompilationOptions& options, ostream& reportStream, CompileCache* sharedCache) {
+        const fs::path inputPath{inputPathName};
+        OptimizationStatistics statistics;
+        Diagnostics diagnostics{options.maxErrors};
+
+        if(!fs::is_directory(inputPath) && inputPath.extension() != ".jack") {
+            reportStream << "Invalid argument: Must be either a path to a *.jack file "
+                    "or a path to a directory (containing *.jack files)." << endl;
+            return -1;
+        }
+
+        // whole-program optimizations require all classes, so the whole program is parsed first
+        const bool wholeProgram = fs::is_directory(inputPath) && (options.inlineThreshold > 0 || options.eliminateDeadSubroutines);
+        optional<CompileCache> ownCache;
+        auto* cache = !wholeProgram ? sharedCache : nullptr;
+
+        if(cache == nullptr && !options.cacheDirectory.empty() && !wholeProgram) {
+            cache = &ownCache.emplace(options.cacheDirectory, options.cacheSize);
+        }
+
+        if(wholeProgram && (options.incremental || !options.cacheDirectory.empty())) {
+            reportStream << "Incremental compilation and the compile cache are not used with whole-program optimizations "
+                            "(inlining or dead subroutine elimination), all files are compiled." << endl;
+        }
+
+        if(fs::is_directory(inputPath)) {
+            const auto inputPaths = findInputPaths(inputPath);
+
+            if(inputPaths.empty()) {
+                reportStream << "The directory " << inputPath << " does not contain any *.jack files." << endl;
                 return -1;
             }
+
+            if(wholeProgram) {
+                if(compileProgram(inputPaths, options, statistics, diagnostics, reportStream) != 0 && diagnostics.empty()) {
+                    return -1;
+                }
+            }
+            else {
+                // every file has its own compilation engine, so the files are compiled independently
+                const auto order = scheduleBySize(inputPaths);
+                vector<FileResult> results(inputPaths.size(), FileResult{options.maxErrors});
+                const auto previousManifest = options.incremental ? 
+                    optional{BuildManifest::load(inputPath, ContentHash::of(options))} : std::nullopt;
+
+                TaskScheduler::run(order.size(), options.jobs, [&] (size_t task) {
+                    results[order[task]] = compileFile(inputPaths[order[task]], options, previousManifest ? &*previousManifest : nullptr, cache);
+                });
+
+                if(!mergeResults(results, statistics, diagnostics, reportStream)) {
+                    return -1;
+                }
+
+                if(options.incremental) {
+                    // files that have been removed from the directory are removed from the manifest
+                    BuildManifest manifest{ContentHash::of(options)};
+                    updateManifest(manifest, inputPath, inputPaths, results, reportStream);
+                }
+            }
         }
         else {
-            cout << "Could not open file " << inputPath.filename() << '.' << endl;
+            const auto directoryPath = inputPath.has_parent_path() ? inputPath.parent_path() : fs::path{"."};
+            auto manifest = options.incremental ? 
+                optional{BuildManifest::load(directoryPath, ContentHash::of(options))} : std::nullopt;
+            const vector<FileResult> results{compileFile(inputPath, options, manifest ? &*manifest : nullptr, cache)};
+
+            if(!mergeResults(results, statistics, diagnostics, reportStream)) {
+                return -1;
+            }
+
+            if(manifest) {
+                updateManifest(*manifest, directoryPath, {inputPath}, results, reportStream);
+            }
+        }
+
+        if(cache != nullptr && cache->misses() > 0) {
+            cache->evict();
+        }
+
+        // the hits and misses of a shared cache include the ones of other compilations
+        if(ownCache) {
+            reportStream << "Cache: " << ownCache->hits() << (ownCache->hits() == 1 ? " hit, " : " hits, ") 
+                         << ownCache->misses() << (ownCache->misses() == 1 ? " miss." : " misses.") << endl;
+        }
+
+        if(!diagnostics.empty()) {
+            diagnostics.print(reportStream);
+            return -1;
+        }
+
+        printStatistics(reportStream, statistics);
+        return 0;
+    }
+
+    int watch(const string& directoryPathName, const CompilationOptions& options, ostream& reportStream, 
+        const std::function<bool()>& stopRequested) {
+        const fs::path directoryPath{directoryPathName};
+
+        if(!fs::is_directory(directoryPath)) {
+            reportStream << "Invalid argument: Watching requires a path to a directory (containing *.jack files)." << endl;
+            return -1;
+        }
+
+        // the directory is watched before it is compiled, so that no change is missed
+        optional<DirectoryWatcher> watcher;
+
+        try {
+            watcher.emplace(directoryPath);
+        }
+        catch(const runtime_error& e) {
+            reportStream << e.what() << endl;
             return -1;
         }
 
+        compile(directoryPathName, options, reportStream);
+        reportStream << "Watching " << directoryPath << " for changes." << endl;
+
+        const bool wholeProgram = options.inlineThreshold > 0 || options.eliminateDeadSubroutines;
+
+        while(!stopRequested || !stopRequested()) {
+            const auto changes = watcher->waitForChanges(WATCH_STOP_INTERVAL, WATCH_DEBOUNCE_TIME);
+            vector<fs::path> changedPaths;
+
+            // the outputs (and manifests) written by the compilations are changes as well
+            for(const auto& fileName : changes.fileNames) {
+                if(const auto path = directoryPath / fileName; path.extension() == ".jack") {
+                    changedPaths.push_back(path);
+                }
+            }
+
+            if(changedPaths.empty()) {
+                continue;
+            }
+
+            vector<fs::path> compiledPaths;
+            int result = 0;
+
+            for(const auto& path : changedPaths) {
+                if(fs::exists(path)) {
+                    compiledPaths.push_back(path);
+
+                    if(!wholeProgram && compile(path.string(), options, reportStream) != 0) {
+                        result = -1;
+                    }
+                }
+                else {
+                    auto outputPath = path;
+                    std::error_code error;
+
+                    if(fs::remove(outputPath.replace_extension(".vm"), error)) {
+                        reportStream << "Removed " << outputPath.filename() << "." << endl;
+                    }
+                }
+            }
+
+            if(wholeProgram) {
+                result = compile(directoryPathName, options, reportStream);
+            }
+            else if(compiledPaths.empty()) {
+                continue;
+            }
+
+            const chrono::duration<double, std::milli> latency{chrono::steady_clock::now() - changes.firstChange};
+            std::ostringstream latencyText;
+            latencyText << std::fixed << std::setprecision(1) << latency.count();
+
+            reportStream << (result == 0 ? "Compiled " : "Failed to compile ");
+
+            if(wholeProgram) {
+                reportStream << directoryPath;
+            }
+            else if(compiledPaths.size() == 1) {
+                reportStream << compiledPaths.front().filename();
+            }
+            else {
+                reportStream << compiledPaths.size() << " files";
+            }
+
+            reportStream << " in " << latencyText.str() << " ms." << endl;
+        }
+
         return 0;
     }
 
+    int compile(istream& inputStream, ostream& outputStream, const CompilationOptions& options) {
+        optional<CompilationEngine> engine;
+
+        try {
+            engine.emplace(inputStream, outputStream, options);
+            engine->compileClass();
+
+            // the output-stream contains the compiled code, so the statistics are reported on stderr
+            printStatistics(cerr, engine->statistics());
+        }
+        catch(const runtime_error& e) {
+            Diagnostics diagnostics{options.maxErrors};
+            diagnostics.add("stdin", engine ? engine->errors() : vector<CompilationError>{}, e);
+            diagnostics.print(cerr);
+            return -1;
+        }
+
+        if(!outputStream.flush()) {
+            cerr << "Could not write the compilation output." << endl;
+            return -1;
+        }
+
+        return 0;
+    }
 }
@@ -0,0 +1,101 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JACK_COMPILER_HAS_MMAP
+#endif
+
+using std::string;
+using std::string_view;
+using std::ifstream;
+using std::istreambuf_iterator;
+
+namespace fs = std::filesystem;
+
+namespace JackCompiler {
+    MappedFile::MappedFile(const fs::path& path) {
+#ifdef JACK_COMPILER_HAS_MMAP
+        if(const auto fileDescriptor = ::open(path.c_str(), O_RDONLY); fileDescriptor != -1) {
+            struct stat fileStatus{};
+
+            if(::fstat(fileDescriptor, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode)) {
+                const auto fileSize = static_cast<size_t>(fileStatus.st_size);
+
+                if(fileSize == 0) {
+                    // empty files cannot be mapped
+                    isOpen_ = true;
+                }
+                else if(auto* address = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+                        address != MAP_FAILED) {
+                    ::madvise(address, fileSize, MADV_SEQUENTIAL);
+                    data_ = string_view{static_cast<const char*>(address), fileSize};
+                    isOpen_ = true;
+                    isMapped_ = true;
+                }
+            }
+
+            ::close(fileDescriptor);
+        }
+
+        if(isOpen_) {
+            return;
+        }
+#endif
+        if(ifstream inputFile{path, std::ios::binary}) {
+            fallbackBuffer_.assign(istreambuf_iterator<char>{inputFile}, istreambuf_iterator<char>{});
+            data_ = fallbackBuffer_;
+            isOpen_ = true;
+        }
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : data_{other.data_}, fallbackBuffer_{std::move(other.fallbackBuffer_)}, 
+          isOpen_{other.isOpen_}, isMapped_{other.isMapped_} {
+        if(!isMapped_) {
+            data_ = fallbackBuffer_;
+        }
+
+        other.data_ = {};
+        other.isOpen_ = false;
+        other.isMapped_ = false;
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if(this != &other) {
+            unmap();
+            data_ = other.data_;
+            fallbackBuffer_ = std::move(other.fallbackBuffer_);
+            isOpen_ = other.isOpen_;
+            isMapped_ = other.isMapped_;
+
+            if(!isMapped_) {
+                data_ = fallbackBuffer_;
+            }
+
+            other.data_ = {};
+            other.isOpen_ = false;
+            other.isMapped_ = false;
+        }
+
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    void MappedFile::unmap() noexcept {
+#ifdef JACK_COMPILER_HAS_MMAP
+        if(isMapped_) {
+            ::munmap(const_cast<char*>(data_.data()), data_.size());
+        }
+#endif
+        isMapped_ = false;
+    }
+}
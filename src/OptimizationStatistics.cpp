@@ -0,0 +1,59 @@
+#include "OptimizationStatistics.h"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+using std::string_view;
+using std::ostream;
+
+namespace JackCompiler {
+    void OptimizationStatistics::add(string_view name, size_t count, Unit unit) {
+        // there are only a few counters, so a linear search is sufficient
+        const auto it = std::find_if(counters_.begin(), counters_.end(), 
+            [name] (const auto& counter) { return counter.name == name; });
+
+        if(it != counters_.end()) {
+            it->count += count;
+        }
+        else {
+            counters_.push_back({name, count, unit});
+        }
+    }
+
+    void OptimizationStatistics::merge(const OptimizationStatistics& other) {
+        for(const auto& counter : other.counters_) {
+            add(counter.name, counter.count, counter.unit);
+        }
+    }
+
+    size_t OptimizationStatistics::count(string_view name) const {
+        const auto it = std::find_if(counters_.cbegin(), counters_.cend(), 
+            [name] (const auto& counter) { return counter.name == name; });
+
+        return it != counters_.cend() ? it->count : 0;
+    }
+
+    void OptimizationStatistics::print(ostream& outputStream) const {
+        constexpr std::array<std::pair<Unit, string_view>, 2> HEADINGS{{
+            {Unit::REMOVED_INSTRUCTIONS, "Optimizations (removed instructions):"},
+            {Unit::OCCURRENCES, "Optimizations (occurrences):"}
+        }};
+
+        for(const auto& [unit, heading] : HEADINGS) {
+            bool headingPrinted{};
+
+            for(const auto& counter : counters_) {
+                if(counter.unit != unit) {
+                    continue;
+                }
+
+                if(!headingPrinted) {
+                    outputStream << heading << '\n';
+                    headingPrinted = true;
+                }
+
+                outputStream << "  " << counter.name << ": " << counter.count << '\n';
+            }
+        }
+    }
+}
@@ -0,0 +1,185 @@
+#include "PeepholeOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <unordered_map>
+
+using std::array;
+using std::string_view;
+using std::vector;
+using std::unordered_map;
+
+namespace JackCompiler::PeepholeOptimizer {
+    namespace {
+        using Instruction = VMWriter::Instruction;
+        using Type = VMWriter::Instruction::Type;
+        using Segment = VMWriter::Segment;
+        using Command = VMWriter::Command;
+
+        /**
+         * A rule matches a window of consecutive instructions and rewrites it in place. The rewrite
+         * returns the number of instructions the window consists of afterwards.
+         */
+        struct Rule {
+            string_view name;
+            size_t windowSize;
+            bool (*matches)(const Instruction* window);
+            size_t (*rewrite)(Instruction* window);
+        };
+
+        bool isPush(const Instruction& instruction, Segment segment) {
+            return instruction.type == Type::PUSH && instruction.segment == segment;
+        }
+
+        bool isArithmetic(const Instruction& instruction, Command command) {
+            return instruction.type == Type::ARITHMETIC && instruction.command == command;
+        }
+
+        bool endsControlFlow(const Instruction& instruction) {
+            return instruction.type == Type::GOTO || instruction.type == Type::RETURN;
+        }
+
+        const array<Rule, 7> RULES{{
+            {
+                // push x; pop x
+                "push/pop of the same location", 2,
+                [] (const Instruction* window) {
+                    return window[0].type == Type::PUSH && window[1].type == Type::POP &&
+                        window[0].segment == window[1].segment && window[0].value == window[1].value;
+                },
+                [] (Instruction*) -> size_t { return 0; }
+            },
+            {
+                // not; not OR neg; neg
+                "double negation", 2,
+                [] (const Instruction* window) {
+                    return (isArithmetic(window[0], Command::NOT) && isArithmetic(window[1], Command::NOT)) ||
+                        (isArithmetic(window[0], Command::NEG) && isArithmetic(window[1], Command::NEG));
+                },
+                [] (Instruction*) -> size_t { return 0; }
+            },
+            {
+                // push constant 0; if-goto L (never jumps)
+                "never taken conditional jump", 2,
+                [] (const Instruction* window) {
+                    return isPush(window[0], Segment::CONST) && window[0].value == 0 && window[1].type == Type::IF_GOTO;
+                },
+                [] (Instruction*) -> size_t { return 0; }
+            },
+            {
+                // push constant k (k != 0); if-goto L => goto L
+                "always taken conditional jump", 2,
+                [] (const Instruction* window) {
+                    return isPush(window[0], Segment::CONST) && window[0].value != 0 && window[1].type == Type::IF_GOTO;
+                },
+                [] (Instruction* window) -> size_t {
+                    window[0] = Instruction::goTo(window[1].name);
+                    return 1;
+                }
+            },
+            {
+                // push constant 0; not; if-goto L => goto L
+                "always taken conditional jump", 3,
+                [] (const Instruction* window) {
+                    return isPush(window[0], Segment::CONST) && window[0].value == 0 && 
+                        isArithmetic(window[1], Command::NOT) && window[2].type == Type::IF_GOTO;
+                },
+                [] (Instruction* window) -> size_t {
+                    window[0] = Instruction::goTo(window[2].name);
+                    return 1;
+                }
+            },
+            {
+                // goto L; label L => label L
+                "jump to the next instruction", 2,
+                [] (const Instruction* window) {
+                    return window[0].type == Type::GOTO && window[1].type == Type::LABEL && window[0].name == window[1].name;
+                },
+                [] (Instruction* window) -> size_t {
+                    window[0] = window[1];
+                    return 1;
+                }
+            },
+            {
+                // goto L OR return, followed by anything but a label
+                "unreachable instruction", 2,
+                [] (const Instruction* window) {
+                    return endsControlFlow(window[0]) && window[1].type != Type::LABEL && window[1].type != Type::FUNCTION;
+                },
+                [] (Instruction*) -> size_t { return 1; }
+            }
+        }};
+
+        /**
+         * Applies the rules to the end of the window after each instruction that is added to it, so that
+         * instructions that become adjacent by a rewrite are examined as well.
+         * Returns true if any rule was applied.
+         */
+        bool applyRules(vector<Instruction>& instructions, OptimizationStatistics& statistics) {
+            vector<Instruction> window;
+            window.reserve(instructions.size());
+            auto changed{false};
+
+            for(const auto& instruction : instructions) {
+                window.push_back(instruction);
+
+                for(auto ruleIt = RULES.cbegin(); ruleIt != RULES.cend();) {
+                    if(window.size() >= ruleIt->windowSize) {
+                        auto* const first = window.data() + window.size() - ruleIt->windowSize;
+
+                        if(ruleIt->matches(first)) {
+                            const auto newSize = ruleIt->rewrite(first);
+                            window.resize(window.size() - ruleIt->windowSize + newSize);
+                            statistics.add(ruleIt->name, ruleIt->windowSize - newSize);
+                            changed = true;
+
+                            // the rewritten end of the window may match again
+                            ruleIt = RULES.cbegin();
+                            continue;
+                        }
+                    }
+
+                    ++ruleIt;
+                }
+            }
+
+            instructions.swap(window);
+            return changed;
+        }
+
+        /**
+         * Removes labels that are not the target of any goto or if-goto.
+         * Returns true if any label was removed.
+         */
+        bool removeUnreferencedLabels(vector<Instruction>& instructions, OptimizationStatistics& statistics) {
+            unordered_map<string_view, size_t> referenceCounts;
+
+            for(const auto& instruction : instructions) {
+                if(instruction.type == Type::GOTO || instruction.type == Type::IF_GOTO) {
+                    ++referenceCounts[instruction.name];
+                }
+            }
+
+            const auto oldSize = instructions.size();
+
+            instructions.erase(std::remove_if(instructions.begin(), instructions.end(), 
+                [&referenceCounts] (const Instruction& instruction) {
+                    return instruction.type == Type::LABEL && referenceCounts.find(instruction.name) == referenceCounts.cend();
+                }), instructions.end());
+
+            if(instructions.size() == oldSize) {
+                return false;
+            }
+
+            statistics.add("unreferenced label", oldSize - instructions.size());
+            return true;
+        }
+    }
+
+    void optimize(vector<Instruction>& instructions, OptimizationStatistics& statistics) {
+        applyRules(instructions, statistics);
+
+        // removing labels may make further rules applicable
+        while(removeUnreferencedLabels(instructions, statistics) && applyRules(instructions, statistics)) {}
+    }
+}
@@ -0,0 +1,66 @@
+#include "SourceCompiler.h"
+#include <stdexcept>
+
+using std::string_view;
+using std::streamsize;
+using std::runtime_error;
+
+namespace JackCompiler {
+    SourceCompiler::OutputBuffer::int_type SourceCompiler::OutputBuffer::overflow(int_type character) {
+        if(!traits_type::eq_int_type(character, traits_type::eof())) {
+            output->push_back(traits_type::to_char_type(character));
+        }
+
+        return traits_type::not_eof(character);
+    }
+
+    streamsize SourceCompiler::OutputBuffer::xsputn(const char* characters, streamsize count) {
+        output->append(characters, static_cast<size_t>(count));
+        return count;
+    }
+
+    void SourceCompiler::compile(string_view source, const CompilationOptions& options, Result& result) {
+        result.output.clear();
+        result.errors.clear();
+        result.statistics.clear();
+        outputBuffer_.output = &result.output;
+
+        try {
+            if(engine_) {
+                engine_->reset(source, outputStream_, options);
+            }
+            else {
+                engine_.emplace(source, outputStream_, options);
+            }
+
+            engine_->compileClass();
+            result.statistics = engine_->statistics();
+        }
+        catch(const runtime_error& e) {
+            // after an error the output is incomplete
+            result.output.clear();
+
+            if(engine_) {
+                result.errors = engine_->errors();
+            }
+
+            // errors that stop the compilation before the class is processed (e.g. while lexing the first token)
+            // are not recorded by the compilation engine, errors that do not refer to a line get the line 0
+            if(const auto* compilationError = dynamic_cast<const CompilationError*>(&e)) {
+                if(result.errors.empty()) {
+                    result.errors.push_back(*compilationError);
+                }
+            }
+            else {
+                result.errors.emplace_back(0, e.what());
+            }
+        }
+
+        outputBuffer_.output = nullptr;
+    }
+
+    SourceCompiler::Result compileSource(string_view source, const CompilationOptions& options) {
+        thread_local SourceCompiler compiler;
+        return compiler.compile(source, options);
+    }
+}
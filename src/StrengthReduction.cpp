@@ -0,0 +1,171 @@
+#include "StrengthReduction.h"
+#include "HackCost.h"
+#include <cstdlib>
+
+using std::optional;
+using std::nullopt;
+using std::vector;
+
+namespace JackCompiler::StrengthReduction {
+    namespace {
+        using Instruction = VMWriter::Instruction;
+        using InstructionType = VMWriter::Instruction::Type;
+
+        using namespace HackCost;
+
+        // limits the growth of the code, which has to fit into the 32K ROM of the Hack platform
+        constexpr size_t MAX_SEQUENCE_LENGTH = 32;
+        constexpr int SCRATCH_INDEX = 0;
+
+        constexpr auto PUSH_SCRATCH = Instruction::push(VMWriter::Segment::TEMP, SCRATCH_INDEX);
+        constexpr auto POP_SCRATCH = Instruction::pop(VMWriter::Segment::TEMP, SCRATCH_INDEX);
+        constexpr auto ADD = Instruction::arithmetic(VMWriter::Command::ADD);
+        constexpr auto SUB = Instruction::arithmetic(VMWriter::Command::SUB);
+        constexpr auto NEG = Instruction::arithmetic(VMWriter::Command::NEG);
+
+        /**
+         * \brief Gets the binary digits of a positive value, least significant digit first.
+         */
+        vector<int> binaryDigits(int value) {
+            vector<int> digits;
+
+            for(; value != 0; value >>= 1) {
+                digits.push_back(value & 1);
+            }
+
+            return digits;
+        }
+
+        /**
+         * \brief Gets the non-adjacent form of a positive value, least significant digit first, i.e. the
+         * signed binary digits (-1, 0 or 1) with the least number of non-zero digits.
+         */
+        vector<int> nonAdjacentDigits(int value) {
+            vector<int> digits;
+
+            while(value != 0) {
+                int digit{};
+
+                if(value & 1) {
+                    digit = 2 - (value & 3);
+                    value -= digit;
+                }
+
+                digits.push_back(digit);
+                value >>= 1;
+            }
+
+            return digits;
+        }
+
+        /**
+         * \brief Gets a shift-and-add chain that multiplies the value on top of the stack by the sum of
+         * sign * digit_i * 2^i. The value is stored in the scratch-register and doubled there, the
+         * product is accumulated on the stack.
+         */
+        vector<Instruction> shiftAndAdd(const vector<int>& digits, int sign) {
+            vector<Instruction> instructions{POP_SCRATCH};
+            bool started{};
+
+            for(size_t i = 0; i < digits.size(); ++i) {
+                const int digit = digits[i] * sign;
+                const bool last = i + 1 == digits.size();
+
+                if(digit != 0) {
+                    // the doubled value of the last digit is still on the stack
+                    if(!last || i == 0) {
+                        instructions.push_back(PUSH_SCRATCH);
+                    }
+
+                    if(!started) {
+                        if(digit < 0) {
+                            instructions.push_back(NEG);
+                        }
+
+                        started = true;
+                    }
+                    else {
+                        instructions.push_back(digit > 0 ? ADD : SUB);
+                    }
+                }
+
+                if(i + 2 < digits.size()) {
+                    instructions.insert(instructions.end(), {PUSH_SCRATCH, PUSH_SCRATCH, ADD, POP_SCRATCH});
+                }
+                else if(i + 2 == digits.size()) {
+                    // the last doubling does not need to be stored
+                    instructions.insert(instructions.end(), {PUSH_SCRATCH, PUSH_SCRATCH, ADD});
+                }
+            }
+
+            return instructions;
+        }
+
+        optional<vector<Instruction>> cheapest(vector<vector<Instruction>> candidates) {
+            optional<vector<Instruction>> result;
+            int resultCost{CALL_COST};
+
+            for(auto& candidate : candidates) {
+                const int candidateCost = cost(candidate);
+
+                if(candidate.size() <= MAX_SEQUENCE_LENGTH && candidateCost < resultCost) {
+                    resultCost = candidateCost;
+                    result = std::move(candidate);
+                }
+            }
+
+            return result;
+        }
+    }
+
+    optional<vector<Instruction>> multiplication(int constant) {
+        if(constant == 0) {
+            // the other operand might have side-effects, so it must be evaluated anyway
+            return vector<Instruction>{POP_SCRATCH, Instruction::push(VMWriter::Segment::CONST, 0)};
+        }
+
+        // the result only depends on the lower 16 bits, which also holds for -32768
+        const int sign = constant < 0 ? -1 : 1;
+        const int magnitude = std::abs(constant);
+
+        if(magnitude == 1) {
+            return sign > 0 ? vector<Instruction>{} : vector<Instruction>{NEG};
+        }
+
+        return cheapest({shiftAndAdd(binaryDigits(magnitude), sign), shiftAndAdd(nonAdjacentDigits(magnitude), sign)});
+    }
+
+    optional<vector<Instruction>> division(int constant) {
+        // The VM has no right-shift, so dividing by other powers of two requires a loop just like Math.divide.
+        // Dividing by -1 is not replaced by neg since Math.divide does not handle -32768 the same way.
+        if(constant == 1) {
+            return vector<Instruction>{};
+        }
+
+        return nullopt;
+    }
+
+    int cost(const vector<Instruction>& instructions) {
+        int result{};
+
+        for(const auto& instruction : instructions) {
+            switch(instruction.type) {
+                case InstructionType::PUSH:
+                    result += PUSH_COST;
+                    break;
+                case InstructionType::POP:
+                    result += POP_COST;
+                    break;
+                case InstructionType::ARITHMETIC:
+                    result += instruction.command == VMWriter::Command::NEG || instruction.command == VMWriter::Command::NOT 
+                        ? UNARY_ARITHMETIC_COST : BINARY_ARITHMETIC_COST;
+                    break;
+                default:
+                    result += CALL_COST;
+                    break;
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,27 @@
+#include "StringInterner.h"
+#include <algorithm>
+
+using std::string_view;
+using std::make_unique;
+using std::max;
+
+namespace JackCompiler {
+    string_view StringInterner::intern(string_view string) {
+        if(const auto it = strings_.find(string); it != strings_.cend()) {
+            return *it;
+        }
+
+        if(blocks_.empty() || currentBlockUsed_ + string.size() > currentBlockSize_) {
+            // strings that are longer than a block get a block of their own
+            currentBlockSize_ = max(BLOCK_SIZE, string.size());
+            currentBlockUsed_ = 0;
+            blocks_.push_back(make_unique<char[]>(currentBlockSize_));
+        }
+
+        auto* const storage = blocks_.back().get() + currentBlockUsed_;
+        std::copy(string.cbegin(), string.cend(), storage);
+        currentBlockUsed_ += string.size();
+
+        return *strings_.emplace(storage, string.size()).first;
+    }
+}
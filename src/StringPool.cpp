@@ -0,0 +1,17 @@
+#include "StringPool.h"
+
+namespace JackCompiler {
+    StringPool::StringPool(const Ast::Class& astClass) : firstStaticIndex_{astClass.nStatics} {
+        for(const auto* subroutine : astClass.subroutines) {
+            Ast::forEachExpression(subroutine->statements, [this, subroutine] (const Ast::Expression& expression) {
+                if(const auto* stringConstant = expression.as<Ast::StringConstant>()) {
+                    if(indices_.emplace(stringConstant->value, static_cast<int>(strings_.size())).second) {
+                        strings_.push_back(stringConstant->value);
+                    }
+
+                    users_.insert(subroutine);
+                }
+            });
+        }
+    }
+}
@@ -3,77 +3,77 @@
 #include <stdexcept>
 
 using std::string;
+using std::string_view;
 
 namespace JackCompiler {
+    void SymbolTable::reset() {
+        classScopeTable_.clear();
+        subroutineScopeTable_.clear();
+        varCounts_.fill(0);
+        classScope_ = true;
+    }
+
     void SymbolTable::startSubroutine() {
         subroutineScopeTable_.clear();
-        subroutineScopeVarCount_.clear();
+        varCounts_[static_cast<size_t>(SymbolKind::ARG)] = 0;
+        varCounts_[static_cast<size_t>(SymbolKind::VAR)] = 0;
         classScope_ = false;
     }
 
-    void SymbolTable::define(const string& name, const string& type, SymbolKind kind) {
+    void SymbolTable::define(string_view name, string_view type, SymbolKind kind) {
+        auto& varCount = varCounts_[static_cast<size_t>(kind)];
+
         if(kind == SymbolKind::STATIC || kind == SymbolKind::FIELD) {
-            classScopeTable_.emplace(name, IdentifierEntry{kind, type, classScopeVarCount_[kind]++});
+            classScopeTable_.emplace(name, IdentifierEntry{kind, type, varCount++});
         }
         else {
-            subroutineScopeTable_.emplace(name, IdentifierEntry{kind, type, subroutineScopeVarCount_[kind]++});
+            subroutineScopeTable_.emplace(name, IdentifierEntry{kind, type, varCount++});
         }
     }
 
     int SymbolTable::varCount(SymbolKind kind) const {
-        if(kind == SymbolKind::STATIC || kind == SymbolKind::FIELD) {
-            // return classScopeVarCount_[kind];
-            if(const auto it = classScopeVarCount_.find(kind); it != classScopeVarCount_.cend()) {
-                return it->second;
-            }
+        if(kind == SymbolKind::NONE) {
+            return 0;
         }
-        else if(const auto it = subroutineScopeVarCount_.find(kind); it != subroutineScopeVarCount_.cend()) {
-            return it->second;
-        }
-        // return subroutineScopeVarCount_[kind];
 
-        return 0;
+        return varCounts_[static_cast<size_t>(kind)];
     }
 
-    SymbolTable::SymbolKind SymbolTable::kindOf(const string& name) {
+    const SymbolTable::IdentifierEntry* SymbolTable::find(string_view name) const {
         if(!classScope_) {
             if(const auto it = subroutineScopeTable_.find(name); it != subroutineScopeTable_.cend()) {
-                return it->second.kind;
+                return &it->second;
             }
         }
         
         if(const auto it = classScopeTable_.find(name); it != classScopeTable_.cend()) {
-            return it->second.kind;
+            return &it->second;
         }
 
-        return SymbolKind::NONE;
+        return nullptr;
     }
 
-    string SymbolTable::typeOf(const string& name) {
-        if(!classScope_) {
-            if(const auto it = subroutineScopeTable_.find(name); it != subroutineScopeTable_.cend()) {
-                return it->second.type;
-            }
-        }
-        
-        if(const auto it = classScopeTable_.find(name); it != classScopeTable_.cend()) {
-            return it->second.type;
+    SymbolTable::SymbolKind SymbolTable::kindOf(string_view name) const {
+        if(const auto* entry = find(name)) {
+            return entry->kind;
         }
 
-        throw std::runtime_error{"Symbol-Table: " + name + " does not exist."};
+        return SymbolKind::NONE;
     }
 
-    int SymbolTable::indexOf(const string & name) {
-        if(!classScope_) {
-            if(const auto it = subroutineScopeTable_.find(name); it != subroutineScopeTable_.cend()) {
-                return it->second.index;
-            }
+    string_view SymbolTable::typeOf(string_view name) const {
+        if(const auto* entry = find(name)) {
+            return entry->type;
         }
-        
-        if(const auto it = classScopeTable_.find(name); it != classScopeTable_.cend()) {
-            return it->second.index;
+
+        throw std::runtime_error{"Symbol-Table: " + string{name} + " does not exist."};
+    }
+
+    int SymbolTable::indexOf(string_view name) const {
+        if(const auto* entry = find(name)) {
+            return entry->index;
         }
 
-        throw std::runtime_error{"Symbol-Table: " + name + " does not exist."};
+        throw std::runtime_error{"Symbol-Table: " + string{name} + " does not exist."};
     }
 }
@@ -0,0 +1,133 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::deque;
+using std::exception_ptr;
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::optional;
+using std::thread;
+using std::vector;
+
+namespace JackCompiler::TaskScheduler {
+    namespace {
+        struct TaskQueue {
+            mutex queueMutex;
+            deque<size_t> tasks;
+        };
+
+        class Pool {
+        public:
+            Pool(size_t taskCount, size_t threadCount, const function<void(size_t)>& task)
+                : queues_(threadCount), task_{task} {
+                for(size_t i = 0; i < taskCount; ++i) {
+                    queues_[i % threadCount].tasks.push_back(i);
+                }
+            }
+
+            void work(size_t worker) {
+                while(!failed_) {
+                    const auto task = takeTask(worker);
+
+                    if(!task) {
+                        return;
+                    }
+
+                    try {
+                        task_(*task);
+                    }
+                    catch(...) {
+                        const lock_guard<mutex> lock{exceptionMutex_};
+
+                        if(!exception_) {
+                            exception_ = std::current_exception();
+                        }
+
+                        failed_ = true;
+                    }
+                }
+            }
+
+            void rethrowException() const {
+                if(exception_) {
+                    std::rethrow_exception(exception_);
+                }
+            }
+
+        private:
+            vector<TaskQueue> queues_;
+            const function<void(size_t)>& task_;
+            atomic<bool> failed_{false};
+            mutex exceptionMutex_;
+            exception_ptr exception_;
+
+            optional<size_t> takeTask(size_t worker) {
+                {
+                    auto& queue = queues_[worker];
+                    const lock_guard<mutex> lock{queue.queueMutex};
+
+                    if(!queue.tasks.empty()) {
+                        const auto task = queue.tasks.front();
+                        queue.tasks.pop_front();
+                        return task;
+                    }
+                }
+
+                // no tasks are added while the pool is running, so it is done once all queues are empty
+                for(size_t i = 1; i < queues_.size(); ++i) {
+                    auto& queue = queues_[(worker + i) % queues_.size()];
+                    const lock_guard<mutex> lock{queue.queueMutex};
+
+                    if(!queue.tasks.empty()) {
+                        const auto task = queue.tasks.back();
+                        queue.tasks.pop_back();
+                        return task;
+                    }
+                }
+
+                return {};
+            }
+        };
+    }
+
+    size_t defaultJobCount() {
+        return std::max(1u, thread::hardware_concurrency());
+    }
+
+    void run(size_t taskCount, size_t jobs, const function<void(size_t)>& task) {
+        const auto threadCount = std::min(jobs > 0 ? jobs : defaultJobCount(), taskCount);
+
+        if(threadCount <= 1) {
+            for(size_t i = 0; i < taskCount; ++i) {
+                task(i);
+            }
+
+            return;
+        }
+
+        Pool pool{taskCount, threadCount, task};
+        vector<thread> threads;
+        threads.reserve(threadCount - 1);
+
+        for(size_t worker = 1; worker < threadCount; ++worker) {
+            threads.emplace_back([&pool, worker] { pool.work(worker); });
+        }
+
+        pool.work(0);
+
+        for(auto& workerThread : threads) {
+            workerThread.join();
+        }
+
+        pool.rethrowException();
+    }
+}
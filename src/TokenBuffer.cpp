@@ -0,0 +1,52 @@
+#include "TokenBuffer.h"
+#include <stdexcept>
+
+using std::string_view;
+using std::uint8_t;
+using std::uint32_t;
+
+namespace JackCompiler {
+    TokenBuffer::TokenBuffer(string_view source) : source_{source} {
+        if(source.size() > UINT32_MAX) {
+            throw std::runtime_error{"The source is too large to be pre-lexed."};
+        }
+
+        // Jack code contains roughly one token per five bytes
+        const auto estimatedTokenCount = source.size() / 5;
+        tokenTypes_.reserve(estimatedTokenCount);
+        codes_.reserve(estimatedTokenCount);
+        offsets_.reserve(estimatedTokenCount);
+        lengths_.reserve(estimatedTokenCount);
+        lines_.reserve(estimatedTokenCount);
+
+        // a token is only stored once the look-ahead behind it was lexed as well, so a walking tokenizer
+        // throws the error when advancing to the same token as a tokenizer lexing the buffer directly
+        try {
+            Tokenizer tokenizer{source};
+
+            while(tokenizer.hasMoreTokens()) {
+                tokenizer.advance();
+
+                const auto tokenType = tokenizer.tokenType();
+                tokenTypes_.push_back(static_cast<uint8_t>(tokenType));
+
+                if(tokenType == Tokenizer::TokenType::KEYWORD) {
+                    codes_.push_back(static_cast<uint8_t>(tokenizer.keyWord()));
+                }
+                else if(tokenType == Tokenizer::TokenType::SYMBOL) {
+                    codes_.push_back(static_cast<uint8_t>(tokenizer.symbol()));
+                }
+                else {
+                    codes_.push_back(0);
+                }
+
+                offsets_.push_back(static_cast<uint32_t>(tokenizer.currentToken_.data() - source.data()));
+                lengths_.push_back(static_cast<uint32_t>(tokenizer.currentToken_.size()));
+                lines_.push_back(static_cast<uint32_t>(tokenizer.getCurrentLine()));
+            }
+        }
+        catch(const CompilationError& e) {
+            error_ = e;
+        }
+    }
+}
@@ -1,40 +1,59 @@
 #include "Tokenizer.h"
+#include "CharScanner.h"
+#include "CompilationError.h"
+#include "TokenBuffer.h"
 #include <vector>
 #include <regex>
 #include <sstream>
 #include <algorithm>
-#include <unordered_map>
+#include <array>
+#include <utility>
+#include <charconv>
 
 using std::vector;
 using std::pair;
 using std::regex;
 using std::string;
+using std::string_view;
 using std::sregex_token_iterator;
 using std::runtime_error;
-using std::unordered_map;
 using std::ostream;
 using std::stringstream;
-using std::to_string;
+using std::array;
+using std::getline;
 
 namespace JackCompiler {
     namespace {
-        const vector<pair<Tokenizer::TokenType, regex>> TOKEN_TYPE_TO_PATTERN{
-            { Tokenizer::TokenType::KEYWORD,      regex{"^(class|constructor|function|method|field|static|var|int|char|boolean|void"
-                                                        "|true|false|null|this|let|do|if|else|while|return)$", 
-                                                        regex::optimize | regex::nosubs} },
-            { Tokenizer::TokenType::SYMBOL,       regex{R"(^(\{|\}|\(|\)|\[|\]|\.|,|;|\+|-|\*|/|&|\||<|>|=|~)$)", 
-                                                        regex::optimize | regex::nosubs} },
-            { Tokenizer::TokenType::IDENTIFIER,   regex{"^([[:alpha:]_][[:alnum:]]*)$", 
-                                                        regex::optimize | regex::nosubs} },
-            { Tokenizer::TokenType::INT_CONST,    regex{R"(^(\d+)$)", 
-                                                        regex::optimize | regex::nosubs} },
-            { Tokenizer::TokenType::STRING_CONST, regex{"^\"(.*)\"$", 
-                                                        regex::optimize | regex::nosubs} }
-        };
+        // the patterns are only compiled when the regex-lexer is used for the first time
+        const vector<pair<Tokenizer::TokenType, regex>>& tokenTypePatterns() {
+            static const vector<pair<Tokenizer::TokenType, regex>> TOKEN_TYPE_TO_PATTERN{
+                { Tokenizer::TokenType::KEYWORD,      regex{"^(class|constructor|function|method|field|static|var|int|char|boolean|void"
+                                                            "|true|false|null|this|let|do|if|else|while|return)$", 
+                                                            regex::optimize | regex::nosubs} },
+                { Tokenizer::TokenType::SYMBOL,       regex{R"(^(\{|\}|\(|\)|\[|\]|\.|,|;|\+|-|\*|/|&|\||<|>|=|~)$)", 
+                                                            regex::optimize | regex::nosubs} },
+                { Tokenizer::TokenType::IDENTIFIER,   regex{"^([[:alpha:]_][[:alnum:]_]*)$", 
+                                                            regex::optimize | regex::nosubs} },
+                { Tokenizer::TokenType::INT_CONST,    regex{R"(^(\d+)$)", 
+                                                            regex::optimize | regex::nosubs} },
+                { Tokenizer::TokenType::STRING_CONST, regex{"^\"(.*)\"$", 
+                                                            regex::optimize | regex::nosubs} }
+            };
+
+            return TOKEN_TYPE_TO_PATTERN;
+        }
+
+        const regex& tokenDelimiterPattern() {
+            static const regex TOKEN_DELIMITER_PATTERN{R"(( |\{|\}|\(|\)|\[|\]|\.|,|;|\+|-|\*|/|&|\||<|>|=|~))", regex::optimize};
+            return TOKEN_DELIMITER_PATTERN;
+        }
 
-        const regex TOKEN_DELIMITER_PATTERN{R"(( |\{|\}|\(|\)|\[|\]|\.|,|;|\+|-|\*|/|&|\||<|>|=|~))", regex::optimize};
+        struct KeywordEntry {
+            string_view keyword;
+            Tokenizer::KeyWordType type;
+        };
 
-        const unordered_map<string, Tokenizer::KeyWordType> KEYWORD_TO_TYPE{
+        constexpr array<KeywordEntry, 21> KEYWORDS{{
             { "class",       Tokenizer::KeyWordType::CLASS },
             { "constructor", Tokenizer::KeyWordType::CONSTRUCTOR },
             { "function",    Tokenizer::KeyWordType::FUNCTION },
@@ -56,7 +75,87 @@ namespace JackCompiler {
             { "else",        Tokenizer::KeyWordType::ELSE },
             { "while",       Tokenizer::KeyWordType::WHILE },
             { "return",      Tokenizer::KeyWordType::RETURN }
-        };
+        }};
+
+        // Perfect hash-function for the keywords: The multipliers were chosen such that no two
+        // keywords are mapped to the same slot (checked below).
+        constexpr size_t KEYWORD_TABLE_SIZE = 32;
+
+        constexpr size_t keywordHash(string_view word) {
+            return (word.size() + 8 * static_cast<unsigned char>(word.front()) 
+                    + 27 * static_cast<unsigned char>(word.back())) % KEYWORD_TABLE_SIZE;
+        }
+
+        constexpr array<KeywordEntry, KEYWORD_TABLE_SIZE> makeKeywordTable() {
+            array<KeywordEntry, KEYWORD_TABLE_SIZE> table{};
+
+            for(const auto& entry : KEYWORDS) {
+                table[keywordHash(entry.keyword)] = entry;
+            }
+
+            return table;
+        }
+
+        constexpr auto KEYWORD_TABLE = makeKeywordTable();
+
+        constexpr bool keywordHashIsPerfect() {
+            for(const auto& entry : KEYWORDS) {
+                if(KEYWORD_TABLE[keywordHash(entry.keyword)].keyword != entry.keyword) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static_assert(keywordHashIsPerfect(), "The keyword hash-function must not produce collisions.");
+
+        /**
+         * \brief Looks up the keyword-entry of a non-empty word.
+         * \return The keyword-entry or nullptr if the word is not a keyword
+         */
+        constexpr const KeywordEntry* findKeyword(string_view word) {
+            const auto& entry = KEYWORD_TABLE[keywordHash(word)];
+            return entry.keyword == word ? &entry : nullptr;
+        }
+
+        enum CharClass : unsigned char { OTHER, WHITESPACE, NEWLINE, SYMBOL, LETTER, DIGIT, QUOTE };
+
+        constexpr array<unsigned char, 256> makeCharClassTable() {
+            array<unsigned char, 256> table{};
+
+            for(const auto* c = " \t\r\v\f"; *c != '\0'; ++c) {
+                table[static_cast<unsigned char>(*c)] = WHITESPACE;
+            }
+
+            for(const auto* c = "{}()[].,;+-*/&|<>=~"; *c != '\0'; ++c) {
+                table[static_cast<unsigned char>(*c)] = SYMBOL;
+            }
+
+            for(auto c = 'a'; c <= 'z'; ++c) {
+                table[static_cast<unsigned char>(c)] = LETTER;
+            }
+
+            for(auto c = 'A'; c <= 'Z'; ++c) {
+                table[static_cast<unsigned char>(c)] = LETTER;
+            }
+
+            for(auto c = '0'; c <= '9'; ++c) {
+                table[static_cast<unsigned char>(c)] = DIGIT;
+            }
+
+            table[static_cast<unsigned char>('\n')] = NEWLINE;
+            table[static_cast<unsigned char>('_')] = LETTER;
+            table[static_cast<unsigned char>('\"')] = QUOTE;
+
+            return table;
+        }
+
+        constexpr auto CHAR_CLASS = makeCharClassTable();
+
+        inline CharClass charClass(char c) {
+            return static_cast<CharClass>(CHAR_CLASS[static_cast<unsigned char>(c)]);
+        }
 
         void trimWhitespaceAndComments(string& line, bool& inBlockComment) {
             if(const auto firstNonWhitespaceIndex = line.find_first_not_of(" \t"); firstNonWhitespaceIndex != string::npos) {
@@ -131,24 +230,255 @@ namespace JackCompiler {
         const sregex_token_iterator TOKEN_IT_END;
     }
 
+    void Tokenizer::reset(string_view source) {
+        inputStream_ = nullptr;
+        lexerMode_ = LexerMode::SCANNER;
+        source_ = source;
+        currentLineNr_ = 1;
+        currentTokenLineNr_ = 0;
+        nextTokenLineNr_ = 0;
+        currentToken_ = {};
+        currentTokenType_ = {};
+        currentKeyWordType_ = {};
+        nextToken_ = {};
+        failed_ = false;
+        tokenBuffer_ = nullptr;
+        nextTokenIndex_ = 0;
+        invalidTokenAhead_ = false;
+        sourcePos_ = 0;
+        chunkBufferIndex_ = 0;
+        endOfInput_ = false;
+        inLineComment_ = false;
+        inBlockComment_ = false;
+        blockCommentStartLine_ = 0;
+        nextTokenValid_ = false;
+        nextTokenType_ = {};
+        nextKeyWordType_ = {};
+
+        updateNextToken();
+    }
+
     void Tokenizer::updateNextToken() {
+        if(tokenBuffer_ != nullptr) {
+            if(nextTokenIndex_ < tokenBuffer_->size()) {
+                nextToken_ = tokenBuffer_->text(nextTokenIndex_);
+                nextTokenLineNr_ = tokenBuffer_->line(nextTokenIndex_);
+            }
+            else {
+                nextToken_ = {};
+                invalidTokenAhead_ = tokenBuffer_->error() != nullptr;
+
+                if(invalidTokenAhead_) {
+                    nextTokenLineNr_ = tokenBuffer_->error()->line();
+                }
+            }
+
+            return;
+        }
+
+        if(lexerMode_ == LexerMode::REGEX) {
+            updateNextTokenRegex();
+        }
+        else {
+            scanNextToken();
+        }
+
+        nextTokenLineNr_ = currentLineNr_;
+    }
+
+    bool Tokenizer::skipWhitespaceAndComments() {
+        const auto length{source_.size()};
+        auto i{sourcePos_};
+        auto incomplete{false};
+
+        while(i != length) {
+            size_t skippedNewlines{};
+
+            if(inBlockComment_) {
+                i = CharScanner::findBlockCommentEnd(source_, i, skippedNewlines);
+                currentLineNr_ += skippedNewlines;
+
+                if(i != length) {
+                    inBlockComment_ = false;
+                    i += 2;
+                }
+                else if(source_.back() == '*') {
+                    // the closing "*/" may be split across two chunks, so the '*' is kept
+                    i = length - 1;
+                    incomplete = true;
+                    break;
+                }
+
+                continue;
+            }
+
+            if(inLineComment_) {
+                // the terminating newline is skipped in the next iteration
+                i = CharScanner::find(source_, i, '\n');
+                inLineComment_ = (i == length);
+                continue;
+            }
+
+            i = CharScanner::skipWhitespace(source_, i, skippedNewlines);
+            currentLineNr_ += skippedNewlines;
+
+            if(i == length || source_[i] != '/') {
+                break;
+            }
+
+            if(i + 1 == length) {
+                // a '/' at the end of a chunk may start a comment that continues in the next chunk
+                incomplete = moreInputAvailable();
+                break;
+            }
+
+            if(source_[i + 1] == '/') {
+                inLineComment_ = true;
+                i += 2;
+            }
+            else if(source_[i + 1] == '*') {
+                inBlockComment_ = true;
+                blockCommentStartLine_ = currentLineNr_;
+                i += 2;
+            }
+            else {
+                break;
+            }
+        }
+
+        sourcePos_ = i;
+        return i != length && !incomplete;
+    }
+
+    bool Tokenizer::readNextChunk(size_t chunkBufferIndex) {
+        if(!moreInputAvailable()) {
+            return false;
+        }
+
+        // the unconsumed remainder of the current chunk is moved in front of the newly read input
+        auto& chunk = chunkBuffers_[chunkBufferIndex];
+
+        if(chunkBufferIndex == chunkBufferIndex_) {
+            chunk.erase(0, sourcePos_);
+        }
+        else {
+            chunk.assign(source_.substr(sourcePos_));
+        }
+
+        const auto remainderSize{chunk.size()};
+        chunk.resize(remainderSize + chunkSize_);
+        inputStream_->read(chunk.data() + remainderSize, static_cast<std::streamsize>(chunkSize_));
+        chunk.resize(remainderSize + static_cast<size_t>(inputStream_->gcount()));
+        endOfInput_ = !*inputStream_;
+
+        chunkBufferIndex_ = chunkBufferIndex;
+        source_ = chunk;
+        sourcePos_ = 0;
+        return true;
+    }
+
+    void Tokenizer::scanNextToken() {
+        // The current token may still refer to the current chunk-buffer, so
+        // new chunks are read into the other one.
+        const auto freeChunkBufferIndex = chunkBufferIndex_ ^ 1;
+
+        while(true) {
+            if(!skipWhitespaceAndComments()) {
+                if(readNextChunk(freeChunkBufferIndex)) {
+                    continue;
+                }
+
+                if(inBlockComment_) {
+                    throw CompilationError{blockCommentStartLine_, "A block-comment starting on this line was never closed."};
+                }
+
+                // end of valid tokens in the input reached
+                nextToken_ = {};
+                return;
+            }
+
+            const auto length{source_.size()};
+            const auto tokenStart{sourcePos_};
+            const auto firstCharClass{charClass(source_[tokenStart])};
+            auto tokenEnd{tokenStart + 1};
+
+            nextTokenValid_ = true;
+
+            if(firstCharClass == QUOTE) {
+                // string literals must not span multiple lines
+                tokenEnd = CharScanner::findEither(source_, tokenEnd, '\"', '\n');
+            }
+            else if(firstCharClass != SYMBOL) {
+                // A word extends up to the next whitespace or symbol. It is valid if it consists of
+                // digits only (integer constant) or if it starts with a letter and consists of
+                // letters and digits only (keyword or identifier).
+                for(; tokenEnd != length; ++tokenEnd) {
+                    const auto currentCharClass = charClass(source_[tokenEnd]);
+
+                    if(currentCharClass == WHITESPACE || currentCharClass == NEWLINE || currentCharClass == SYMBOL) {
+                        break;
+                    }
+
+                    nextTokenValid_ = nextTokenValid_ && (currentCharClass == DIGIT ||
+                        (currentCharClass == LETTER && firstCharClass == LETTER));
+                }
+            }
+
+            // a token reaching the end of a chunk may continue in the next one, so it is scanned again
+            if(tokenEnd == length && firstCharClass != SYMBOL && readNextChunk(freeChunkBufferIndex)) {
+                continue;
+            }
+
+            if(firstCharClass == SYMBOL) {
+                nextTokenType_ = TokenType::SYMBOL;
+            }
+            else if(firstCharClass == QUOTE) {
+                if(tokenEnd == length || source_[tokenEnd] != '\"') {
+                    throw CompilationError{currentLineNr_, "Malformed string literal. Did you forget closing '\"'?"};
+                }
+
+                ++tokenEnd;
+                nextTokenType_ = TokenType::STRING_CONST;
+            }
+            else {
+                nextTokenValid_ = nextTokenValid_ && (firstCharClass == LETTER || firstCharClass == DIGIT);
+                nextTokenType_ = (firstCharClass == DIGIT ? TokenType::INT_CONST : TokenType::IDENTIFIER);
+            }
+
+            nextToken_ = source_.substr(tokenStart, tokenEnd - tokenStart);
+            sourcePos_ = tokenEnd;
+            break;
+        }
+
+        if(nextTokenType_ == TokenType::IDENTIFIER && nextTokenValid_) {
+            if(const auto* keyword = findKeyword(nextToken_)) {
+                nextTokenType_ = TokenType::KEYWORD;
+                nextKeyWordType_ = keyword->type;
+            }
+            else if(inputStream_ != nullptr) {
+                // chunk-buffers are reused, so identifiers must be interned to remain valid
+                nextToken_ = identifierInterner_.intern(nextToken_);
+            }
+        }
+    }
+
+    void Tokenizer::updateNextTokenRegex() {
         if(currentLineTokenIterator_ == TOKEN_IT_END) {
             currentLine_.clear();
 
             auto inBlockComment{false};
             auto blockCommentStartLine{currentLineNr_};
 
-            while(inputStream_ && currentLine_.empty()) {
-                getline(inputStream_, currentLine_);
+            while(*inputStream_ && currentLine_.empty()) {
+                getline(*inputStream_, currentLine_);
+                ++currentLineNr_;
 
                 try {
                     trimWhitespaceAndComments(currentLine_, inBlockComment);
                 }
                 catch(const runtime_error& e) {
-                    throw runtime_error{"On line " + to_string(currentLineNr_) + ": " + e.what()};
+                    throw CompilationError{currentLineNr_, e.what()};
                 }
-                
-                ++currentLineNr_;
 
                 if(!inBlockComment) {
                     blockCommentStartLine = currentLineNr_;
@@ -156,64 +486,140 @@ namespace JackCompiler {
             }
 
             if(inBlockComment) {
-                throw runtime_error{"A block-comment starting on line " + to_string(blockCommentStartLine) 
-                    + " was never closed."};
+                throw CompilationError{blockCommentStartLine, "A block-comment starting on this line was never closed."};
             }
 
             currentLineTokenIterator_ = sregex_token_iterator{currentLine_.cbegin(), currentLine_.cend(), 
-                                                              TOKEN_DELIMITER_PATTERN, {-1, 0}};
+                                                              tokenDelimiterPattern(), {-1, 0}};
         }
 
         currentLineTokenIterator_ = find_if_not(currentLineTokenIterator_, TOKEN_IT_END,
                                                 [] (const auto& match) { return match == "" || match == " "; });
 
         if(currentLineTokenIterator_ != TOKEN_IT_END) {
-            // update nextToken_ and advance the token iterator
-            nextToken_ = currentLineTokenIterator_->str();
+            // The current token may still refer to the previous token-buffer, so the
+            // two token-buffers are used alternately.
+            regexTokenBufferIndex_ ^= 1;
+            auto& tokenBuffer = regexTokenBuffers_[regexTokenBufferIndex_];
+
+            // update the token-buffer and advance the token iterator
+            tokenBuffer = currentLineTokenIterator_->str();
             ++currentLineTokenIterator_;
 
             // handle the case of a string literal e.g "print something"
-            if(nextToken_.front() == '\"' && nextToken_.back() != '\"') {
+            if(tokenBuffer.front() == '\"' && tokenBuffer.back() != '\"') {
                 while(currentLineTokenIterator_ != TOKEN_IT_END) {
-                    nextToken_.append(*currentLineTokenIterator_);
+                    tokenBuffer.append(*currentLineTokenIterator_);
                     ++currentLineTokenIterator_;
 
-                    if(nextToken_.back() == '\"') {
+                    if(tokenBuffer.back() == '\"') {
                         break;
                     }
                 }
             }
+
+            nextToken_ = tokenBuffer;
         }
         else {
             // end of valid tokens in the stream reached
-            nextToken_ = "";
+            nextToken_ = {};
         }
     }
 
     void Tokenizer::advance() {
         // range check for invalid files that do not contain a full class definition
         if(!hasMoreTokens()) {
-            throw runtime_error{"Unexpected end of input."};
+            failed_ = true;
+            throw CompilationError{currentTokenLineNr_, "Unexpected end of input."};
         }
 
         currentToken_ = nextToken_;
-        parseCurrentToken();
-        updateNextToken();
+        currentTokenLineNr_ = nextTokenLineNr_;
+
+        try {
+            parseCurrentToken();
+            updateNextToken();
+        }
+        catch(const CompilationError&) {
+            // the invalid input would be encountered again
+            failed_ = true;
+            throw;
+        }
     }
 
     void Tokenizer::parseCurrentToken() {
-        if(const auto it = find_if(TOKEN_TYPE_TO_PATTERN.cbegin(), TOKEN_TYPE_TO_PATTERN.cend(),
-           [&currentToken_ = as_const(currentToken_)] (const auto& item) { return regex_match(currentToken_, item.second); });
-           it != TOKEN_TYPE_TO_PATTERN.cend()) {
+        if(tokenBuffer_ != nullptr) {
+            if(invalidTokenAhead_) {
+                throw *tokenBuffer_->error();
+            }
+
+            currentTokenType_ = tokenBuffer_->tokenType(nextTokenIndex_);
+
+            if(currentTokenType_ == TokenType::KEYWORD) {
+                currentKeyWordType_ = tokenBuffer_->keyWord(nextTokenIndex_);
+            }
+
+            ++nextTokenIndex_;
+            return;
+        }
+
+        if(lexerMode_ == LexerMode::SCANNER) {
+            // the scanner already classified the token while reading it
+            if(!nextTokenValid_) {
+                throw CompilationError{currentTokenLineNr_, "Invalid token >>" + string{currentToken_} + "<<"};
+            }
+
+            currentTokenType_ = nextTokenType_;
+            currentKeyWordType_ = nextKeyWordType_;
+            return;
+        }
+
+        const auto& tokenTypeToPattern = tokenTypePatterns();
+
+        if(const auto it = find_if(tokenTypeToPattern.cbegin(), tokenTypeToPattern.cend(),
+           [currentToken_ = currentToken_] (const auto& item) { 
+               return regex_match(currentToken_.cbegin(), currentToken_.cend(), item.second); 
+           });
+           it != tokenTypeToPattern.cend()) {
             // if the current token matches any of the defined token-patterns, update the current token's type
             currentTokenType_ = it->first;
         }
         else {
-            throw runtime_error{"Invalid token in line " + std::to_string(currentLineNr_) + ": >>" + currentToken_ + "<<"};
+            throw CompilationError{currentTokenLineNr_, "Invalid token >>" + string{currentToken_} + "<<"};
         }
 
         if(currentTokenType_ == TokenType::KEYWORD) {
-            currentKeyWordType_ = KEYWORD_TO_TYPE.at(currentToken_);
+            currentKeyWordType_ = findKeyword(currentToken_)->type;
+        }
+        else if(currentTokenType_ == TokenType::IDENTIFIER) {
+            currentToken_ = identifierInterner_.intern(currentToken_);
         }
     }
+
+    char Tokenizer::peekSymbol(size_t distance) const {
+        if(tokenBuffer_ != nullptr) {
+            const auto index = nextTokenIndex_ + distance - 1;
+
+            return (index < tokenBuffer_->size() && tokenBuffer_->tokenType(index) == TokenType::SYMBOL) ?
+                tokenBuffer_->symbol(index) : '\0';
+        }
+
+        if(distance != 1) {
+            throw runtime_error{"Looking ahead more than one token requires a pre-lexed token-buffer."};
+        }
+
+        // symbols are the only single-character tokens that consist of a symbol-character
+        return (nextToken_.size() == 1 && charClass(nextToken_.front()) == SYMBOL) ? nextToken_.front() : '\0';
+    }
+
+    int Tokenizer::intVal() const {
+        auto value{0};
+
+        if(const auto [end, error] = std::from_chars(currentToken_.data(), currentToken_.data() + currentToken_.size(), value);
+           error != std::errc{}) {
+            throw CompilationError{currentTokenLineNr_, "Integer constant >>" + string{currentToken_} + "<< is out of range."};
+        }
+
+        return value;
+    }
 }
@@ -1,70 +1,159 @@
 #include "VMWriter.h"
-#include <unordered_map>
+#include "PeepholeOptimizer.h"
+#include <array>
 #include <string>
 
-using std::unordered_map;
+using std::array;
+using std::ostream;
 using std::string;
+using std::string_view;
 
 namespace JackCompiler {
     namespace {
-        const unordered_map<VMWriter::Segment, string> SEGMENT_TO_NAME{
-            { VMWriter::Segment::ARG,     "argument" },
-            { VMWriter::Segment::CONST,   "constant" },
-            { VMWriter::Segment::LOCAL,   "local" },
-            { VMWriter::Segment::POINTER, "pointer" },
-            { VMWriter::Segment::STATIC,  "static" },
-            { VMWriter::Segment::TEMP,    "temp" },
-            { VMWriter::Segment::THAT,    "that" },
-            { VMWriter::Segment::THIS,    "this" }
+        // indexed by VMWriter::Segment
+        constexpr array<string_view, 8> SEGMENT_TO_NAME{
+            "constant", "argument", "local", "static", "this", "that", "pointer", "temp"
         };
 
-        const unordered_map<VMWriter::Command, string> COMMAND_TO_NAME{
-            { VMWriter::Command::ADD, "add" },
-            { VMWriter::Command::AND, "and" },
-            { VMWriter::Command::EQ,  "eq" },
-            { VMWriter::Command::GT,  "gt" },
-            { VMWriter::Command::LT,  "lt" },
-            { VMWriter::Command::NEG, "neg" },
-            { VMWriter::Command::NOT, "not" },
-            { VMWriter::Command::OR,  "or" },
-            { VMWriter::Command::SUB, "sub" },
+        // indexed by VMWriter::Command
+        constexpr array<string_view, 9> COMMAND_TO_NAME{
+            "add", "sub", "neg", "eq", "gt", "lt", "and", "or", "not"
         };
 
+        constexpr string_view segmentToName(VMWriter::Segment segment) {
+            return SEGMENT_TO_NAME[static_cast<size_t>(segment)];
+        }
+
+        constexpr string_view commandToName(VMWriter::Command command) {
+            return COMMAND_TO_NAME[static_cast<size_t>(command)];
+        }
+
+        using InstructionType = VMWriter::Instruction::Type;
+    }
+
+    void VMWriter::reset(ostream& outputStream, OptimizationStatistics* statistics) {
+        outputStream_ = &outputStream;
+        statistics_ = statistics;
+        instructions_.clear();
+        nameArena_.reset();
+        suppressed_ = false;
+        suppressedInstructionCount_ = 0;
+    }
+
+    void VMWriter::writePush(Segment segment, int index) {
+        emit(Instruction::push(segment, index));
+    }
+
+    void VMWriter::writePop(Segment segment, int index) {
+        emit(Instruction::pop(segment, index));
+    }
+
+    void VMWriter::writeArithmetic(Command command) {
+        emit(Instruction::arithmetic(command));
+    }
+
+    void VMWriter::writeLabel(string_view label) {
+        emit(Instruction::label(label));
     }
 
-    void VMWriter::writePush(Segment segment, int index) const {
-        outputStream_ << "push " << SEGMENT_TO_NAME.at(segment) << ' ' << index << '\n';
+    void VMWriter::writeGoto(string_view label) {
+        emit(Instruction::goTo(label));
     }
 
-    void VMWriter::writePop(Segment segment, int index) const {
-        outputStream_ << "pop " << SEGMENT_TO_NAME.at(segment) << ' ' << index << '\n';
+    void VMWriter::writeIf(string_view label) {
+        emit(Instruction::ifGoTo(label));
     }
 
-    void VMWriter::writeArithmetic(Command command) const {
-        outputStream_ << COMMAND_TO_NAME.at(command) << '\n';
+    void VMWriter::writeCall(string_view name, int nArgs) {
+        emit(Instruction::call(name, {}, nArgs));
     }
 
-    void VMWriter::writeLabel(const string& label) const {
-        outputStream_ << "label " << label << '\n';
+    void VMWriter::writeCall(string_view className, string_view subroutineName, int nArgs) {
+        emit(Instruction::call(className, subroutineName, nArgs));
     }
 
-    void VMWriter::writeGoto(const string& label) const {
-        outputStream_ << "goto " << label << '\n';
+    void VMWriter::writeFunction(string_view name, int nLocals) {
+        emit(Instruction::function(name, {}, nLocals));
     }
 
-    void VMWriter::writeIf(const string& label) const {
-        outputStream_ << "if-goto " << label << '\n';
+    void VMWriter::writeFunction(string_view className, string_view subroutineName, int nLocals) {
+        emit(Instruction::function(className, subroutineName, nLocals));
     }
 
-    void VMWriter::writeCall(const string& name, int nArgs) const {
-        outputStream_ << "call " << name << ' ' << nArgs <<  '\n';
+    void VMWriter::writeReturn() {
+        emit(Instruction::returnFromFunction());
     }
 
-    void VMWriter::writeFunction(const string& name, int nLocals) const {
-        outputStream_ << "function " << name << ' ' << nLocals << '\n';
+    void VMWriter::flush() {
+        if(statistics_ == nullptr || instructions_.empty()) {
+            return;
+        }
+
+        PeepholeOptimizer::optimize(instructions_, *statistics_);
+
+        for(const auto& instruction : instructions_) {
+            write(instruction);
+        }
+
+        instructions_.clear();
+        nameArena_.reset();
     }
 
-    void VMWriter::writeReturn() const {
-        outputStream_ << "return\n";
+    void VMWriter::emit(const Instruction& instruction) {
+        if(suppressed_) {
+            ++suppressedInstructionCount_;
+            return;
+        }
+
+        if(statistics_ == nullptr) {
+            write(instruction);
+            return;
+        }
+
+        // labels are local to functions, so every function is optimized on its own
+        if(instruction.type == InstructionType::FUNCTION) {
+            flush();
+        }
+
+        // the names may refer to temporary strings, so they are copied
+        auto& bufferedInstruction = instructions_.emplace_back(instruction);
+        bufferedInstruction.name = nameArena_.copy(instruction.name);
+        bufferedInstruction.subroutineName = nameArena_.copy(instruction.subroutineName);
+    }
+
+    void VMWriter::write(const Instruction& instruction) {
+        switch(instruction.type) {
+            case InstructionType::PUSH:
+                *outputStream_ << "push " << segmentToName(instruction.segment) << ' ' << instruction.value << '\n';
+                break;
+            case InstructionType::POP:
+                *outputStream_ << "pop " << segmentToName(instruction.segment) << ' ' << instruction.value << '\n';
+                break;
+            case InstructionType::ARITHMETIC:
+                *outputStream_ << commandToName(instruction.command) << '\n';
+                break;
+            case InstructionType::LABEL:
+                *outputStream_ << "label " << instruction.name << '\n';
+                break;
+            case InstructionType::GOTO:
+                *outputStream_ << "goto " << instruction.name << '\n';
+                break;
+            case InstructionType::IF_GOTO:
+                *outputStream_ << "if-goto " << instruction.name << '\n';
+                break;
+            case InstructionType::CALL:
+            case InstructionType::FUNCTION:
+                *outputStream_ << (instruction.type == InstructionType::CALL ? "call " : "function ") << instruction.name;
+
+                if(!instruction.subroutineName.empty()) {
+                    *outputStream_ << '.' << instruction.subroutineName;
+                }
+
+                *outputStream_ << ' ' << instruction.value << '\n';
+                break;
+            case InstructionType::RETURN:
+                *outputStream_ << "return\n";
+                break;
+        }
     }
 }
@@ -0,0 +1,293 @@
+#include "ValueNumbering.h"
+#include "ConstantFolding.h"
+#include "HackCost.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
+
+using std::map;
+using std::pair;
+using std::tuple;
+using std::vector;
+
+namespace JackCompiler {
+    namespace {
+        using namespace HackCost;
+
+        enum class ValueKind { CONSTANT, THIS, VARIABLE, MEMORY, ARRAY_ELEMENT, UNARY_OP, BINARY_OP };
+        using ValueKey = tuple<ValueKind, int, int, int, int>;
+
+        struct Occurrence {
+            const Ast::Expression* expression;
+            int value;
+            int cost;
+            // the position of the first expression of the subtree (in the order of evaluation)
+            size_t first;
+            // the number of calls before the expression is evaluated and after its value has been computed
+            size_t callsBefore;
+            size_t callsAfter;
+        };
+
+        /**
+         * \brief Simulates the evaluation of a basic block and numbers the computed values, so that equal
+         * numbers are only assigned to expressions that are known to compute the same value.
+         */
+        class Numbering {
+        public:
+            vector<Occurrence> occurrences;
+
+            void number(const Ast::Statement& statement) {
+                if(const auto* let = statement.as<Ast::LetStatement>()) {
+                    if(let->index != nullptr) {
+                        number(*let->index);
+                    }
+
+                    number(*let->value);
+
+                    const auto segment = let->target->segment;
+
+                    if(let->index == nullptr && (segment == VMWriter::Segment::LOCAL || segment == VMWriter::Segment::ARG)) {
+                        ++versions_[{segment, let->target->index}];
+                    }
+                    else {
+                        // array elements may alias fields (and any other memory)
+                        ++memoryVersion_;
+                    }
+                }
+                else if(const auto* doStatement = statement.as<Ast::DoStatement>()) {
+                    number(*doStatement->call);
+                }
+                else if(const auto* returnStatement = statement.as<Ast::ReturnStatement>()) {
+                    if(returnStatement->value != nullptr) {
+                        number(*returnStatement->value);
+                    }
+                }
+            }
+
+            pair<int, int> number(const Ast::Expression& expression) {
+                const size_t first = occurrences.size();
+                const size_t callsBefore = calls_;
+                int value{};
+                int cost{};
+
+                switch(expression.kind) {
+                    case Ast::Expression::Kind::INT_CONST:
+                    case Ast::Expression::Kind::KEYWORD_CONST:
+                        if(const auto constant = ConstantFolding::valueOf(expression)) {
+                            value = valueOf({ValueKind::CONSTANT, *constant, 0, 0, 0});
+                        }
+                        else {
+                            value = valueOf({ValueKind::THIS, 0, 0, 0, 0});
+                        }
+
+                        cost = PUSH_COST;
+                        break;
+                    case Ast::Expression::Kind::STRING_CONST:
+                        // String.new and String.appendChar are called
+                        ++calls_;
+                        value = uniqueValue();
+                        cost = CALL_COST;
+                        break;
+                    case Ast::Expression::Kind::VARIABLE: {
+                        const auto* variable = expression.as<Ast::Variable>();
+                        value = valueOf(*variable);
+                        cost = variable->segment == VMWriter::Segment::STATIC ? PUSH_COST : INDEXED_PUSH_COST;
+                        break;
+                    }
+                    case Ast::Expression::Kind::ARRAY_ELEMENT: {
+                        const auto* arrayElement = expression.as<Ast::ArrayElement>();
+                        const auto [index, indexCost] = number(*arrayElement->index);
+                        value = valueOf({ValueKind::ARRAY_ELEMENT, valueOf(*arrayElement->array), index, memoryVersion_, 0});
+                        cost = indexCost + ARRAY_ACCESS_COST;
+                        break;
+                    }
+                    case Ast::Expression::Kind::SUBROUTINE_CALL: {
+                        const auto* call = expression.as<Ast::SubroutineCall>();
+
+                        if(call->receiver != nullptr) {
+                            number(*call->receiver);
+                        }
+
+                        for(const auto* argument : call->arguments) {
+                            number(*argument);
+                        }
+
+                        // the callee may assign fields, static variables and array elements
+                        ++calls_;
+                        ++memoryVersion_;
+                        value = uniqueValue();
+                        cost = CALL_COST;
+                        break;
+                    }
+                    case Ast::Expression::Kind::UNARY_OP: {
+                        const auto* unaryOp = expression.as<Ast::UnaryOp>();
+                        const auto [operand, operandCost] = number(*unaryOp->operand);
+                        value = valueOf({ValueKind::UNARY_OP, unaryOp->op, operand, 0, 0});
+                        cost = operandCost + UNARY_ARITHMETIC_COST;
+                        break;
+                    }
+                    case Ast::Expression::Kind::BINARY_OP: {
+                        const auto* binaryOp = expression.as<Ast::BinaryOp>();
+                        auto [left, leftCost] = number(*binaryOp->left);
+                        auto [right, rightCost] = number(*binaryOp->right);
+
+                        switch(binaryOp->op) {
+                            case '*':
+                            case '/':
+                                // Math.multiply and Math.divide do not change the memory of the program
+                                ++calls_;
+                                cost = CALL_COST;
+                                break;
+                            case '<':
+                            case '>':
+                            case '=':
+                                cost = COMPARISON_COST;
+                                break;
+                            default:
+                                cost = BINARY_ARITHMETIC_COST;
+                                break;
+                        }
+
+                        if(binaryOp->op != '-' && binaryOp->op != '/' && binaryOp->op != '<' && binaryOp->op != '>' && left > right) {
+                            std::swap(left, right);
+                        }
+
+                        value = valueOf({ValueKind::BINARY_OP, binaryOp->op, left, right, 0});
+                        cost += leftCost + rightCost;
+                        break;
+                    }
+                }
+
+                occurrences.push_back({&expression, value, cost, first, callsBefore, calls_});
+                return {value, cost};
+            }
+
+        private:
+            map<ValueKey, int> values_;
+            map<pair<VMWriter::Segment, int>, int> versions_;
+            int memoryVersion_{};
+            int nextValue_{};
+            size_t calls_{};
+
+            int valueOf(const ValueKey& key) {
+                return values_.try_emplace(key, nextValue_).second ? nextValue_++ : values_.at(key);
+            }
+
+            int valueOf(const Ast::Variable& variable) {
+                const auto segment = variable.segment;
+
+                if(segment == VMWriter::Segment::LOCAL || segment == VMWriter::Segment::ARG) {
+                    return valueOf({ValueKind::VARIABLE, static_cast<int>(segment), variable.index, versions_[{segment, variable.index}], 0});
+                }
+
+                return valueOf({ValueKind::MEMORY, static_cast<int>(segment), variable.index, memoryVersion_, 0});
+            }
+
+            int uniqueValue() { return nextValue_++; }
+        };
+
+        struct Group {
+            size_t store;
+            vector<size_t> loads;
+        };
+    }
+
+    ValueNumbering::ValueNumbering(const Ast::List<const Ast::Statement*>& statements, const Ast::Expression* condition) {
+        Numbering numbering;
+
+        for(const auto* statement : statements) {
+            numbering.number(*statement);
+        }
+
+        if(condition != nullptr) {
+            numbering.number(*condition);
+        }
+
+        const auto& occurrences = numbering.occurrences;
+
+        map<int, vector<size_t>> valueOccurrences;
+
+        for(size_t i = 0; i < occurrences.size(); ++i) {
+            valueOccurrences[occurrences[i].value].push_back(i);
+        }
+
+        // Larger expressions are considered first, the subexpressions of a reused value are not evaluated again.
+        vector<const vector<size_t>*> candidates;
+
+        for(const auto& [value, positions] : valueOccurrences) {
+            if(positions.size() > 1) {
+                candidates.push_back(&positions);
+            }
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(), [&occurrences] (const auto* lhs, const auto* rhs) {
+            return occurrences[lhs->front()].cost > occurrences[rhs->front()].cost;
+        });
+
+        vector<bool> skipped(occurrences.size());
+        vector<Group> groups;
+
+        for(const auto* positions : candidates) {
+            const int cost = occurrences[positions->front()].cost;
+            vector<Group> valueGroups;
+
+            for(const auto position : *positions) {
+                if(skipped[position]) {
+                    continue;
+                }
+
+                // a value can only be loaded if there has been no call since it has been stored
+                if(valueGroups.empty() || occurrences[valueGroups.back().store].callsAfter != occurrences[position].callsBefore) {
+                    valueGroups.push_back({position, {}});
+                }
+                else {
+                    valueGroups.back().loads.push_back(position);
+                }
+            }
+
+            for(auto& group : valueGroups) {
+                const auto loads = static_cast<int>(group.loads.size());
+
+                if(loads * (cost - PUSH_COST) - (POP_COST + PUSH_COST) <= 0) {
+                    continue;
+                }
+
+                for(const auto load : group.loads) {
+                    std::fill(skipped.begin() + static_cast<std::ptrdiff_t>(occurrences[load].first),
+                        skipped.begin() + static_cast<std::ptrdiff_t>(load), true);
+                }
+
+                groups.push_back(std::move(group));
+            }
+        }
+
+        // the temp-variables are allocated in the order in which the values are stored
+        std::sort(groups.begin(), groups.end(), [] (const Group& lhs, const Group& rhs) { return lhs.store < rhs.store; });
+
+        // the position of the last load of the value each temp-variable holds
+        vector<size_t> lastLoads(LAST_TEMP_INDEX + 1);
+        vector<bool> allocated(LAST_TEMP_INDEX + 1);
+
+        for(const auto& group : groups) {
+            int tempIndex = FIRST_TEMP_INDEX;
+
+            while(tempIndex <= LAST_TEMP_INDEX && allocated[tempIndex] && lastLoads[tempIndex] > group.store) {
+                ++tempIndex;
+            }
+
+            // without a free temp-variable the value is computed again
+            if(tempIndex > LAST_TEMP_INDEX) {
+                continue;
+            }
+
+            allocated[tempIndex] = true;
+            lastLoads[tempIndex] = group.loads.back();
+            reuses_.emplace(occurrences[group.store].expression, Reuse{false, tempIndex});
+
+            for(const auto load : group.loads) {
+                reuses_.emplace(occurrences[load].expression, Reuse{true, tempIndex});
+            }
+        }
+    }
+}
@@ -1,14 +1,249 @@
 #include "JackCompiler.h"
+#include "CompileServer.h"
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
 
 using std::cout;
+using std::cin;
 using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+    // the number of statements and expressions of inlined subroutines if --inline has no value
+    constexpr size_t DEFAULT_INLINE_THRESHOLD = 8;
+    const string INLINE_OPTION{"--inline="};
+    const string MAX_ERRORS_OPTION{"--max-errors="};
+    const string JOBS_OPTION{"--jobs="};
+    const string CACHE_DIRECTORY_OPTION{"--cache-dir="};
+    const string CACHE_SIZE_OPTION{"--cache-size="};
+    // sets the cache directory if --cache-dir is not used
+    constexpr const char* CACHE_DIRECTORY_VARIABLE = "JACK_COMPILER_CACHE_DIR";
+    constexpr std::uintmax_t MEGABYTE = 1024 * 1024;
+    const string SERVE_OPTION{"--serve="};
+    const string SERVER_OPTION{"--server="};
+    const string IDLE_TIMEOUT_OPTION{"--idle-timeout="};
+
+    void printUsage() {
+        cout << "Usage: JackCompiler [options] <<filename>.jack OR <directoryName> OR - (stdin to stdout)>\n"
+                "Options:\n"
+                "  --ast         Parse each class into an abstract syntax tree before generating code\n"
+                "  --peephole    Remove redundant VM instructions with a peephole optimizer\n"
+                "  --fold-constants\n"
+                "                Evaluate operations on compile-time constants at compile-time\n"
+                "  --reduce-strength\n"
+                "                Replace multiplications and divisions by constants with cheaper instructions\n"
+                "  --pool-strings\n"
+                "                Build each distinct string constant of a class only once\n"
+                "  --eliminate-dead-code\n"
+                "                Generate no code for unreachable statements and constant conditions\n"
+                "  --compact-control-flow\n"
+                "                Lower if- and while-statements with a single conditional jump\n"
+                "  --optimize-array-access\n"
+                "                Access array elements with constant indices without computing addresses\n"
+                "  --eliminate-common-subexpressions\n"
+                "                Reuse values computed several times within a basic block\n"
+                "  --inline[=<size>]\n"
+                "                Inline subroutines with at most <size> statements and expressions (default: "
+             << DEFAULT_INLINE_THRESHOLD << ")\n"
+                "  --eliminate-dead-subroutines\n"
+                "                Generate no code for subroutines that are unreachable from Main.main (directories only)\n"
+                "  --max-errors=<count>\n"
+                "                Stop the compilation after <count> errors (default: report all errors)\n"
+                "  --jobs=<count>\n"
+                "                Compile the files of a directory on <count> threads (default: one per hardware thread)\n"
+                "  --incremental Skip files that have not changed since the last compilation\n"
+                "  --cache-dir=<directory>\n"
+                "                Share the outputs of identical sources through a cache directory (default: $"
+             << CACHE_DIRECTORY_VARIABLE << ")\n"
+                "  --cache-size=<megabytes>\n"
+                "                Remove the least recently used outputs above this size (default: "
+             << JackCompiler::CompilationOptions{}.cacheSize / MEGABYTE << ")\n"
+                "  --serve=<socket>\n"
+                "                Run a compile-server on a Unix domain socket instead of compiling (no input path)\n"
+                "  --idle-timeout=<seconds>\n"
+                "                Stop the compile-server after <seconds> without requests (default: "
+             << std::chrono::duration_cast<std::chrono::seconds>(JackCompiler::CompileServer::DEFAULT_IDLE_TIMEOUT).count() << ")\n"
+                "  --server=<socket>\n"
+                "                Send the compilation to the compile-server listening on <socket>\n"
+                "  --watch       Compile a directory and compile changed files again until interrupted (Linux only)" << endl;
+    }
+}
 
 int main(int argc, char** argv) {
-    if(argc == 2) {
-        return JackCompiler::compile(argv[1]);
+    JackCompiler::CompilationOptions options;
+    vector<string> inputPathNames;
+    string serveSocketPath;
+    string serverSocketPath;
+    std::chrono::milliseconds idleTimeout{JackCompiler::CompileServer::DEFAULT_IDLE_TIMEOUT};
+    bool watch = false;
+
+    for(auto i = 1; i < argc; ++i) {
+        const string argument{argv[i]};
+
+        if(argument == "--ast") {
+            options.buildAst = true;
+        }
+        else if(argument == "--peephole") {
+            options.peephole = true;
+        }
+        else if(argument == "--fold-constants") {
+            options.foldConstants = true;
+        }
+        else if(argument == "--reduce-strength") {
+            options.reduceStrength = true;
+        }
+        else if(argument == "--pool-strings") {
+            options.poolStrings = true;
+        }
+        else if(argument == "--eliminate-dead-code") {
+            options.eliminateDeadCode = true;
+        }
+        else if(argument == "--eliminate-common-subexpressions") {
+            options.eliminateCommonSubexpressions = true;
+        }
+        else if(argument == "--optimize-array-access") {
+            options.optimizeArrayAccess = true;
+        }
+        else if(argument == "--compact-control-flow") {
+            options.compactControlFlow = true;
+        }
+        else if(argument == "--eliminate-dead-subroutines") {
+            options.eliminateDeadSubroutines = true;
+        }
+        else if(argument == "--incremental") {
+            options.incremental = true;
+        }
+        else if(argument == "--watch") {
+            watch = true;
+        }
+        else if(argument == "--inline") {
+            options.inlineThreshold = DEFAULT_INLINE_THRESHOLD;
+        }
+        else if(argument.compare(0, INLINE_OPTION.size(), INLINE_OPTION) == 0) {
+            const auto value = argument.substr(INLINE_OPTION.size());
+
+            if(value.empty() || value.size() > 4 || value.find_first_not_of("0123456789") != string::npos || std::stoul(value) == 0) {
+                cout << "Invalid size in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+
+            options.inlineThreshold = std::stoul(value);
+        }
+        else if(argument.compare(0, MAX_ERRORS_OPTION.size(), MAX_ERRORS_OPTION) == 0) {
+            const auto value = argument.substr(MAX_ERRORS_OPTION.size());
+
+            if(value.empty() || value.size() > 6 || value.find_first_not_of("0123456789") != string::npos || std::stoul(value) == 0) {
+                cout << "Invalid count in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+
+            options.maxErrors = std::stoul(value);
+        }
+        else if(argument.compare(0, JOBS_OPTION.size(), JOBS_OPTION) == 0) {
+            const auto value = argument.substr(JOBS_OPTION.size());
+
+            if(value.empty() || value.size() > 4 || value.find_first_not_of("0123456789") != string::npos || std::stoul(value) == 0) {
+                cout << "Invalid count in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+
+            options.jobs = std::stoul(value);
+        }
+        else if(argument.compare(0, CACHE_DIRECTORY_OPTION.size(), CACHE_DIRECTORY_OPTION) == 0) {
+            options.cacheDirectory = argument.substr(CACHE_DIRECTORY_OPTION.size());
+
+            if(options.cacheDirectory.empty()) {
+                cout << "Missing directory in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+        }
+        else if(argument.compare(0, CACHE_SIZE_OPTION.size(), CACHE_SIZE_OPTION) == 0) {
+            const auto value = argument.substr(CACHE_SIZE_OPTION.size());
+
+            if(value.empty() || value.size() > 6 || value.find_first_not_of("0123456789") != string::npos || std::stoul(value) == 0) {
+                cout << "Invalid size in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+
+            options.cacheSize = std::stoul(value) * MEGABYTE;
+        }
+        else if(argument.compare(0, SERVE_OPTION.size(), SERVE_OPTION) == 0) {
+            serveSocketPath = argument.substr(SERVE_OPTION.size());
+        }
+        else if(argument.compare(0, SERVER_OPTION.size(), SERVER_OPTION) == 0) {
+            serverSocketPath = argument.substr(SERVER_OPTION.size());
+
+            if(serverSocketPath.empty()) {
+                cout << "Missing socket in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+        }
+        else if(argument.compare(0, IDLE_TIMEOUT_OPTION.size(), IDLE_TIMEOUT_OPTION) == 0) {
+            const auto value = argument.substr(IDLE_TIMEOUT_OPTION.size());
+
+            if(value.empty() || value.size() > 6 || value.find_first_not_of("0123456789") != string::npos || std::stoul(value) == 0) {
+                cout << "Invalid timeout in option \"" << argument << "\"." << endl;
+                printUsage();
+                return -1;
+            }
+
+            idleTimeout = std::chrono::seconds{std::stoul(value)};
+        }
+        else if(argument.size() > 2 && argument.compare(0, 2, "--") == 0) {
+            cout << "Unknown option \"" << argument << "\"." << endl;
+            printUsage();
+            return -1;
+        }
+        else {
+            inputPathNames.push_back(argument);
+        }
+    }
+
+    if(const auto* cacheDirectory = std::getenv(CACHE_DIRECTORY_VARIABLE); options.cacheDirectory.empty() && cacheDirectory != nullptr) {
+        options.cacheDirectory = cacheDirectory;
+    }
+
+    if(!serveSocketPath.empty() && inputPathNames.empty()) {
+        return JackCompiler::CompileServer::serve(serveSocketPath, options, idleTimeout, cout);
+    }
+
+    if(inputPathNames.size() != 1 || !serveSocketPath.empty()) {
+        cout << "Wrong number of arguments." << endl;
+        printUsage();
+        return -1;
+    }
+
+    // the compile-server compiles directories and files, it neither watches them nor reads stdin
+    if(!serverSocketPath.empty() && (watch || inputPathNames.front() == "-")) {
+        cout << "The option \"" << SERVER_OPTION << "<socket>\" cannot be combined with " 
+             << (watch ? "\"--watch\"" : "stdin (-)") << "." << endl;
+        printUsage();
+        return -1;
+    }
+
+    if(watch) {
+        return JackCompiler::watch(inputPathNames.front(), options, cout);
+    }
+
+    if(inputPathNames.front() == "-") {
+        // stream mode: read Jack code from stdin and write VM code to stdout
+        std::ios::sync_with_stdio(false);
+        return JackCompiler::compile(cin, cout, options);
+    }
+
+    if(!serverSocketPath.empty()) {
+        return JackCompiler::CompileServer::request(serverSocketPath, inputPathNames.front(), options, cout);
     }
 
-    cout << "Wrong number of arguments: Usage: JackCompiler <<filename>.jack OR <directoryName>>" << endl;
-    return -1;
+    return JackCompiler::compile(inputPathNames.front(), options);
 }
@@ -0,0 +1,50 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> allocationCounter{0};
+
+    void* countedAllocation(size_t size) {
+        allocationCounter.fetch_add(1, std::memory_order_relaxed);
+
+        if(auto* const memory = std::malloc(size != 0 ? size : 1)) {
+            return memory;
+        }
+
+        throw std::bad_alloc{};
+    }
+}
+
+namespace AllocationCounter {
+    size_t allocationCount() {
+        return allocationCounter.load(std::memory_order_relaxed);
+    }
+}
+
+// Replacements of the global allocation functions, the array- and nothrow-versions
+// forward to these by default.
+void* operator new(size_t size) {
+    return countedAllocation(size);
+}
+
+void* operator new[](size_t size) {
+    return countedAllocation(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    std::free(memory);
+}
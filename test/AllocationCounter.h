@@ -0,0 +1,11 @@
+#pragma once
+#include <cstddef>
+
+namespace AllocationCounter {
+    /**
+     * \brief Gets the number of heap-allocations (calls of the global operator new) performed by the
+     * test-program so far.
+     * \return The number of allocations
+     */
+    size_t allocationCount();
+}
@@ -0,0 +1,103 @@
+#include "CompilationEngine.h"
+#include "MappedFile.h"
+#include "AllocationCounter.h"
+#include "TestFiles.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <streambuf>
+#include <unordered_set>
+#include <filesystem>
+
+using std::vector;
+using std::string;
+using std::string_view;
+using std::ifstream;
+using std::ostream;
+using std::streambuf;
+using std::streamsize;
+using std::unordered_set;
+using JackCompiler::CompilationEngine;
+using JackCompiler::MappedFile;
+using JackCompiler::Tokenizer;
+namespace fs = std::filesystem;
+
+namespace {
+    /**
+     * \brief A stream-buffer that discards all output, so that the growth of an output-buffer
+     * does not contribute to the counted allocations.
+     */
+    class DiscardingStreamBuffer : public streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char*, streamsize count) override { return count; }
+    };
+
+    const vector<string> ALLOCATION_TEST_FILE_NAMES{
+        "PongGame.jack",
+        "SquareGame.jack"
+    };
+
+    class AllocationTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that compiles an input-file <filename>.jack from a memory-mapped buffer and from
+     * an input-stream while counting the performed heap-allocations. Identifiers are never copied when compiling from
+     * a buffer and are interned when compiling from a stream, so in both cases the number of allocations must not depend
+     * on how often identifiers occur in the file.
+     */
+    TEST_P(AllocationTest, IdentifiersAreNotAllocatedPerOccurrence) {
+        const fs::path inputPath{testFilesPath + GetParam()};
+
+        const MappedFile inputFile{inputPath};
+        ASSERT_TRUE(inputFile) << "The test-file " << inputPath << " could not be mapped.";
+
+        size_t identifierOccurrences{};
+        unordered_set<string_view> distinctIdentifiers;
+
+        for(Tokenizer tokenizer{inputFile.data()}; tokenizer.hasMoreTokens();) {
+            tokenizer.advance();
+
+            if(tokenizer.tokenType() == Tokenizer::TokenType::IDENTIFIER) {
+                ++identifierOccurrences;
+                distinctIdentifiers.insert(tokenizer.identifier());
+            }
+        }
+
+        DiscardingStreamBuffer discardingStreamBuffer;
+        ostream outputStream{&discardingStreamBuffer};
+
+        const auto allocationsBeforeBufferCompilation = AllocationCounter::allocationCount();
+        {
+            CompilationEngine engine{inputFile.data(), outputStream};
+            engine.compileClass();
+        }
+        const auto bufferCompilationAllocations = AllocationCounter::allocationCount() - allocationsBeforeBufferCompilation;
+
+        ifstream inputStream{inputPath};
+        const auto allocationsBeforeStreamCompilation = AllocationCounter::allocationCount();
+        {
+            CompilationEngine engine{inputStream, outputStream};
+            engine.compileClass();
+        }
+        const auto streamCompilationAllocations = AllocationCounter::allocationCount() - allocationsBeforeStreamCompilation;
+
+        RecordProperty("IdentifierOccurrences", static_cast<int>(identifierOccurrences));
+        RecordProperty("DistinctIdentifiers", static_cast<int>(distinctIdentifiers.size()));
+        RecordProperty("BufferCompilationAllocations", static_cast<int>(bufferCompilationAllocations));
+        RecordProperty("StreamCompilationAllocations", static_cast<int>(streamCompilationAllocations));
+
+        // Allocations left when compiling from a buffer are symbol-table entries and hash-table buckets.
+        ASSERT_LT(bufferCompilationAllocations, distinctIdentifiers.size());
+        // Interning adds at most one allocation per distinct identifier, some hash-table buckets and
+        // the interner's arena-blocks. The two fixed-size chunk-buffers are allocated once each and only
+        // grow by the remainder of a chunk that is carried over into the next one.
+        ASSERT_LT(streamCompilationAllocations, bufferCompilationAllocations + distinctIdentifiers.size() + 32);
+        ASSERT_LT(streamCompilationAllocations, identifierOccurrences);
+    }
+
+    INSTANTIATE_TEST_CASE_P(AllocationTestInstance, AllocationTest, ::testing::ValuesIn(ALLOCATION_TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
@@ -0,0 +1,123 @@
+#include "TestCompilation.h"
+#include "VMInterpreter.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+using JackCompiler::CompilationOptions;
+using TestCompilation::compile;
+
+namespace {
+    CompilationOptions arrayAccessOptions() {
+        CompilationOptions options;
+        options.optimizeArrayAccess = true;
+        return options;
+    }
+
+    TEST(ArrayAccessTest, AccessesConstantIndices) {
+        const string jackCode{"class Main {"
+                              "  function int f(Array a, Array b) {"
+                              "    let a[2] = a[0] + a[1];"
+                              "    return (b[0] * a[3]) + b[1];"
+                              "  } }"};
+
+        ASSERT_EQ("function Main.f 0\n"
+                  "push argument 0\n"
+                  "pop pointer 1\n"
+                  "push that 0\n"
+                  "push that 1\n"
+                  "add\n"
+                  "pop that 2\n"
+                  "push argument 1\n"
+                  "pop pointer 1\n"
+                  "push that 0\n"
+                  "push argument 0\n"
+                  "pop pointer 1\n"
+                  "push that 3\n"
+                  "call Math.multiply 2\n"
+                  "push argument 1\n"
+                  "pop pointer 1\n"
+                  "push that 1\n"
+                  "add\n"
+                  "return\n", compile(jackCode, arrayAccessOptions()));
+    }
+
+    TEST(ArrayAccessTest, AssignsWithoutTemp) {
+        const string jackCode{"class Main {"
+                              "  function void f(Array a, int i) {"
+                              "    let a[i + 1] = i * 2;"
+                              "    let a[i] = a[i + 1];"
+                              "    let a[0] = a[i];"
+                              "    return;"
+                              "  } }"};
+
+        const string referenceOutput = compile(jackCode);
+        const string output = compile(jackCode, arrayAccessOptions());
+
+        // values that access arrays are still saved in temp 0, unless only constant elements of the assigned array are accessed
+        ASSERT_EQ("function Main.f 0\n"
+                  "push argument 1\n"
+                  "push constant 1\n"
+                  "add\n"
+                  "push argument 0\n"
+                  "add\n"
+                  "pop pointer 1\n"
+                  "push argument 1\n"
+                  "push constant 2\n"
+                  "call Math.multiply 2\n"
+                  "pop that 0\n", output.substr(0, output.find("push argument 1\npush argument 0")));
+        ASSERT_NE(string::npos, output.find("pop temp 0"));
+        ASSERT_EQ(referenceOutput.substr(referenceOutput.find("push argument 1\npush argument 0")), 
+                  output.substr(output.find("push argument 1\npush argument 0")));
+    }
+
+    TEST(ArrayAccessTest, ReloadsPointerAfterCalls) {
+        // the called subroutine may assign another array to the static variable
+        const string jackCode{"class Main {"
+                              "  static Array a;"
+                              "  function int f() { return a[0] + Main.g() + a[1]; }"
+                              "  function int g() { let a = Array.new(2); return 0; } }"};
+
+        const string output = compile(jackCode, arrayAccessOptions());
+
+        ASSERT_NE(string::npos, output.find("call Main.g 0\n"
+                                            "add\n"
+                                            "push static 0\n"
+                                            "pop pointer 1\n"
+                                            "push that 1\n"));
+    }
+
+    TEST(ArrayAccessTest, PreservesSemantics) {
+        const auto jackCode = TestCompilation::readTestFile("ComplexArraysMain.jack");
+
+        VMInterpreter referenceInterpreter;
+        referenceInterpreter.load("Main", compile(jackCode));
+        referenceInterpreter.call("Main.main");
+
+        VMInterpreter interpreter;
+        interpreter.load("Main", compile(jackCode, arrayAccessOptions()));
+        interpreter.call("Main.main");
+
+        ASSERT_EQ(referenceInterpreter.output(), interpreter.output());
+        ASSERT_LT(interpreter.executedInstructions(), referenceInterpreter.executedInstructions());
+    }
+
+    class ArrayAccessTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with optimized array access. The difference between the length of the reference output and the output
+     * must equal the number of removed instructions reported by the statistics.
+     */
+    TEST_P(ArrayAccessTest, ReportsRemovedInstructions) {
+        const auto jackCode = TestCompilation::readTestFile(GetParam());
+        JackCompiler::OptimizationStatistics statistics;
+        const auto output = compile(jackCode, arrayAccessOptions(), &statistics);
+
+        ASSERT_EQ(TestCompilation::countLines(compile(jackCode)), 
+            TestCompilation::countLines(output) + static_cast<long>(statistics.count("array access")));
+    }
+
+    INSTANTIATE_TEST_CASE_P(ArrayAccessTestInstance, ArrayAccessTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
@@ -0,0 +1,157 @@
+#include "CallGraph.h"
+#include "CompilationEngine.h"
+#include "Inliner.h"
+#include "VMInterpreter.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::stringstream;
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+using JackCompiler::CallGraph;
+using JackCompiler::CompilationEngine;
+
+namespace {
+    const vector<string> PROGRAM{
+        "class Main {"
+        "  function int main() { var Util u; let u = Util.new(); return u.twice(Math.abs(-3)) + Main.helper(); }"
+        "  function int helper() { return 1; }"
+        "  function int unused() { return Util.unused(); }"
+        "}",
+        "class Util {"
+        "  constructor Util new() { return this; }"
+        "  method int twice(int x) { return x * 2; }"
+        "  function int unused() { return Main.unused(); }"
+        "}",
+        "class Math {"
+        "  function int abs(int x) { if(x < 0) { return -x; } return x; }"
+        "  function int multiply(int x, int y) { var int sum; while(y > 0) { let sum = sum + x; let y = y - 1; } return sum; }"
+        "  function int divide(int x, int y) { return 0; }"
+        "}"
+    };
+
+    struct CompiledProgram {
+        vector<string> vmCode;
+        string report;
+        size_t removedInstructions{};
+    };
+
+    CompiledProgram compileProgram(bool eliminateDeadSubroutines) {
+        vector<unique_ptr<stringstream>> outputStreams;
+        vector<unique_ptr<CompilationEngine>> engines;
+        vector<const JackCompiler::Ast::Class*> classes;
+
+        for(const auto& source : PROGRAM) {
+            outputStreams.push_back(make_unique<stringstream>());
+            engines.push_back(make_unique<CompilationEngine>(source, *outputStreams.back()));
+            classes.push_back(&engines.back()->parseClass());
+        }
+
+        const CallGraph callGraph{classes};
+        CompiledProgram program;
+        stringstream reportStream;
+        callGraph.printReport(reportStream);
+        program.report = reportStream.str();
+
+        for(size_t i = 0; i < engines.size(); ++i) {
+            engines[i]->lowerClass(*classes[i], nullptr, eliminateDeadSubroutines ? &callGraph : nullptr);
+            program.vmCode.push_back(outputStreams[i]->str());
+            program.removedInstructions += engines[i]->statistics().count("unreachable subroutine");
+        }
+
+        return program;
+    }
+
+    size_t countLines(const vector<string>& vmCode) {
+        size_t lines{};
+
+        for(const auto& code : vmCode) {
+            lines += static_cast<size_t>(std::count(code.cbegin(), code.cend(), '\n'));
+        }
+
+        return lines;
+    }
+
+    TEST(CallGraphTest, RemovesUnreachableSubroutines) {
+        const auto program = compileProgram(true);
+
+        ASSERT_EQ("Reachability (from Main.main): 6 of 9 subroutines reachable\n"
+                  "  unreachable: Main.unused\n"
+                  "  unreachable: Math.divide\n"
+                  "  unreachable: Util.unused\n", program.report);
+
+        ASSERT_EQ(string::npos, program.vmCode[0].find("function Main.unused"));
+        ASSERT_EQ(string::npos, program.vmCode[1].find("function Util.unused"));
+        ASSERT_EQ(string::npos, program.vmCode[2].find("function Math.divide"));
+
+        // multiplications call Math.multiply
+        ASSERT_NE(string::npos, program.vmCode[2].find("function Math.multiply"));
+
+        ASSERT_EQ(countLines(compileProgram(false).vmCode), countLines(program.vmCode) + program.removedInstructions);
+    }
+
+    TEST(CallGraphTest, PreservesSemantics) {
+        VMInterpreter interpreter;
+        const auto program = compileProgram(true);
+
+        interpreter.load("Main", program.vmCode[0]);
+        interpreter.load("Util", program.vmCode[1]);
+        interpreter.load("Math", program.vmCode[2]);
+
+        ASSERT_EQ(7, interpreter.call("Main.main"));
+    }
+
+    TEST(CallGraphTest, CreditsCallsOfInlinedBodiesToCaller) {
+        const vector<string> program{
+            "class Main {"
+            "  function int main() { return Main.square(3); }"
+            "  function int square(int x) { return x * x; }"
+            "}",
+            "class Math {"
+            "  function int multiply(int x, int y) { var int sum; while(y > 0) { let sum = sum + x; let y = y - 1; } return sum; }"
+            "}"
+        };
+
+        vector<unique_ptr<stringstream>> outputStreams;
+        vector<unique_ptr<CompilationEngine>> engines;
+        vector<const JackCompiler::Ast::Class*> classes;
+
+        for(const auto& source : program) {
+            outputStreams.push_back(make_unique<stringstream>());
+            engines.push_back(make_unique<CompilationEngine>(source, *outputStreams.back()));
+            classes.push_back(&engines.back()->parseClass());
+        }
+
+        const JackCompiler::Inliner inliner{classes, 8};
+        const CallGraph callGraph{classes, &inliner};
+
+        // the multiplication of the inlined Main.square is made by Main.main
+        ASSERT_TRUE(callGraph.isReachable(*classes[1]->subroutines[0]));
+
+        VMInterpreter interpreter;
+
+        for(size_t i = 0; i < engines.size(); ++i) {
+            engines[i]->lowerClass(*classes[i], &inliner, &callGraph);
+            interpreter.load(string{classes[i]->name}, outputStreams[i]->str());
+        }
+
+        ASSERT_EQ(string::npos, outputStreams[0]->str().find("call Main.square"));
+        ASSERT_EQ(9, interpreter.call("Main.main"));
+    }
+
+    TEST(CallGraphTest, KeepsAllSubroutinesWithoutEntryPoint) {
+        stringstream outputStream;
+        CompilationEngine engine{"class Util { function int f() { return 1; } }", outputStream};
+        const auto& astClass = engine.parseClass();
+        const CallGraph callGraph{{&astClass}};
+
+        ASSERT_FALSE(callGraph.hasEntryPoint());
+        ASSERT_TRUE(callGraph.isReachable(*astClass.subroutines[0]));
+    }
+}
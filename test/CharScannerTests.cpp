@@ -0,0 +1,94 @@
+#include "CharScanner.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <string_view>
+
+using std::string;
+using std::string_view;
+namespace CharScanner = JackCompiler::CharScanner;
+
+namespace {
+    /**
+     * \brief Creates random texts consisting of the bytes the scanning-functions are looking for, so that
+     * matches occur at all positions of the SIMD-chunks as well as in the scalar tails.
+     */
+    class RandomTextGenerator {
+    public:
+        string operator()() {
+            static constexpr string_view ALPHABET{"    \t\n\r*/\"a"};
+            std::uniform_int_distribution<size_t> lengthDistribution{0, 100};
+            std::uniform_int_distribution<size_t> charDistribution{0, ALPHABET.size() - 1};
+
+            string text(lengthDistribution(randomEngine_), ' ');
+
+            for(auto& c : text) {
+                c = ALPHABET[charDistribution(randomEngine_)];
+            }
+
+            return text;
+        }
+
+    private:
+        std::mt19937 randomEngine_{42};
+    };
+
+    constexpr size_t NR_RANDOM_TEXTS = 500;
+
+    TEST(CharScannerTest, SkipWhitespaceMatchesScalarImplementation) {
+        RandomTextGenerator generateText;
+
+        for(size_t i = 0; i != NR_RANDOM_TEXTS; ++i) {
+            const auto text = generateText();
+
+            for(size_t pos = 0; pos <= text.size(); ++pos) {
+                size_t newlineCount{};
+                size_t scalarNewlineCount{};
+
+                ASSERT_EQ(CharScanner::Scalar::skipWhitespace(text, pos, scalarNewlineCount),
+                          CharScanner::skipWhitespace(text, pos, newlineCount)) << ">>" << text << "<< at " << pos;
+                ASSERT_EQ(scalarNewlineCount, newlineCount) << ">>" << text << "<< at " << pos;
+            }
+        }
+    }
+
+    TEST(CharScannerTest, FindMatchesScalarImplementation) {
+        RandomTextGenerator generateText;
+
+        for(size_t i = 0; i != NR_RANDOM_TEXTS; ++i) {
+            const auto text = generateText();
+
+            for(size_t pos = 0; pos <= text.size(); ++pos) {
+                ASSERT_EQ(CharScanner::Scalar::find(text, pos, '\n'), CharScanner::find(text, pos, '\n'))
+                    << ">>" << text << "<< at " << pos;
+                ASSERT_EQ(CharScanner::Scalar::findEither(text, pos, '\"', '\n'), CharScanner::findEither(text, pos, '\"', '\n'))
+                    << ">>" << text << "<< at " << pos;
+            }
+        }
+    }
+
+    TEST(CharScannerTest, FindBlockCommentEndMatchesScalarImplementation) {
+        RandomTextGenerator generateText;
+
+        for(size_t i = 0; i != NR_RANDOM_TEXTS; ++i) {
+            const auto text = generateText();
+
+            for(size_t pos = 0; pos <= text.size(); ++pos) {
+                size_t newlineCount{};
+                size_t scalarNewlineCount{};
+
+                ASSERT_EQ(CharScanner::Scalar::findBlockCommentEnd(text, pos, scalarNewlineCount),
+                          CharScanner::findBlockCommentEnd(text, pos, newlineCount)) << ">>" << text << "<< at " << pos;
+                ASSERT_EQ(scalarNewlineCount, newlineCount) << ">>" << text << "<< at " << pos;
+            }
+        }
+    }
+
+    TEST(CharScannerTest, FindBlockCommentEndCountsNewlines) {
+        const string text{"/* first line\n\n   *\n / third line */ class"};
+        size_t newlineCount{};
+
+        ASSERT_EQ(text.find("*/"), CharScanner::findBlockCommentEnd(text, 2, newlineCount));
+        ASSERT_EQ(3, newlineCount);
+    }
+}
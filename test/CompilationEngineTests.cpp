@@ -1,4 +1,7 @@
 #include "CompilationEngine.h"
+#include "MappedFile.h"
+#include "TokenBuffer.h"
+#include "TestFiles.h"
 #include <gtest/gtest.h>
 #include <vector>
 #include <string>
@@ -12,25 +15,13 @@ using std::ostream;
 using std::ifstream;
 using std::istreambuf_iterator;
 using std::stringstream;
+using std::string_view;
+using JackCompiler::Tokenizer;
+using JackCompiler::VMWriter;
+namespace Ast = JackCompiler::Ast;
 namespace fs = std::filesystem;
 
-extern string testFilesPath;
-
 namespace {
-    const vector<string> TEST_FILE_NAMES{
-        "AverageMain.jack",
-        "ComplexArraysMain.jack",
-        "ConvertToBinMain.jack",
-        "PongBall.jack",
-        "PongBat.jack",
-        "PongGame.jack",
-        "PongMain.jack",
-        "SevenMain.jack",
-        "Square.jack",
-        "SquareGame.jack",
-        "SquareMain.jack"
-    };
-
     class CompilationEngineTest : public testing::TestWithParam<string> {};
 
     /**
@@ -61,8 +52,89 @@ namespace {
         engine.compileClass();
 
         ASSERT_EQ(referenceOutput, outputStream.str());
+
+        // compiling directly from the memory-mapped file must produce the same output
+        const JackCompiler::MappedFile mappedInputFile{inputPath};
+        ASSERT_TRUE(mappedInputFile) << "The test-file " << inputPath << " could not be mapped.";
+
+        stringstream mappedOutputStream;
+        JackCompiler::CompilationEngine mappedEngine{mappedInputFile.data(), mappedOutputStream};
+        mappedEngine.compileClass();
+
+        ASSERT_EQ(referenceOutput, mappedOutputStream.str());
+
+        // compiling from the pre-lexed token-buffer must produce the same output
+        const JackCompiler::TokenBuffer tokenBuffer{mappedInputFile.data()};
+
+        stringstream tokenBufferOutputStream;
+        JackCompiler::CompilationEngine tokenBufferEngine{tokenBuffer, tokenBufferOutputStream};
+        tokenBufferEngine.compileClass();
+
+        ASSERT_EQ(referenceOutput, tokenBufferOutputStream.str());
+
+        // lowering the abstract syntax tree must produce the same output
+        JackCompiler::CompilationOptions astOptions;
+        astOptions.buildAst = true;
+
+        stringstream astOutputStream;
+        JackCompiler::CompilationEngine astEngine{tokenBuffer, astOutputStream, astOptions};
+        astEngine.compileClass();
+
+        ASSERT_EQ(referenceOutput, astOutputStream.str());
+    }
+
+    TEST(CompilationEngineAstTest, ParsesClassIntoAst) {
+        const string input{"class Main {\n"
+                           "    field int x;\n"
+                           "    method int f(int a) { var Array b; let b[a] = x + (a * 2); return b[0]; }\n"
+                           "    function void g() { do Output.printInt(1); if(true) { return; } else { return; } }\n"
+                           "}"};
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{string_view{input}, outputStream};
+
+        const auto& astClass = engine.parseClass();
+
+        ASSERT_EQ("Main", astClass.name);
+        ASSERT_EQ(1, astClass.nFields);
+        ASSERT_EQ(2, astClass.subroutines.size());
+        ASSERT_TRUE(outputStream.str().empty());
+
+        const auto& method = *astClass.subroutines[0];
+        ASSERT_EQ(Tokenizer::KeyWordType::METHOD, method.type);
+        ASSERT_EQ(2, method.nArgs);
+        ASSERT_EQ(1, method.nLocals);
+        ASSERT_EQ(2, method.statements.size());
+
+        const auto* let = method.statements[0]->as<Ast::LetStatement>();
+        ASSERT_NE(nullptr, let);
+        ASSERT_EQ(VMWriter::Segment::LOCAL, let->target->segment);
+        ASSERT_EQ(VMWriter::Segment::ARG, let->index->as<Ast::Variable>()->segment);
+        ASSERT_EQ(1, let->index->as<Ast::Variable>()->index);
+
+        // no operator precedence: x + (a * 2)
+        const auto* sum = let->value->as<Ast::BinaryOp>();
+        ASSERT_NE(nullptr, sum);
+        ASSERT_EQ('+', sum->op);
+        ASSERT_EQ(VMWriter::Segment::THIS, sum->left->as<Ast::Variable>()->segment);
+        ASSERT_EQ('*', sum->right->as<Ast::BinaryOp>()->op);
+
+        const auto& function = *astClass.subroutines[1];
+        const auto* call = function.statements[0]->as<Ast::DoStatement>()->call;
+        ASSERT_EQ("Output", call->className);
+        ASSERT_EQ("printInt", call->subroutineName);
+        ASSERT_EQ(nullptr, call->receiver);
+        ASSERT_EQ(1, call->arguments.size());
+        ASSERT_TRUE(function.statements[1]->as<Ast::IfStatement>()->hasElse);
+
+        engine.lowerClass(astClass);
+
+        stringstream directOutputStream;
+        JackCompiler::CompilationEngine directEngine{string_view{input}, directOutputStream};
+        directEngine.compileClass();
+
+        ASSERT_EQ(directOutputStream.str(), outputStream.str());
     }
 
-    INSTANTIATE_TEST_CASE_P(CompilationEngineTestInstance, CompilationEngineTest, ::testing::ValuesIn(TEST_FILE_NAMES), 
-        [] (const ::testing::TestParamInfo<string>& info) { return info.param.substr(0, info.param.find('.')); });
+    INSTANTIATE_TEST_CASE_P(CompilationEngineTestInstance, CompilationEngineTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES), 
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
 }
\ No newline at end of file
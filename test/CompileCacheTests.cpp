@@ -0,0 +1,128 @@
+#include "CompileCache.h"
+#include "JackCompiler.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::ofstream;
+using std::string;
+using std::vector;
+using JackCompiler::CompilationOptions;
+using JackCompiler::CompileCache;
+using TestDirectory::assertOutputsMatchReferences;
+using TestDirectory::compile;
+namespace ContentHash = JackCompiler::ContentHash;
+namespace fs = std::filesystem;
+
+namespace {
+    std::uintmax_t directorySize(const fs::path& directoryPath) {
+        std::uintmax_t size{};
+
+        for(const auto& item : fs::recursive_directory_iterator{directoryPath}) {
+            if(item.is_regular_file()) {
+                size += item.file_size();
+            }
+        }
+
+        return size;
+    }
+
+    class CompileCacheTest : public testing::Test {
+    protected:
+        const TestDirectory::TemporaryDirectory root_{"cache"};
+        const fs::path cachePath_{root_.path() / "cache"};
+        CompilationOptions options_;
+
+        void SetUp() override {
+            options_.cacheDirectory = cachePath_.string();
+        }
+
+        fs::path createCheckout(const string& name) const {
+            return root_.copyTestFiles(name);
+        }
+    };
+
+    TEST_F(CompileCacheTest, SharesOutputsBetweenCheckouts) {
+        ASSERT_EQ("Cache: 0 hits, 11 misses.\n", compile(createCheckout("first"), options_));
+
+        const auto secondCheckout = createCheckout("second");
+        ASSERT_EQ("Cache: 11 hits, 0 misses.\n", compile(secondCheckout, options_));
+        assertOutputsMatchReferences(secondCheckout);
+    }
+
+    TEST_F(CompileCacheTest, SeparatesOutputsOfOtherOptions) {
+        const auto checkout = createCheckout("checkout");
+        compile(checkout, options_);
+
+        auto peepholeOptions = options_;
+        peepholeOptions.peephole = true;
+        const auto output = compile(checkout, peepholeOptions);
+
+        ASSERT_EQ(0u, output.find("Cache: 0 hits, 11 misses.\n")) << output;
+
+        ASSERT_EQ("Cache: 11 hits, 0 misses.\n", compile(checkout, options_));
+        assertOutputsMatchReferences(checkout);
+    }
+
+    TEST_F(CompileCacheTest, IgnoresCorruptEntries) {
+        const auto checkout = createCheckout("checkout");
+        compile(checkout, options_);
+
+        for(const auto& item : fs::recursive_directory_iterator{cachePath_}) {
+            if(item.is_regular_file()) {
+                ofstream{item.path(), std::ios::app} << "push constant 0\n";
+                break;
+            }
+        }
+
+        ASSERT_EQ("Cache: 10 hits, 1 miss.\n", compile(checkout, options_));
+        assertOutputsMatchReferences(checkout);
+        ASSERT_EQ("Cache: 11 hits, 0 misses.\n", compile(checkout, options_));
+    }
+
+    TEST_F(CompileCacheTest, EvictsLeastRecentlyUsedEntries) {
+        CompileCache cache{cachePath_, 3000};
+        const string output(1000, 'x');
+
+        for(ContentHash::Hash source = 0; source < 10; ++source) {
+            cache.store(source, ContentHash::of(options_), output);
+            // the modification times have to differ
+            fs::last_write_time(cachePath_ / "00" / (ContentHash::toString(source).substr(2) + ContentHash::toString(ContentHash::of(options_)) + ".vm"),
+                fs::file_time_type::clock::now() - std::chrono::hours{10 - source});
+        }
+
+        cache.evict();
+
+        ASSERT_LE(directorySize(cachePath_), 3000u);
+        ASSERT_FALSE(cache.load(0, ContentHash::of(options_)));
+        ASSERT_EQ(output, cache.load(9, ContentHash::of(options_)));
+    }
+
+    TEST_F(CompileCacheTest, SupportsConcurrentCompilations) {
+        vector<fs::path> checkouts;
+        vector<std::thread> threads;
+
+        for(size_t i = 0; i < 4; ++i) {
+            checkouts.push_back(createCheckout("checkout" + std::to_string(i)));
+        }
+
+        auto options = options_;
+        options.jobs = 2;
+
+        for(const auto& checkout : checkouts) {
+            threads.emplace_back([&options, &checkout] { JackCompiler::compile(checkout.string(), options); });
+        }
+
+        for(auto& thread : threads) {
+            thread.join();
+        }
+
+        for(const auto& checkout : checkouts) {
+            assertOutputsMatchReferences(checkout);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+#include "CompileServer.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using std::ofstream;
+using std::string;
+using std::stringstream;
+using std::vector;
+using JackCompiler::CompilationOptions;
+using TestDirectory::assertOutputsMatchReferences;
+namespace CompileServer = JackCompiler::CompileServer;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr std::chrono::milliseconds IDLE_TIMEOUT{300};
+
+    class CompileServerTest : public testing::Test {
+    protected:
+        const TestDirectory::TemporaryDirectory root_{"server"};
+        const fs::path rootPath_{root_.path()};
+        const string socketPath_{(rootPath_ / "server.sock").string()};
+        stringstream serverLog_;
+        std::thread serverThread_;
+        int serverResult_{};
+
+        void SetUp() override {
+            if(!CompileServer::isSupported()) {
+                GTEST_SKIP() << "Unix domain sockets are not supported.";
+            }
+
+            serverThread_ = std::thread{[this] { serverResult_ = CompileServer::serve(socketPath_, {}, IDLE_TIMEOUT, serverLog_); }};
+
+            for(auto attempt = 0; attempt < 200 && !CompileServer::isRunning(socketPath_); ++attempt) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            }
+        }
+
+        void TearDown() override {
+            if(serverThread_.joinable()) {
+                serverThread_.join();
+            }
+        }
+
+        fs::path createDirectory(const string& name) const {
+            return root_.copyTestFiles(name);
+        }
+    };
+
+    TEST_F(CompileServerTest, ServesConcurrentRequests) {
+        vector<fs::path> directories;
+        vector<std::thread> clients;
+        vector<int> results(4, -2);
+        vector<stringstream> reports(4);
+
+        for(size_t i = 0; i < results.size(); ++i) {
+            directories.push_back(createDirectory("directory" + std::to_string(i)));
+        }
+
+        for(size_t i = 0; i < results.size(); ++i) {
+            clients.emplace_back([&, i] { results[i] = CompileServer::request(socketPath_, directories[i].string(), {}, reports[i]); });
+        }
+
+        for(auto& client : clients) {
+            client.join();
+        }
+
+        for(size_t i = 0; i < results.size(); ++i) {
+            ASSERT_EQ(0, results[i]) << reports[i].str();
+            ASSERT_EQ("", reports[i].str());
+            assertOutputsMatchReferences(directories[i]);
+        }
+    }
+
+    TEST_F(CompileServerTest, ReportsErrorsOfRequest) {
+        const auto directoryPath = createDirectory("directory");
+        ofstream{directoryPath / "Square.jack", std::ios::app} << "}";
+
+        stringstream report;
+        ASSERT_EQ(-1, CompileServer::request(socketPath_, directoryPath.string(), {}, report));
+        ASSERT_EQ("Square.jack:110: error: Illegal occurence of tokens after the end of the class definition.\n"
+                  "1 error in 1 file.\n", report.str());
+
+        // the options of the request are used
+        fs::remove(directoryPath / "Square.jack");
+        CompilationOptions options;
+        options.peephole = true;
+        report.str({});
+
+        ASSERT_EQ(0, CompileServer::request(socketPath_, directoryPath.string(), options, report));
+        ASSERT_EQ(0u, report.str().find("Optimizations (removed instructions):")) << report.str();
+    }
+
+    TEST_F(CompileServerTest, UsesCacheDirectoryOfRequest) {
+        const auto directoryPath = createDirectory("directory");
+        CompilationOptions options;
+        options.cacheDirectory = (rootPath_ / "cache").string();
+
+        stringstream report;
+        ASSERT_EQ(0, CompileServer::request(socketPath_, directoryPath.string(), options, report));
+        ASSERT_EQ("Cache: 0 hits, 11 misses.\n", report.str());
+        ASSERT_TRUE(fs::is_directory(rootPath_ / "cache"));
+        assertOutputsMatchReferences(directoryPath);
+    }
+
+    TEST_F(CompileServerTest, RejectsPathsWithLineBreaks) {
+        const auto directoryPath = createDirectory("directory");
+        CompilationOptions options;
+        options.cacheDirectory = (rootPath_ / "cache\ndirectory").string();
+
+        stringstream report;
+        ASSERT_EQ(-1, CompileServer::request(socketPath_, directoryPath.string(), options, report));
+        ASSERT_EQ("The compile-server cannot compile paths that contain line breaks.\n", report.str());
+
+        report.str({});
+        ASSERT_EQ(-1, CompileServer::request(socketPath_, (directoryPath / "Square\n.jack").string(), {}, report));
+        ASSERT_EQ("The compile-server cannot compile paths that contain line breaks.\n", report.str());
+    }
+
+    TEST_F(CompileServerTest, RestrictsSocketToOwner) {
+        ASSERT_TRUE(CompileServer::isRunning(socketPath_));
+
+        const auto permissions = fs::status(socketPath_).permissions();
+        ASSERT_EQ(fs::perms::none, permissions & (fs::perms::group_all | fs::perms::others_all));
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    TEST_F(CompileServerTest, DisconnectsClientsThatSendNoRequest) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socketPath_.c_str(), sizeof(address.sun_path) - 1);
+
+        const auto connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ASSERT_EQ(0, ::connect(connection, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+
+        // the request is never completed and the connection stays open
+        const string incompleteRequest{"jack-compiler-request 1\n"};
+        ASSERT_EQ(static_cast<ssize_t>(incompleteRequest.size()), ::send(connection, incompleteRequest.data(), incompleteRequest.size(), 0));
+
+        serverThread_.join();
+        ::close(connection);
+
+        ASSERT_EQ(0, serverResult_);
+    }
+#endif
+
+    TEST_F(CompileServerTest, StopsWhenIdle) {
+        stringstream report;
+        ASSERT_EQ(-1, CompileServer::serve(socketPath_, {}, IDLE_TIMEOUT, report));
+        ASSERT_EQ("A compile-server is already listening on \"" + socketPath_ + "\".\n", report.str());
+
+        serverThread_.join();
+
+        ASSERT_EQ(0, serverResult_);
+        ASSERT_FALSE(fs::exists(socketPath_));
+        ASSERT_EQ(-1, CompileServer::request(socketPath_, rootPath_.string(), {}, report));
+    }
+}
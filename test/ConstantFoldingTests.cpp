@@ -0,0 +1,84 @@
+#include "ConstantFolding.h"
+#include "TestCompilation.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+using JackCompiler::CompilationOptions;
+using TestCompilation::compile;
+namespace ConstantFolding = JackCompiler::ConstantFolding;
+
+namespace {
+    CompilationOptions foldingOptions() {
+        CompilationOptions options;
+        options.foldConstants = true;
+        return options;
+    }
+
+    TEST(ConstantFoldingTest, EvaluatesLikeTheHackPlatform) {
+        ASSERT_EQ(-5, ConstantFolding::evaluate('-', 5));
+        ASSERT_EQ(-1, ConstantFolding::evaluate('~', 0));
+        ASSERT_EQ(-32768, ConstantFolding::evaluate('-', -32768));
+
+        ASSERT_EQ(-32768, ConstantFolding::evaluate('+', 32767, 1));
+        ASSERT_EQ(32767, ConstantFolding::evaluate('-', -32768, 1));
+        ASSERT_EQ(0, ConstantFolding::evaluate('*', 256, 256));
+        ASSERT_EQ(-3, ConstantFolding::evaluate('/', -7, 2));
+        ASSERT_EQ(4, ConstantFolding::evaluate('&', 12, 6));
+        ASSERT_EQ(14, ConstantFolding::evaluate('|', 12, 6));
+        ASSERT_EQ(-1, ConstantFolding::evaluate('<', -1, 0));
+        ASSERT_EQ(0, ConstantFolding::evaluate('>', -1, 0));
+        ASSERT_EQ(-1, ConstantFolding::evaluate('=', 3, 3));
+
+        // the result of these divisions depends on the Math-class that is used at runtime
+        ASSERT_FALSE(ConstantFolding::evaluate('/', 1, 0));
+        ASSERT_FALSE(ConstantFolding::evaluate('/', -32768, -1));
+    }
+
+    TEST(ConstantFoldingTest, FoldsConstantExpressions) {
+        const string jackCode{"class Main { function int f(int x) {"
+                              "  if(~false) { return (32 * 16) - 1; }"
+                              "  return x + (2 - 3) + (7 / 0); } }"};
+
+        const string expectedOutput{"function Main.f 0\n"
+                                    "push constant 0\n"
+                                    "not\n"
+                                    "if-goto IF_TRUE0\n"
+                                    "goto IF_FALSE0\n"
+                                    "label IF_TRUE0\n"
+                                    "push constant 511\n"
+                                    "return\n"
+                                    "label IF_FALSE0\n"
+                                    "push argument 0\n"
+                                    "push constant 0\n"
+                                    "not\n"
+                                    "add\n"
+                                    "push constant 7\n"
+                                    "push constant 0\n"
+                                    "call Math.divide 2\n"
+                                    "add\n"
+                                    "return\n"};
+
+        ASSERT_EQ(expectedOutput, compile(jackCode, foldingOptions()));
+    }
+
+    TEST(ConstantFoldingTest, ReportsRemovedInstructionsOfExpressions) {
+        const string jackCode{"class Main { function int f() { return (32 * 16) - 1 + ~true; } }"};
+        TestCompilation::assertReportsRemovedInstructions(jackCode, foldingOptions(), {"constant folding"});
+    }
+
+    class ConstantFoldingTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with constant folding. The difference between the length of the reference output and the output
+     * must equal the number of removed instructions reported by the statistics.
+     */
+    TEST_P(ConstantFoldingTest, ReportsRemovedInstructions) {
+        TestCompilation::assertReportsRemovedInstructions(TestCompilation::readTestFile(GetParam()), foldingOptions(),
+            {"constant folding"});
+    }
+
+    INSTANTIATE_TEST_CASE_P(ConstantFoldingTestInstance, ConstantFoldingTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
@@ -0,0 +1,152 @@
+#include "TestCompilation.h"
+#include "VMInterpreter.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+using JackCompiler::CompilationOptions;
+using TestCompilation::compile;
+
+namespace {
+    CompilationOptions compactOptions() {
+        CompilationOptions options;
+        options.compactControlFlow = true;
+        return options;
+    }
+
+    TEST(ControlFlowTest, InvertsBooleanConditions) {
+        const string jackCode{"class Main {"
+                              "  function int f(int a, int b) {"
+                              "    if(~(a = b)) { let a = 1; }"
+                              "    if(a < b) { let a = 2; } else { let a = 3; }"
+                              "    if(~(a > b)) { let a = 4; } else { let a = 5; }"
+                              "    return a;"
+                              "  } }"};
+
+        ASSERT_EQ("function Main.f 0\n"
+                  "push argument 0\n"
+                  "push argument 1\n"
+                  "eq\n"
+                  "if-goto IF_FALSE0\n"
+                  "push constant 1\n"
+                  "pop argument 0\n"
+                  "label IF_FALSE0\n"
+                  "push argument 0\n"
+                  "push argument 1\n"
+                  "lt\n"
+                  "if-goto IF_TRUE1\n"
+                  "push constant 3\n"
+                  "pop argument 0\n"
+                  "goto IF_END1\n"
+                  "label IF_TRUE1\n"
+                  "push constant 2\n"
+                  "pop argument 0\n"
+                  "label IF_END1\n"
+                  "push argument 0\n"
+                  "push argument 1\n"
+                  "gt\n"
+                  "if-goto IF_FALSE2\n"
+                  "push constant 4\n"
+                  "pop argument 0\n"
+                  "goto IF_END2\n"
+                  "label IF_FALSE2\n"
+                  "push constant 5\n"
+                  "pop argument 0\n"
+                  "label IF_END2\n"
+                  "push argument 0\n"
+                  "return\n", compile(jackCode, compactOptions()));
+    }
+
+    TEST(ControlFlowTest, RotatesLoopsWithBooleanConditions) {
+        const string jackCode{"class Main {"
+                              "  function int f(int a) {"
+                              "    while(~(a = 0)) { let a = a - 1; }"
+                              "    return a;"
+                              "  } }"};
+
+        ASSERT_EQ("function Main.f 0\n"
+                  "goto WHILE_EXP0\n"
+                  "label WHILE_BODY0\n"
+                  "push argument 0\n"
+                  "push constant 1\n"
+                  "sub\n"
+                  "pop argument 0\n"
+                  "label WHILE_EXP0\n"
+                  "push argument 0\n"
+                  "push constant 0\n"
+                  "eq\n"
+                  "not\n"
+                  "if-goto WHILE_BODY0\n"
+                  "push argument 0\n"
+                  "return\n", compile(jackCode, compactOptions()));
+    }
+
+    TEST(ControlFlowTest, KeepsNonBooleanConditions) {
+        // an if-statement without else-branch and a loop whose condition may be any integer keep the reference lowering
+        const string jackCode{"class Main {"
+                              "  function int f(int a) {"
+                              "    if(a) { let a = 1; }"
+                              "    while(~a) { let a = a + 1; }"
+                              "    return a;"
+                              "  } }"};
+
+        ASSERT_EQ(compile(jackCode), compile(jackCode, compactOptions()));
+    }
+
+    TEST(ControlFlowTest, KeepsConditionsOnBooleanVariables) {
+        // a boolean variable may hold any integer, so the conditions must not be inverted
+        const string jackCode{"class Main {"
+                              "  function int f() {"
+                              "    var boolean flag;"
+                              "    var int r;"
+                              "    let flag = 6;"
+                              "    if(flag) { let r = 1; }"
+                              "    while(flag) { let r = r + 10; let flag = false; }"
+                              "    return r;"
+                              "  } }"};
+
+        ASSERT_EQ(compile(jackCode), compile(jackCode, compactOptions()));
+
+        VMInterpreter interpreter;
+        interpreter.load("Main", compile(jackCode, compactOptions()));
+        ASSERT_EQ(1, interpreter.call("Main.f", {}));
+    }
+
+    TEST(ControlFlowTest, PreservesSemantics) {
+        // the conditions are integers as well as booleans, since only -1 continues a loop and every value except
+        // 0 enters an if-statement
+        const string jackCode{"class Main {"
+                              "  function int f(int a, int b) {"
+                              "    var int i, result;"
+                              "    var boolean done;"
+                              "    let i = 0;"
+                              "    while(~(i = 10)) {"
+                              "      if(i & a) { let result = result + 1; }"
+                              "      if(~(i < b)) { let result = result + 10; } else { let result = result - 1; }"
+                              "      if(~i) { let result = result + 100; } else { let result = result + 1000; }"
+                              "      if((i > 3) & (~done)) { let done = true; let result = result * 2; }"
+                              "      let i = i + 1;"
+                              "    }"
+                              "    while(a) { let a = a + 1; let result = result + 1; }"
+                              "    while(~b) { let b = b + 1; let result = result + 1; }"
+                              "    return result;"
+                              "  } }"};
+
+        TestCompilation::assertPreservesResults(jackCode, compactOptions(), {-1, 0, 1, 6}, {-1, 0, 5});
+    }
+
+    class ControlFlowTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with compact control-flow. The output must not be longer than the reference output.
+     */
+    TEST_P(ControlFlowTest, DoesNotIncreaseCodeSize) {
+        const auto jackCode = TestCompilation::readTestFile(GetParam());
+
+        ASSERT_LE(TestCompilation::countLines(compile(jackCode, compactOptions())), TestCompilation::countLines(compile(jackCode)));
+    }
+
+    INSTANTIATE_TEST_CASE_P(ControlFlowTestInstance, ControlFlowTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
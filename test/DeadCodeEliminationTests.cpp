@@ -0,0 +1,93 @@
+#include "TestCompilation.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+using JackCompiler::CompilationOptions;
+using TestCompilation::compile;
+
+namespace {
+    CompilationOptions deadCodeOptions() {
+        CompilationOptions options;
+        options.eliminateDeadCode = true;
+        return options;
+    }
+
+    TEST(DeadCodeEliminationTest, RemovesUnreachableStatements) {
+        const string jackCode{"class Main {"
+                              "  function int f(int x) {"
+                              "    var int y;"
+                              "    if(false) { let y = 1; } else { let y = 2; }"
+                              "    if(true) { let y = 3; }"
+                              "    while(false) { let y = 4; }"
+                              "    while(true) { if(x) { return y; } let x = x - 1; }"
+                              "    let y = 5;"
+                              "    return y;"
+                              "  }"
+                              "  function int g() { return 1; do Main.f(2); } }"};
+
+        ASSERT_EQ("function Main.f 1\n"
+                  "push constant 2\n"
+                  "pop local 0\n"
+                  "push constant 3\n"
+                  "pop local 0\n"
+                  "label WHILE_EXP1\n"
+                  "push argument 0\n"
+                  "if-goto IF_TRUE2\n"
+                  "goto IF_FALSE2\n"
+                  "label IF_TRUE2\n"
+                  "push local 0\n"
+                  "return\n"
+                  "label IF_FALSE2\n"
+                  "push argument 0\n"
+                  "push constant 1\n"
+                  "sub\n"
+                  "pop argument 0\n"
+                  "goto WHILE_EXP1\n"
+                  "function Main.g 0\n"
+                  "push constant 1\n"
+                  "return\n", compile(jackCode, deadCodeOptions()));
+
+        TestCompilation::assertReportsRemovedInstructions(jackCode, deadCodeOptions(),
+            {"constant condition", "unreachable statement"});
+    }
+
+    TEST(DeadCodeEliminationTest, OnlyTrueConditionLoopsForever) {
+        // the reference lowering negates the condition, so while(1) is never entered
+        const string jackCode{"class Main {"
+                              "  function int f() {"
+                              "    var int r;"
+                              "    while(1) { let r = r + 1; }"
+                              "    let r = 42;"
+                              "    return r;"
+                              "  } }"};
+
+        ASSERT_EQ("function Main.f 1\n"
+                  "push constant 42\n"
+                  "pop local 0\n"
+                  "push local 0\n"
+                  "return\n", compile(jackCode, deadCodeOptions()));
+
+        TestCompilation::assertReportsRemovedInstructions(jackCode, deadCodeOptions(), {"constant condition"});
+    }
+
+    TEST(DeadCodeEliminationTest, ValidatesUnreachableStatements) {
+        const string jackCode{"class Main { function int f() { return 1; let y = 2; } }"};
+        ASSERT_THROW(compile(jackCode, deadCodeOptions()), std::runtime_error);
+    }
+
+    class DeadCodeEliminationTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with dead code elimination. The difference between the length of the reference output and the output
+     * must equal the number of removed instructions reported by the statistics.
+     */
+    TEST_P(DeadCodeEliminationTest, ReportsRemovedInstructions) {
+        TestCompilation::assertReportsRemovedInstructions(TestCompilation::readTestFile(GetParam()), deadCodeOptions(),
+            {"constant condition", "unreachable statement"});
+    }
+
+    INSTANTIATE_TEST_CASE_P(DeadCodeEliminationTestInstance, DeadCodeEliminationTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
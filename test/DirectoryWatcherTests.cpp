@@ -0,0 +1,159 @@
+#include "DirectoryWatcher.h"
+#include "JackCompiler.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::ofstream;
+using std::string;
+using std::stringstream;
+using std::vector;
+using JackCompiler::CompilationOptions;
+using JackCompiler::DirectoryWatcher;
+using TestDirectory::readFile;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr std::chrono::milliseconds WAIT_TIMEOUT{5000};
+
+    /**
+     * \brief Waits until a condition holds (or the timeout expires).
+     * \return True if the condition holds
+     */
+    bool waitUntil(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+
+        while(!condition()) {
+            if(std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+
+        return true;
+    }
+
+    class DirectoryWatcherTest : public testing::Test {
+    protected:
+        const TestDirectory::TemporaryDirectory directory_{"watch"};
+        const fs::path directoryPath_{directory_.copyTestFiles()};
+
+        void SetUp() override {
+            if(!DirectoryWatcher::isSupported()) {
+                GTEST_SKIP() << "Watching directories is not supported.";
+            }
+        }
+
+        void writeFile(const string& fileName, const string& text) const {
+            ofstream{directoryPath_ / fileName} << text;
+        }
+    };
+
+    /**
+     * \brief Watches the directory of a test on another thread until it is destroyed.
+     */
+    class WatchThread {
+    public:
+        explicit WatchThread(const fs::path& directoryPath, const CompilationOptions& options = {})
+            : thread_{[this, directoryPath, options] { 
+                result_ = JackCompiler::watch(directoryPath.string(), options, report_, [this] { return stopped_.load(); }); 
+            }} {}
+
+        ~WatchThread() {
+            stop();
+        }
+
+        /**
+         * \brief Stops watching and gets the report.
+         */
+        string stop() {
+            stopped_ = true;
+
+            if(thread_.joinable()) {
+                thread_.join();
+            }
+
+            EXPECT_EQ(0, result_);
+            return report_.str();
+        }
+
+    private:
+        std::atomic<bool> stopped_{false};
+        stringstream report_;
+        int result_{-2};
+        std::thread thread_;
+    };
+
+    TEST_F(DirectoryWatcherTest, CombinesBurstsOfChanges) {
+        DirectoryWatcher watcher{directoryPath_};
+
+        ASSERT_TRUE(watcher.waitForChanges(std::chrono::milliseconds{10}, std::chrono::milliseconds{10}).fileNames.empty());
+
+        writeFile("Square.jack", "");
+        writeFile("Notes.txt", "");
+        writeFile("Square.jack", "");
+        fs::remove(directoryPath_ / "PongBat.jack");
+
+        const auto changes = watcher.waitForChanges(WAIT_TIMEOUT, std::chrono::milliseconds{50});
+
+        ASSERT_EQ((vector<string>{"Notes.txt", "PongBat.jack", "Square.jack"}), changes.fileNames);
+        ASSERT_TRUE(watcher.waitForChanges(std::chrono::milliseconds{10}, std::chrono::milliseconds{10}).fileNames.empty());
+    }
+
+    TEST_F(DirectoryWatcherTest, WatchCompilesChangedFiles) {
+        const auto outputPath = directoryPath_ / "SevenMain.vm";
+        const string changedOutput{"function Main.main 0\npush constant 0\nreturn\n"};
+        WatchThread watchThread{directoryPath_};
+
+        ASSERT_TRUE(waitUntil([&] { return readFile(outputPath) == readFile(testFilesPath + "SevenMain_Ref.vm"); }));
+
+        writeFile("SevenMain.jack", "class Main { function void main() { return; } }");
+        ASSERT_TRUE(waitUntil([&] { return readFile(outputPath) == changedOutput; }));
+
+        fs::remove(directoryPath_ / "PongBat.jack");
+        ASSERT_TRUE(waitUntil([&] { return !fs::exists(directoryPath_ / "PongBat.vm"); }));
+
+        const auto report = watchThread.stop();
+
+        ASSERT_NE(string::npos, report.find("Compiled \"SevenMain.jack\" in ")) << report;
+        ASSERT_NE(string::npos, report.find("Removed \"PongBat.vm\".")) << report;
+
+        // the other files have not been compiled again
+        for(const auto& fileName : TestFiles::TEST_FILE_NAMES) {
+            if(fileName != "SevenMain.jack" && fileName != "PongBat.jack") {
+                ASSERT_EQ(string::npos, report.find('"' + fileName + '"')) << report;
+            }
+        }
+    }
+
+    TEST_F(DirectoryWatcherTest, WatchReportsErrorsOfChangedFiles) {
+        const auto outputPath = directoryPath_ / "Square.vm";
+        WatchThread watchThread{directoryPath_};
+
+        ASSERT_TRUE(waitUntil([&] { return readFile(outputPath) == readFile(testFilesPath + "Square_Ref.vm"); }));
+
+        writeFile("Square.jack", "class Square { function void draw() { do x(); return } }");
+        ASSERT_TRUE(waitUntil([&] { return !fs::exists(outputPath) || readFile(outputPath) != readFile(testFilesPath + "Square_Ref.vm"); }));
+
+        // the report is complete once the watch has stopped
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        const auto report = watchThread.stop();
+
+        ASSERT_NE(string::npos, report.find("Failed to compile \"Square.jack\" in ")) << report;
+    }
+
+    TEST_F(DirectoryWatcherTest, WatchRequiresDirectory) {
+        stringstream report;
+
+        ASSERT_EQ(-1, JackCompiler::watch((directoryPath_ / "Square.jack").string(), {}, report));
+    }
+}
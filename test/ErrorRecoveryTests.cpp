@@ -0,0 +1,167 @@
+#include "CompilationEngine.h"
+#include "JackCompiler.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::stringstream;
+using std::vector;
+using JackCompiler::CompilationOptions;
+using JackCompiler::CompilationError;
+
+namespace {
+    const string INVALID_CLASS{"class Main {\n"
+                               "  field int x;\n"
+                               "  static boolean 1;\n"
+                               "  field int y;\n"
+                               "  function void f(int a) {\n"
+                               "    var int b\n"
+                               "    var int c;\n"
+                               "    let b = a\n"
+                               "    let c = b;\n"
+                               "    if(a +) { let b = 1; } else { let c = ; }\n"
+                               "    while(a) { let a = a - 1; do Output.printInt(undefined); }\n"
+                               "    return;\n"
+                               "  }\n"
+                               "  function int (int a) { return a; }\n"
+                               "  method void g() { let x = y; return; }\n"
+                               "  method void h() { let x = z; return; }\n"
+                               "}\n"};
+
+    vector<string> describe(const vector<CompilationError>& errors) {
+        vector<string> descriptions;
+
+        for(const auto& error : errors) {
+            descriptions.push_back(std::to_string(error.line()) + ": " + error.message());
+        }
+
+        return descriptions;
+    }
+
+    class ErrorRecoveryTest : public testing::TestWithParam<bool> {};
+
+    TEST_P(ErrorRecoveryTest, ReportsAllErrors) {
+        CompilationOptions options;
+        options.buildAst = GetParam();
+
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{INVALID_CLASS, outputStream, options};
+
+        try {
+            engine.compileClass();
+            FAIL() << "The compilation did not fail.";
+        }
+        catch(const CompilationError& error) {
+            ASSERT_EQ(3u, error.line());
+        }
+
+        const vector<string> expectedErrors{
+            "3: Expected an identifier-token.",
+            "7: Expected a symbol-token.",
+            "9: Expected a symbol-token.",
+            "10: Invalid term-construct.",
+            "11: Undefined variable 'undefined'.",
+            "14: Expected an identifier-token.",
+            "16: Undefined variable 'z'."
+        };
+
+        ASSERT_EQ(expectedErrors, describe(engine.errors()));
+    }
+
+    TEST_P(ErrorRecoveryTest, StopsAtMaximumNumberOfErrors) {
+        CompilationOptions options;
+        options.buildAst = GetParam();
+        options.maxErrors = 2;
+
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{INVALID_CLASS, outputStream, options};
+
+        ASSERT_THROW(engine.compileClass(), CompilationError);
+        ASSERT_EQ(2u, engine.errors().size());
+        ASSERT_EQ(7u, engine.errors().back().line());
+    }
+
+    TEST_P(ErrorRecoveryTest, ReportsUnrecoverableErrors) {
+        CompilationOptions options;
+        options.buildAst = GetParam();
+
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{"class Main {\n function void f() { let x = 1; return; }\n} }", outputStream, options};
+
+        ASSERT_THROW(engine.compileClass(), CompilationError);
+
+        const vector<string> expectedErrors{
+            "2: Undefined variable 'x'.",
+            "3: Illegal occurence of tokens after the end of the class definition."
+        };
+
+        ASSERT_EQ(expectedErrors, describe(engine.errors()));
+    }
+
+    TEST_P(ErrorRecoveryTest, ReportsLexerErrorsWithLine) {
+        CompilationOptions options;
+        options.buildAst = GetParam();
+
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{"class Main {\n function void f() { let x = 1; return; }\n"
+                                               " function void g() { do f(\"a); return; }\n}", outputStream, options};
+
+        ASSERT_THROW(engine.compileClass(), CompilationError);
+
+        // the lexer cannot continue after an error, so the compilation stops there
+        const vector<string> expectedErrors{
+            "2: Undefined variable 'x'.",
+            "3: Malformed string literal. Did you forget closing '\"'?"
+        };
+
+        ASSERT_EQ(expectedErrors, describe(engine.errors()));
+    }
+
+    TEST_P(ErrorRecoveryTest, ReportsParseErrorsBeforeLexerErrorsInDirectories) {
+        // files of a directory are pre-lexed, which must not hide the errors in front of an invalid token
+        const TestDirectory::TemporaryDirectory directory{"error-recovery"};
+        const auto& directoryPath = directory.path();
+
+        std::ofstream{directoryPath / "Main.jack"} << "class Main {\n"
+                                                     "  function void f() {\n"
+                                                     "    let x = 1;\n"
+                                                     "    return;\n"
+                                                     "  }\n"
+                                                     "  function void g() {\n"
+                                                     "    # return;\n"
+                                                     "  }\n"
+                                                     "}\n";
+
+        for(const bool wholeProgram : {false, true}) {
+            CompilationOptions options;
+            options.buildAst = GetParam();
+            options.eliminateDeadSubroutines = wholeProgram;
+
+            stringstream reportStream;
+            ASSERT_NE(0, JackCompiler::compile(directoryPath.string(), options, reportStream));
+
+            const auto report = reportStream.str();
+            EXPECT_NE(string::npos, report.find("Main.jack:3: error: Undefined variable 'x'.")) << report;
+            EXPECT_NE(string::npos, report.find("Main.jack:7: error: Invalid token >>#<<")) << report;
+        }
+    }
+
+    TEST_P(ErrorRecoveryTest, GeneratesNoCodeAfterErrors) {
+        CompilationOptions options;
+        options.buildAst = GetParam();
+
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{"class Main {\n function void f() { return; }\n function void g() { do f(; return; }\n"
+                                               " function void h() { return; } }", outputStream, options};
+
+        ASSERT_THROW(engine.compileClass(), CompilationError);
+        ASSERT_EQ(string::npos, outputStream.str().find("function Main.h"));
+    }
+
+    INSTANTIATE_TEST_CASE_P(ErrorRecoveryTestInstance, ErrorRecoveryTest, ::testing::Values(false, true),
+        [] (const ::testing::TestParamInfo<bool>& info) { return info.param ? "Ast" : "SinglePass"; });
+}
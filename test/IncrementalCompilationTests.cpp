@@ -0,0 +1,145 @@
+#include "BuildManifest.h"
+#include "ContentHash.h"
+#include "JackCompiler.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using std::ofstream;
+using std::string;
+using JackCompiler::BuildManifest;
+using JackCompiler::CompilationOptions;
+using TestDirectory::compile;
+using TestDirectory::readFile;
+namespace ContentHash = JackCompiler::ContentHash;
+namespace fs = std::filesystem;
+
+namespace {
+    class IncrementalCompilationTest : public testing::Test {
+    protected:
+        const TestDirectory::TemporaryDirectory directory_{"incremental"};
+        const fs::path directoryPath_{directory_.copyTestFiles()};
+        CompilationOptions options_;
+
+        void SetUp() override {
+            options_.incremental = true;
+        }
+
+        void assertOutputsMatchReferences() const {
+            TestDirectory::assertOutputsMatchReferences(directoryPath_);
+        }
+
+        void appendTo(const string& fileName, const string& text) const {
+            ofstream{directoryPath_ / fileName, std::ios::app} << text;
+        }
+    };
+
+    TEST_F(IncrementalCompilationTest, SkipsUnchangedFiles) {
+        ASSERT_EQ("0 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        assertOutputsMatchReferences();
+
+        ASSERT_EQ("11 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        assertOutputsMatchReferences();
+    }
+
+    TEST_F(IncrementalCompilationTest, SkipsChangesOfCommentsAndWhitespace) {
+        compile(directoryPath_, options_);
+        appendTo("Square.jack", "\n// a comment\n/* another comment */\n");
+
+        ASSERT_EQ("11 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        assertOutputsMatchReferences();
+    }
+
+    TEST_F(IncrementalCompilationTest, CompilesChangedFiles) {
+        compile(directoryPath_, options_);
+
+        auto source = readFile(directoryPath_ / "SevenMain.jack");
+        source.replace(source.rfind("1 + (2 * 3)"), 11, "1 + (2 * 4)");
+        ofstream{directoryPath_ / "SevenMain.jack"} << source;
+
+        ASSERT_EQ("10 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        ASSERT_NE(string::npos, readFile(directoryPath_ / "SevenMain.vm").find("push constant 4"));
+    }
+
+    TEST_F(IncrementalCompilationTest, RegeneratesModifiedOutputs) {
+        compile(directoryPath_, options_);
+        ofstream{directoryPath_ / "PongBall.vm", std::ios::app} << "push constant 0\n";
+        fs::remove(directoryPath_ / "Square.vm");
+
+        ASSERT_EQ("9 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        assertOutputsMatchReferences();
+    }
+
+    TEST_F(IncrementalCompilationTest, CompilesAllFilesWithOtherOptions) {
+        compile(directoryPath_, options_);
+
+        auto peepholeOptions = options_;
+        peepholeOptions.peephole = true;
+        const auto output = compile(directoryPath_, peepholeOptions);
+
+        ASSERT_NE(string::npos, output.find("0 of 11 files are up to date.")) << output;
+
+        // other numbers of threads or errors do not change the generated code
+        auto jobsOptions = peepholeOptions;
+        jobsOptions.jobs = 3;
+        jobsOptions.maxErrors = 5;
+
+        ASSERT_EQ(ContentHash::of(peepholeOptions), ContentHash::of(jobsOptions));
+        ASSERT_NE(string::npos, compile(directoryPath_, jobsOptions).find("11 of 11 files are up to date.")) << output;
+    }
+
+    TEST_F(IncrementalCompilationTest, CompilesFilesWithErrorsAgain) {
+        compile(directoryPath_, options_);
+        appendTo("Square.jack", "}");
+
+        compile(directoryPath_, options_, -1);
+        ASSERT_EQ(nullptr, BuildManifest::load(directoryPath_, ContentHash::of(options_)).find("Square.jack"));
+
+        auto source = readFile(directoryPath_ / "Square.jack");
+        source.pop_back();
+        ofstream{directoryPath_ / "Square.jack"} << source;
+
+        ASSERT_EQ("10 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        assertOutputsMatchReferences();
+    }
+
+    TEST_F(IncrementalCompilationTest, ReportsThatWholeProgramsAreCompiledCompletely) {
+        options_.eliminateDeadSubroutines = true;
+        const auto output = compile(directoryPath_, options_);
+
+        ASSERT_EQ(0u, output.find("Incremental compilation and the compile cache are not used with whole-program optimizations")) << output;
+        ASSERT_FALSE(fs::exists(directoryPath_ / BuildManifest::FILE_NAME));
+    }
+
+    TEST_F(IncrementalCompilationTest, IgnoresInvalidManifests) {
+        compile(directoryPath_, options_);
+        ofstream{directoryPath_ / BuildManifest::FILE_NAME, std::ios::app} << "12 invalid entry\n";
+
+        ASSERT_EQ("0 of 11 files are up to date.\n", compile(directoryPath_, options_));
+        ASSERT_EQ("11 of 11 files are up to date.\n", compile(directoryPath_, options_));
+    }
+
+    TEST(ContentHashTest, FormatsAndParsesHashes) {
+        const auto hash = ContentHash::of("class Main {}");
+
+        ASSERT_EQ(16u, ContentHash::toString(hash).size());
+        ASSERT_EQ(hash, ContentHash::fromString(ContentHash::toString(hash)));
+        ASSERT_EQ("000000000000002a", ContentHash::toString(42));
+        ASSERT_FALSE(ContentHash::fromString("2a"));
+        ASSERT_FALSE(ContentHash::fromString("000000000000002x"));
+    }
+
+    TEST(ContentHashTest, HashesTokensIndependentOfLayout) {
+        const JackCompiler::TokenBuffer tokens{"class Main { function void main() { return; } }"};
+        const JackCompiler::TokenBuffer formattedTokens{"class Main {\n  // comment\n  function void main() {\n    return;\n  }\n}\n"};
+        const JackCompiler::TokenBuffer otherTokens{"class Main { function int main() { return; } }"};
+        const JackCompiler::TokenBuffer stringTokens{"class Main { function void main() { do f(\"a b\"); return; } }"};
+        const JackCompiler::TokenBuffer otherStringTokens{"class Main { function void main() { do f(\"a  b\"); return; } }"};
+
+        ASSERT_EQ(ContentHash::of(tokens), ContentHash::of(formattedTokens));
+        ASSERT_NE(ContentHash::of(tokens), ContentHash::of(otherTokens));
+        ASSERT_NE(ContentHash::of(stringTokens), ContentHash::of(otherStringTokens));
+    }
+}
@@ -0,0 +1,149 @@
+#include "CompilationEngine.h"
+#include "Inliner.h"
+#include "TestDirectory.h"
+#include "VMInterpreter.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::stringstream;
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+using JackCompiler::CompilationEngine;
+using JackCompiler::CompilationOptions;
+
+namespace {
+    const vector<string> PROGRAM{
+        "class Counter {"
+        "  field int count, step;"
+        "  constructor Counter new(int s) { let count = 0; let step = s; return this; }"
+        "  method int get() { return count; }"
+        "  method void advance() { let count = count + step; return; }"
+        "  method int scaled(int factor) { var int result; let result = count * factor; return result; }"
+        "  method Counter self() { return this; }"
+        "  function int max(int a, int b) { if(a > b) { return a; } return b; }"
+        "  function int clamp(int a) { var int r; let r = a; if(r > 100) { let r = 100; } return r; }"
+        "}",
+        "class Main {"
+        "  function int main() {"
+        "    var Counter c; var int i, sum;"
+        "    let c = Counter.new(3);"
+        "    while(i < 50) {"
+        "      do c.advance();"
+        "      let c = c.self();"
+        "      let sum = sum + Counter.clamp(c.get()) + c.scaled(2);"
+        "      let i = i + 1;"
+        "    }"
+        "    do Output.printInt(Counter.max(sum, c.get()));"
+        "    return sum;"
+        "  }"
+        "}"
+    };
+
+    /**
+     * \brief Compiles the classes of a program as a whole (like a directory) and loads them into an interpreter.
+     */
+    vector<string> compileProgram(const vector<string>& sources, const CompilationOptions& options, VMInterpreter& interpreter) {
+        vector<unique_ptr<stringstream>> outputStreams;
+        vector<unique_ptr<CompilationEngine>> engines;
+        vector<const JackCompiler::Ast::Class*> classes;
+
+        for(const auto& source : sources) {
+            outputStreams.push_back(make_unique<stringstream>());
+            engines.push_back(make_unique<CompilationEngine>(source, *outputStreams.back(), options));
+            classes.push_back(&engines.back()->parseClass());
+        }
+
+        const JackCompiler::Inliner inliner{classes, options.inlineThreshold};
+        vector<string> vmCode;
+
+        for(size_t i = 0; i < engines.size(); ++i) {
+            engines[i]->lowerClass(*classes[i], options.inlineThreshold > 0 ? &inliner : nullptr);
+            vmCode.push_back(outputStreams[i]->str());
+            interpreter.load(string{classes[i]->name}, vmCode.back());
+        }
+
+        return vmCode;
+    }
+
+    TEST(InliningTest, InlinesSmallLeafSubroutines) {
+        CompilationOptions options;
+        options.inlineThreshold = 12;
+
+        VMInterpreter interpreter;
+        const auto vmCode = compileProgram(PROGRAM, options, interpreter);
+        const auto& mainCode = vmCode[1];
+
+        // getters, setters and functions with locals are inlined, as well as calls within arguments
+        ASSERT_EQ(string::npos, mainCode.find("call Counter.get"));
+        ASSERT_EQ(string::npos, mainCode.find("call Counter.advance"));
+        ASSERT_EQ(string::npos, mainCode.find("call Counter.scaled"));
+        ASSERT_EQ(string::npos, mainCode.find("call Counter.clamp"));
+        ASSERT_EQ(string::npos, mainCode.find("call Counter.self"));
+
+        // constructors and subroutines with several returns are not inlined
+        ASSERT_NE(string::npos, mainCode.find("call Counter.new 1"));
+        ASSERT_NE(string::npos, mainCode.find("call Counter.max 2"));
+
+        // the argument and the local of clamp (as well as the other inlined subroutines) are held by additional locals
+        ASSERT_NE(string::npos, mainCode.find("function Main.main 5\n"));
+    }
+
+    TEST(InliningTest, PreservesSemantics) {
+        VMInterpreter referenceInterpreter;
+        compileProgram(PROGRAM, {}, referenceInterpreter);
+        const int referenceResult = referenceInterpreter.call("Main.main");
+
+        CompilationOptions options;
+        options.inlineThreshold = 12;
+
+        VMInterpreter interpreter;
+        compileProgram(PROGRAM, options, interpreter);
+
+        ASSERT_EQ(referenceResult, interpreter.call("Main.main"));
+        ASSERT_EQ(referenceInterpreter.output(), interpreter.output());
+        ASSERT_LT(interpreter.executedInstructions(), referenceInterpreter.executedInstructions());
+    }
+
+    TEST(InliningTest, RespectsSizeThreshold) {
+        CompilationOptions options;
+        options.inlineThreshold = 2;
+
+        VMInterpreter interpreter;
+        const auto vmCode = compileProgram(PROGRAM, options, interpreter);
+
+        ASSERT_EQ(string::npos, vmCode[1].find("call Counter.get"));
+        ASSERT_NE(string::npos, vmCode[1].find("call Counter.clamp 1"));
+    }
+
+    TEST(InliningTest, KeepsOutputsOfProgramsWithErrors) {
+        const TestDirectory::TemporaryDirectory directory{"inlining"};
+        const auto& directoryPath = directory.path();
+
+        std::ofstream{directoryPath / "Counter.jack"} << PROGRAM[0];
+        std::ofstream{directoryPath / "Main.jack"} << PROGRAM[1];
+
+        CompilationOptions options;
+        options.inlineThreshold = 12;
+        TestDirectory::compile(directoryPath, options);
+
+        const auto counterCode = TestDirectory::readFile(directoryPath / "Counter.vm");
+        const auto mainCode = TestDirectory::readFile(directoryPath / "Main.vm");
+        ASSERT_NE("", counterCode);
+        ASSERT_NE("", mainCode);
+
+        // the whole program is parsed before any output is written, so an error in one class keeps all outputs
+        std::ofstream{directoryPath / "Broken.jack"} << "class Broken { function void f() { var int x; let x = ; return; } }";
+        const auto report = TestDirectory::compile(directoryPath, options, -1);
+
+        ASSERT_NE(string::npos, report.find("Broken.jack:1: error:")) << report;
+        ASSERT_EQ(counterCode, TestDirectory::readFile(directoryPath / "Counter.vm"));
+        ASSERT_EQ(mainCode, TestDirectory::readFile(directoryPath / "Main.vm"));
+        ASSERT_FALSE(std::filesystem::exists(directoryPath / "Broken.vm"));
+    }
+}
@@ -0,0 +1,82 @@
+#include "TestCompilation.h"
+#include "VMWriter.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using std::string;
+using std::stringstream;
+using JackCompiler::VMWriter;
+using JackCompiler::OptimizationStatistics;
+
+namespace {
+    TEST(PeepholeOptimizerTest, RemovesRedundantInstructions) {
+        stringstream outputStream;
+        OptimizationStatistics statistics;
+        VMWriter writer{outputStream, statistics};
+
+        writer.writeFunction("Main", "f", 1);
+        writer.writePush(VMWriter::Segment::LOCAL, 0);
+        writer.writePop(VMWriter::Segment::LOCAL, 0);
+        writer.writePush(VMWriter::Segment::LOCAL, 0);
+        writer.writePop(VMWriter::Segment::LOCAL, 1);
+        writer.writePush(VMWriter::Segment::ARG, 0);
+        writer.writeArithmetic(VMWriter::Command::NOT);
+        writer.writeArithmetic(VMWriter::Command::NOT);
+        writer.writeIf("L1");
+        writer.writeGoto("L2");
+        writer.writeLabel("L2");
+        writer.writeLabel("L1");
+        writer.writePush(VMWriter::Segment::CONST, 0);
+        writer.writeIf("L1");
+        writer.writeReturn();
+        writer.writePush(VMWriter::Segment::CONST, 1);
+        writer.writeReturn();
+        writer.writeFunction("Main", "g", 0);
+        writer.writeLabel("L3");
+        writer.writePush(VMWriter::Segment::CONST, 0);
+        writer.writeArithmetic(VMWriter::Command::NOT);
+        writer.writeIf("L3");
+        writer.writeLabel("L4");
+        writer.flush();
+
+        ASSERT_EQ("function Main.f 1\n"
+                  "push local 0\n"
+                  "pop local 1\n"
+                  "push argument 0\n"
+                  "if-goto L1\n"
+                  "label L1\n"
+                  "return\n"
+                  "function Main.g 0\n"
+                  "label L3\n"
+                  "goto L3\n", outputStream.str());
+
+        ASSERT_EQ(2, statistics.count("push/pop of the same location"));
+        ASSERT_EQ(2, statistics.count("double negation"));
+        ASSERT_EQ(2, statistics.count("never taken conditional jump"));
+        ASSERT_EQ(2, statistics.count("always taken conditional jump"));
+        ASSERT_EQ(1, statistics.count("jump to the next instruction"));
+        ASSERT_EQ(2, statistics.count("unreachable instruction"));
+        ASSERT_EQ(2, statistics.count("unreferenced label"));
+    }
+
+    class PeepholeOptimizerTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with the peephole optimizer. The output may not be longer than the reference output and the
+     * difference must equal the number of removed instructions reported by the statistics.
+     */
+    TEST_P(PeepholeOptimizerTest, ReportsRemovedInstructions) {
+        JackCompiler::CompilationOptions options;
+        options.peephole = true;
+
+        TestCompilation::assertReportsRemovedInstructions(TestCompilation::readTestFile(GetParam()), options,
+            {"push/pop of the same location", "double negation", "never taken conditional jump",
+             "always taken conditional jump", "jump to the next instruction", "unreachable instruction",
+             "unreferenced label"});
+    }
+
+    INSTANTIATE_TEST_CASE_P(PeepholeOptimizerTestInstance, PeepholeOptimizerTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
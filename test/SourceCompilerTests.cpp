@@ -0,0 +1,156 @@
+#include "SourceCompiler.h"
+#include "AllocationCounter.h"
+#include "TestFiles.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::ifstream;
+using std::istreambuf_iterator;
+using std::string;
+using std::vector;
+using JackCompiler::CompilationOptions;
+using JackCompiler::SourceCompiler;
+
+namespace {
+    string readFile(const string& path) {
+        ifstream stream{path};
+        return {istreambuf_iterator<char>{stream}, istreambuf_iterator<char>{}};
+    }
+
+    string printStatistics(const JackCompiler::OptimizationStatistics& statistics) {
+        std::stringstream output;
+        statistics.print(output);
+        return output.str();
+    }
+
+    CompilationOptions allOptimizations() {
+        CompilationOptions options;
+        options.peephole = true;
+        options.foldConstants = true;
+        options.reduceStrength = true;
+        options.poolStrings = true;
+        options.eliminateDeadCode = true;
+        options.inlineThreshold = 8;
+        options.compactControlFlow = true;
+        options.optimizeArrayAccess = true;
+        options.eliminateCommonSubexpressions = true;
+        return options;
+    }
+
+    TEST(SourceCompilerTest, ReusedCompilerMatchesReferenceCompiler) {
+        SourceCompiler compiler;
+        SourceCompiler::Result result;
+
+        // each class is compiled twice, so every compilation follows another one
+        for(auto pass = 0; pass < 2; ++pass) {
+            for(const auto& fileName : TestFiles::TEST_FILE_NAMES) {
+                compiler.compile(readFile(testFilesPath + fileName), {}, result);
+
+                ASSERT_TRUE(result.succeeded()) << fileName;
+                ASSERT_EQ(readFile(testFilesPath + TestFiles::testNameFromFileName(fileName) + "_Ref.vm"), result.output) << fileName;
+                ASSERT_TRUE(result.statistics.empty()) << fileName;
+            }
+        }
+    }
+
+    TEST(SourceCompilerTest, ReusedCompilerMatchesNewCompilers) {
+        SourceCompiler compiler;
+        const auto options = allOptimizations();
+
+        for(const auto& fileName : TestFiles::TEST_FILE_NAMES) {
+            const auto source = readFile(testFilesPath + fileName);
+
+            // the state of the previous (optimized or failed) compilation must not leak into the next one
+            compiler.compile("class Broken { function void f() { let x = ; } }");
+            const auto optimized = compiler.compile(source, options);
+            const auto unoptimized = compiler.compile(source);
+
+            const auto newOptimized = SourceCompiler{}.compile(source, options);
+
+            ASSERT_EQ(newOptimized.output, optimized.output) << fileName;
+            ASSERT_EQ(printStatistics(newOptimized.statistics), printStatistics(optimized.statistics)) << fileName;
+            ASSERT_EQ(SourceCompiler{}.compile(source).output, unoptimized.output) << fileName;
+        }
+    }
+
+    TEST(SourceCompilerTest, ReportsStructuredErrors) {
+        SourceCompiler compiler;
+
+        const auto result = compiler.compile("class Main {\n"
+                                             "    function void main() {\n"
+                                             "        let x = 1;\n"
+                                             "        do Output.printInt(;\n"
+                                             "        return;\n"
+                                             "    }\n"
+                                             "}\n");
+
+        ASSERT_FALSE(result.succeeded());
+        ASSERT_TRUE(result.output.empty());
+        ASSERT_EQ(2u, result.errors.size());
+        ASSERT_EQ(3u, result.errors[0].line());
+        ASSERT_EQ("Undefined variable 'x'.", result.errors[0].message());
+        ASSERT_EQ(4u, result.errors[1].line());
+
+        const auto lexerResult = compiler.compile("class Main { static int 1b; }");
+
+        ASSERT_EQ(1u, lexerResult.errors.size());
+        ASSERT_EQ(1u, lexerResult.errors[0].line());
+        ASSERT_EQ("Invalid token >>1b<<", lexerResult.errors[0].message());
+    }
+
+    TEST(SourceCompilerTest, ReusedCompilerAllocatesLess) {
+        SourceCompiler compiler;
+        SourceCompiler::Result result;
+        const auto source = readFile(testFilesPath + "SquareGame.jack");
+        const CompilationOptions options;
+
+        const auto firstAllocationCount = AllocationCounter::allocationCount();
+        compiler.compile(source, options, result);
+        const auto firstCompilationAllocations = AllocationCounter::allocationCount() - firstAllocationCount;
+
+        const auto secondAllocationCount = AllocationCounter::allocationCount();
+        compiler.compile(source, options, result);
+        const auto secondCompilationAllocations = AllocationCounter::allocationCount() - secondAllocationCount;
+
+        ASSERT_TRUE(result.succeeded());
+        ASSERT_LT(secondCompilationAllocations, firstCompilationAllocations) 
+            << firstCompilationAllocations << " allocations before, " << secondCompilationAllocations << " after reuse";
+    }
+
+    TEST(SourceCompilerTest, CompilesOnSeveralThreadsAtOnce) {
+        vector<string> sources;
+        vector<string> references;
+
+        for(const auto& fileName : TestFiles::TEST_FILE_NAMES) {
+            sources.push_back(readFile(testFilesPath + fileName));
+            references.push_back(readFile(testFilesPath + TestFiles::testNameFromFileName(fileName) + "_Ref.vm"));
+        }
+
+        vector<std::thread> threads;
+        vector<size_t> mismatches(8);
+
+        for(size_t i = 0; i < mismatches.size(); ++i) {
+            threads.emplace_back([&, i] {
+                for(auto repetition = 0; repetition < 20; ++repetition) {
+                    for(size_t file = 0; file < sources.size(); ++file) {
+                        if(JackCompiler::compileSource(sources[file]).output != references[file]) {
+                            ++mismatches[i];
+                        }
+                    }
+                }
+            });
+        }
+
+        for(auto& thread : threads) {
+            thread.join();
+        }
+
+        for(const auto threadMismatches : mismatches) {
+            ASSERT_EQ(0u, threadMismatches);
+        }
+    }
+}
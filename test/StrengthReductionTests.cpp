@@ -0,0 +1,137 @@
+#include "CompilationEngine.h"
+#include "StrengthReduction.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::array;
+using std::string;
+using std::stringstream;
+using std::vector;
+using JackCompiler::VMWriter;
+namespace StrengthReduction = JackCompiler::StrengthReduction;
+
+namespace {
+    int wrap(int value) {
+        value &= 0xFFFF;
+        return value >= 0x8000 ? value - 0x10000 : value;
+    }
+
+    /**
+     * \brief Executes a sequence of push/pop/arithmetic instructions on a stack that initially
+     * contains a single value like the Hack virtual-machine would.
+     */
+    int execute(const vector<VMWriter::Instruction>& instructions, int value) {
+        using Type = VMWriter::Instruction::Type;
+
+        vector<int> stack{value};
+        array<int, 8> temp{};
+
+        auto pop = [&stack] () {
+            const int top = stack.back();
+            stack.pop_back();
+            return top;
+        };
+
+        for(const auto& instruction : instructions) {
+            if(instruction.type == Type::PUSH) {
+                stack.push_back(instruction.segment == VMWriter::Segment::TEMP ? temp.at(instruction.value) : instruction.value);
+            }
+            else if(instruction.type == Type::POP) {
+                temp.at(instruction.value) = pop();
+            }
+            else if(instruction.command == VMWriter::Command::NEG) {
+                stack.push_back(wrap(-pop()));
+            }
+            else {
+                const int right = pop();
+                const int left = pop();
+                stack.push_back(wrap(instruction.command == VMWriter::Command::ADD ? left + right : left - right));
+            }
+        }
+
+        EXPECT_EQ(1, stack.size());
+        return stack.back();
+    }
+
+    bool containsNegation(const vector<VMWriter::Instruction>& instructions) {
+        return std::any_of(instructions.cbegin(), instructions.cend(), [] (const VMWriter::Instruction& instruction) {
+            return instruction.type == VMWriter::Instruction::Type::ARITHMETIC && instruction.command == VMWriter::Command::NEG;
+        });
+    }
+
+    TEST(StrengthReductionTest, MultipliesLikeMathMultiply) {
+        for(int constant = -300; constant <= 300; ++constant) {
+            const auto instructions = StrengthReduction::multiplication(constant);
+
+            if(!instructions) {
+                continue;
+            }
+
+            for(int value : {0, 1, -1, 7, -13, 255, 1000, -32768, 32767}) {
+                ASSERT_EQ(wrap(value * constant), execute(*instructions, value)) << value << " * " << constant;
+            }
+        }
+    }
+
+    TEST(StrengthReductionTest, ChoosesTheCheaperAlternative) {
+        const auto multiplicationByTwo = StrengthReduction::multiplication(2);
+        ASSERT_TRUE(multiplicationByTwo);
+        ASSERT_EQ(4, multiplicationByTwo->size());
+
+        // 31 * x = -x + 32 * x is cheaper than 16 * x + 8 * x + 4 * x + 2 * x + x...
+        const auto multiplicationByThirtyOne = StrengthReduction::multiplication(31);
+        ASSERT_TRUE(multiplicationByThirtyOne);
+        ASSERT_TRUE(containsNegation(*multiplicationByThirtyOne));
+
+        // ...but 15 * x = -x + 16 * x needs an additional doubling and negation
+        const auto multiplicationByFifteen = StrengthReduction::multiplication(15);
+        ASSERT_TRUE(multiplicationByFifteen);
+        ASSERT_FALSE(containsNegation(*multiplicationByFifteen));
+
+        // long chains are not worth the code size
+        ASSERT_FALSE(StrengthReduction::multiplication(32767));
+        ASSERT_FALSE(StrengthReduction::division(2));
+        ASSERT_TRUE(StrengthReduction::division(1));
+    }
+
+    TEST(StrengthReductionTest, ReplacesCallsWithConstantOperands) {
+        const string jackCode{"class Main { function int f(int x) { return (x * 2) + (3 * x) + (x / 1) + (x * x) + (x / 2); } }"};
+
+        JackCompiler::CompilationOptions options;
+        options.reduceStrength = true;
+
+        stringstream outputStream;
+        JackCompiler::CompilationEngine engine{jackCode, outputStream, options};
+        engine.compileClass();
+
+        ASSERT_EQ("function Main.f 0\n"
+                  "push argument 0\n"
+                  "pop temp 0\n"
+                  "push temp 0\n"
+                  "push temp 0\n"
+                  "add\n"
+                  "push argument 0\n"
+                  "pop temp 0\n"
+                  "push temp 0\n"
+                  "push temp 0\n"
+                  "push temp 0\n"
+                  "add\n"
+                  "add\n"
+                  "add\n"
+                  "push argument 0\n"
+                  "add\n"
+                  "push argument 0\n"
+                  "push argument 0\n"
+                  "call Math.multiply 2\n"
+                  "add\n"
+                  "push argument 0\n"
+                  "push constant 2\n"
+                  "call Math.divide 2\n"
+                  "add\n"
+                  "return\n", outputStream.str());
+    }
+}
@@ -0,0 +1,86 @@
+#include "TestCompilation.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+using JackCompiler::CompilationOptions;
+using TestCompilation::compile;
+
+namespace {
+    CompilationOptions poolingOptions() {
+        CompilationOptions options;
+        options.poolStrings = true;
+        return options;
+    }
+
+    TEST(StringPoolTest, BuildsEachStringOnce) {
+        const string jackCode{"class Main { static int x;"
+                              "  function void f() { do Output.printString(\"ab\"); do Output.printString(\"\"); return; }"
+                              "  function void g() { do Output.printString(\"ab\"); return; }"
+                              "  function int h() { return x; } }"};
+
+        ASSERT_EQ("function Main.f 0\n"
+                  "push static 1\n"
+                  "if-goto STRING_POOL_READY\n"
+                  "call Main.$initStringPool 0\n"
+                  "pop temp 0\n"
+                  "label STRING_POOL_READY\n"
+                  "push static 1\n"
+                  "call Output.printString 1\n"
+                  "pop temp 0\n"
+                  "push static 2\n"
+                  "call Output.printString 1\n"
+                  "pop temp 0\n"
+                  "push constant 0\n"
+                  "return\n"
+                  "function Main.g 0\n"
+                  "push static 1\n"
+                  "if-goto STRING_POOL_READY\n"
+                  "call Main.$initStringPool 0\n"
+                  "pop temp 0\n"
+                  "label STRING_POOL_READY\n"
+                  "push static 1\n"
+                  "call Output.printString 1\n"
+                  "pop temp 0\n"
+                  "push constant 0\n"
+                  "return\n"
+                  "function Main.h 0\n"
+                  "push static 0\n"
+                  "return\n"
+                  "function Main.$initStringPool 0\n"
+                  "push constant 2\n"
+                  "call String.new 1\n"
+                  "push constant 97\n"
+                  "call String.appendChar 2\n"
+                  "push constant 98\n"
+                  "call String.appendChar 2\n"
+                  "pop static 1\n"
+                  "push constant 0\n"
+                  "call String.new 1\n"
+                  "pop static 2\n"
+                  "push constant 0\n"
+                  "return\n", compile(jackCode, poolingOptions()));
+    }
+
+    class StringPoolTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with pooled string constants. Strings may only be built by the initializer of the pool.
+     */
+    TEST_P(StringPoolTest, BuildsStringsOnlyInInitializer) {
+        const auto output = compile(TestCompilation::readTestFile(GetParam()), poolingOptions());
+        const auto firstStringPosition = output.find("call String.new");
+
+        if(firstStringPosition != string::npos) {
+            // the initializer is the last function of the class
+            const auto lastFunctionPosition = output.rfind("\nfunction ");
+            ASSERT_LT(lastFunctionPosition, firstStringPosition);
+            const auto lastFunction = output.substr(lastFunctionPosition + 1, output.find('\n', lastFunctionPosition + 1) - lastFunctionPosition - 1);
+            ASSERT_NE(string::npos, lastFunction.find(".$initStringPool 0")) << lastFunction;
+        }
+    }
+
+    INSTANTIATE_TEST_CASE_P(StringPoolTestInstance, StringPoolTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}
@@ -0,0 +1,58 @@
+#include "JackCompiler.h"
+#include "TaskScheduler.h"
+#include "TestDirectory.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::atomic;
+using std::vector;
+
+namespace {
+    TEST(TaskSchedulerTest, RunsEveryTaskOnce) {
+        for(const size_t jobs : {1, 3, 8, 64}) {
+            vector<atomic<int>> runs(100);
+
+            JackCompiler::TaskScheduler::run(runs.size(), jobs, [&runs] (size_t task) { ++runs[task]; });
+
+            for(const auto& count : runs) {
+                ASSERT_EQ(1, count.load()) << "jobs: " << jobs;
+            }
+        }
+    }
+
+    TEST(TaskSchedulerTest, RethrowsExceptionsOfTasks) {
+        atomic<size_t> runs{};
+
+        ASSERT_THROW(JackCompiler::TaskScheduler::run(1000, 4, [&runs] (size_t task) {
+            ++runs;
+
+            if(task == 0) {
+                throw std::runtime_error{"Task failed."};
+            }
+        }), std::runtime_error);
+
+        ASSERT_GE(runs.load(), 1u);
+    }
+
+    class ParallelCompilationTest : public testing::TestWithParam<size_t> {};
+
+    /**
+     * \brief Compiles a copy of the test-file directory on several threads, the outputs must match the
+     * reference-files independent of the number of threads.
+     */
+    TEST_P(ParallelCompilationTest, OutputsMatchReferences) {
+        const TestDirectory::TemporaryDirectory directory{"jobs"};
+        const auto directoryPath = directory.copyTestFiles();
+
+        JackCompiler::CompilationOptions options;
+        options.jobs = GetParam();
+
+        ASSERT_EQ("", TestDirectory::compile(directoryPath, options));
+        TestDirectory::assertOutputsMatchReferences(directoryPath);
+    }
+
+    INSTANTIATE_TEST_CASE_P(ParallelCompilationTestInstance, ParallelCompilationTest, ::testing::Values(1, 2, 4, 16));
+}
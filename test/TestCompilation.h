@@ -0,0 +1,102 @@
+#pragma once
+#include "CompilationEngine.h"
+#include "MappedFile.h"
+#include "TestFiles.h"
+#include "VMInterpreter.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+/**
+ * \brief Helpers for tests that compare the output of an optimization with the reference output.
+ */
+namespace TestCompilation {
+    /**
+     * \brief Compiles a class held in memory.
+     * \param jackCode The Jack code of the class
+     * \param options The options that control the compilation
+     * \param statistics Receives the statistics of the compilation if it is not nullptr
+     * \return The VM code of the class
+     */
+    inline std::string compile(const std::string& jackCode, const JackCompiler::CompilationOptions& options = {},
+                               JackCompiler::OptimizationStatistics* statistics = nullptr) {
+        std::stringstream outputStream;
+        JackCompiler::CompilationEngine engine{jackCode, outputStream, options};
+        engine.compileClass();
+
+        if(statistics != nullptr) {
+            *statistics = engine.statistics();
+        }
+
+        return outputStream.str();
+    }
+
+    /**
+     * \brief Reads a file of the test-files directory.
+     * \param fileName The name of the file
+     * \return The content of the file
+     */
+    inline std::string readTestFile(const std::string& fileName) {
+        const JackCompiler::MappedFile inputFile{testFilesPath + fileName};
+        EXPECT_TRUE(inputFile) << "The test-file " << fileName << " could not be mapped.";
+        return inputFile ? std::string{inputFile.data()} : std::string{};
+    }
+
+    /**
+     * \brief Counts the instructions of VM code.
+     */
+    inline long countLines(const std::string& vmCode) {
+        return static_cast<long>(std::count(vmCode.cbegin(), vmCode.cend(), '\n'));
+    }
+
+    /**
+     * \brief Asserts that the instructions an optimization reports as removed account for the difference
+     * between the lengths of the reference output and the optimized output of a class.
+     * \param jackCode The Jack code of the class
+     * \param options The options that enable the optimization
+     * \param counterNames The names of the statistics' counters of removed instructions
+     */
+    inline void assertReportsRemovedInstructions(const std::string& jackCode, const JackCompiler::CompilationOptions& options,
+                                                 std::initializer_list<std::string_view> counterNames) {
+        JackCompiler::OptimizationStatistics statistics;
+        const auto vmCode = compile(jackCode, options, &statistics);
+
+        long removedInstructions{};
+
+        for(const auto counterName : counterNames) {
+            removedInstructions += static_cast<long>(statistics.count(counterName));
+        }
+
+        ASSERT_EQ(countLines(compile(jackCode)), countLines(vmCode) + removedInstructions);
+    }
+
+    /**
+     * \brief Asserts that the function Main.f(a, b) of a class returns the same results for all combinations
+     * of arguments when it is compiled with and without optimizations, and that the optimized code executes
+     * fewer instructions.
+     * \param jackCode The Jack code of the class
+     * \param options The options that enable the optimizations
+     * \param aValues The values of the first argument
+     * \param bValues The values of the second argument
+     */
+    inline void assertPreservesResults(const std::string& jackCode, const JackCompiler::CompilationOptions& options,
+                                       std::initializer_list<int> aValues, std::initializer_list<int> bValues) {
+        VMInterpreter referenceInterpreter;
+        referenceInterpreter.load("Main", compile(jackCode));
+
+        VMInterpreter interpreter;
+        interpreter.load("Main", compile(jackCode, options));
+
+        for(const int a : aValues) {
+            for(const int b : bValues) {
+                ASSERT_EQ(referenceInterpreter.call("Main.f", {a, b}), interpreter.call("Main.f", {a, b}))
+                    << "f(" << a << ", " << b << ")";
+            }
+        }
+
+        ASSERT_LT(interpreter.executedInstructions(), referenceInterpreter.executedInstructions());
+    }
+}
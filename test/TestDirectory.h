@@ -0,0 +1,102 @@
+#pragma once
+#include "JackCompiler.h"
+#include "TestFiles.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+/**
+ * \brief Helpers for tests that compile copies of the test-files in temporary directories.
+ */
+namespace TestDirectory {
+    /**
+     * \brief Reads a file, a file that does not exist is read as empty.
+     */
+    inline std::string readFile(const std::filesystem::path& path) {
+        std::ifstream stream{path};
+        return {std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    }
+
+    /**
+     * \brief A directory in the temporary directory, which is removed with its content when it is destroyed.
+     * Every directory gets a unique name, so that tests which run at the same time (e.g. in several processes)
+     * do not use the same directory.
+     */
+    class TemporaryDirectory {
+    public:
+        /**
+         * \brief Creates the directory.
+         * \param name The name the directory's name starts with
+         */
+        explicit TemporaryDirectory(const std::string& name) {
+            std::random_device randomDevice;
+            std::mt19937_64 generator{(static_cast<std::uint64_t>(randomDevice()) << 32) ^ randomDevice()};
+
+            // a directory that already exists belongs to another test
+            do {
+                std::ostringstream directoryName;
+                directoryName << "jack-compiler-" << name << '-' << std::hex << generator();
+                path_ = std::filesystem::temp_directory_path() / directoryName.str();
+            } while(!std::filesystem::create_directories(path_));
+        }
+
+        ~TemporaryDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(path_, error);
+        }
+
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+        const std::filesystem::path& path() const { return path_; }
+
+        /**
+         * \brief Copies the test-files into a subdirectory (or into the directory itself).
+         * \param subdirectoryName The name of the subdirectory, which is created if it does not exist
+         * \return The path of the directory that contains the copies
+         */
+        std::filesystem::path copyTestFiles(const std::string& subdirectoryName = {}) const {
+            const auto directoryPath = subdirectoryName.empty() ? path_ : path_ / subdirectoryName;
+            std::filesystem::create_directories(directoryPath);
+
+            for(const auto& fileName : TestFiles::TEST_FILE_NAMES) {
+                std::filesystem::copy_file(testFilesPath + fileName, directoryPath / fileName);
+            }
+
+            return directoryPath;
+        }
+
+    private:
+        std::filesystem::path path_;
+    };
+
+    /**
+     * \brief Compiles a file or directory and gets what the compiler reported.
+     * \param path The path of the file or directory
+     * \param options The options that control the compilation
+     * \param expectedResult The result the compilation is expected to return
+     */
+    inline std::string compile(const std::filesystem::path& path, const JackCompiler::CompilationOptions& options = {},
+                               int expectedResult = 0) {
+        std::stringstream reportStream;
+        EXPECT_EQ(expectedResult, JackCompiler::compile(path.string(), options, reportStream)) << reportStream.str();
+        return reportStream.str();
+    }
+
+    /**
+     * \brief Asserts that the output of every test-file in a directory matches its reference-file.
+     */
+    inline void assertOutputsMatchReferences(const std::filesystem::path& directoryPath) {
+        for(const auto& fileName : TestFiles::TEST_FILE_NAMES) {
+            const auto name = TestFiles::testNameFromFileName(fileName);
+
+            ASSERT_EQ(readFile(testFilesPath + name + "_Ref.vm"), readFile(directoryPath / (name + ".vm"))) << fileName;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+
+extern std::string testFilesPath;
+
+namespace TestFiles {
+    /**
+     * \brief The names of the .jack test-files contained in the test-files directory. For each
+     * file <filename>.jack a reference-file <filename>_Ref.vm exists in the same directory.
+     */
+    inline const std::vector<std::string> TEST_FILE_NAMES{
+        "AverageMain.jack",
+        "ComplexArraysMain.jack",
+        "ConvertToBinMain.jack",
+        "PongBall.jack",
+        "PongBat.jack",
+        "PongGame.jack",
+        "PongMain.jack",
+        "SevenMain.jack",
+        "Square.jack",
+        "SquareGame.jack",
+        "SquareMain.jack"
+    };
+
+    /**
+     * \brief Creates a test-name from a test-file parameter by stripping the file extension.
+     */
+    inline std::string testNameFromFileName(const std::string& fileName) {
+        return fileName.substr(0, fileName.find('.'));
+    }
+}
@@ -0,0 +1,264 @@
+#include "Tokenizer.h"
+#include "MappedFile.h"
+#include "TokenBuffer.h"
+#include "TestFiles.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+
+using std::vector;
+using std::string;
+using std::istream;
+using std::ifstream;
+using std::stringstream;
+using std::runtime_error;
+using std::string_view;
+using JackCompiler::Tokenizer;
+using JackCompiler::MappedFile;
+using JackCompiler::TokenBuffer;
+namespace fs = std::filesystem;
+
+namespace {
+    struct TokenRecord {
+        Tokenizer::TokenType type;
+        string text;
+        size_t line;
+
+        bool operator==(const TokenRecord& other) const {
+            return type == other.type && text == other.text && line == other.line;
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const TokenRecord& record) {
+        return stream << "(type " << static_cast<int>(record.type) << ", >>" << record.text 
+                      << "<<, line " << record.line << ')';
+    }
+
+    vector<TokenRecord> tokenize(Tokenizer& tokenizer) {
+        vector<TokenRecord> tokens;
+
+        while(tokenizer.hasMoreTokens()) {
+            tokenizer.advance();
+
+            switch(tokenizer.tokenType()) {
+                case Tokenizer::TokenType::KEYWORD:
+                case Tokenizer::TokenType::IDENTIFIER:
+                    tokens.push_back({tokenizer.tokenType(), string{tokenizer.identifier()}, tokenizer.getCurrentLine()});
+                    break;
+                case Tokenizer::TokenType::SYMBOL:
+                    tokens.push_back({tokenizer.tokenType(), string(1, tokenizer.symbol()), tokenizer.getCurrentLine()});
+                    break;
+                case Tokenizer::TokenType::INT_CONST:
+                    tokens.push_back({tokenizer.tokenType(), std::to_string(tokenizer.intVal()), tokenizer.getCurrentLine()});
+                    break;
+                case Tokenizer::TokenType::STRING_CONST:
+                    tokens.push_back({tokenizer.tokenType(), string{tokenizer.stringVal()}, tokenizer.getCurrentLine()});
+                    break;
+            }
+        }
+
+        return tokens;
+    }
+
+    vector<TokenRecord> tokenize(istream& inputStream, Tokenizer::LexerMode lexerMode, 
+        size_t chunkSize = Tokenizer::DEFAULT_CHUNK_SIZE) {
+        Tokenizer tokenizer{inputStream, lexerMode, chunkSize};
+        return tokenize(tokenizer);
+    }
+
+    vector<TokenRecord> tokenize(string_view source) {
+        Tokenizer tokenizer{source};
+        return tokenize(tokenizer);
+    }
+
+    vector<TokenRecord> tokenize(const TokenBuffer& tokenBuffer) {
+        Tokenizer tokenizer{tokenBuffer};
+        return tokenize(tokenizer);
+    }
+
+    string tokenizationError(const string& input) {
+        string streamError;
+        string chunkedStreamError;
+        string bufferError;
+        string tokenBufferError;
+
+        try {
+            stringstream inputStream{input};
+            tokenize(inputStream, Tokenizer::LexerMode::SCANNER);
+        }
+        catch(const runtime_error& e) {
+            streamError = e.what();
+        }
+
+        try {
+            stringstream inputStream{input};
+            tokenize(inputStream, Tokenizer::LexerMode::SCANNER, 1);
+        }
+        catch(const runtime_error& e) {
+            chunkedStreamError = e.what();
+        }
+
+        try {
+            tokenize(string_view{input});
+        }
+        catch(const runtime_error& e) {
+            bufferError = e.what();
+        }
+
+        try {
+            // pre-lexing records the error, walking the token-buffer throws it
+            const TokenBuffer tokenBuffer{input};
+            tokenize(tokenBuffer);
+        }
+        catch(const runtime_error& e) {
+            tokenBufferError = e.what();
+        }
+
+        EXPECT_EQ(streamError, chunkedStreamError) << "Reading the stream in small chunks produced a different error.";
+        EXPECT_EQ(streamError, bufferError) << "Stream- and buffer-input produced different errors.";
+        EXPECT_EQ(streamError, tokenBufferError) << "Stream-input and pre-lexing produced different errors.";
+        return streamError;
+    }
+
+    class TokenizerTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and tokenizes
+     * it using the regex-lexer, the scanner reading from a stream, the scanner reading from a memory-mapped
+     * file and a token-buffer pre-lexed from the memory-mapped file. All token-streams are expected to be equal.
+     */
+    TEST_P(TokenizerTest, ScannerMatchesRegexLexer) {
+        const fs::path inputPath{testFilesPath + GetParam()};
+
+        ASSERT_TRUE(fs::exists(inputPath)) << "The test-file " << inputPath << " does not exist.";
+
+        ifstream scannerInputStream{inputPath};
+        ifstream regexInputStream{inputPath};
+
+        const auto scannerTokens = tokenize(scannerInputStream, Tokenizer::LexerMode::SCANNER);
+        const auto regexTokens = tokenize(regexInputStream, Tokenizer::LexerMode::REGEX);
+
+        const MappedFile mappedFile{inputPath};
+        ASSERT_TRUE(mappedFile) << "The test-file " << inputPath << " could not be mapped.";
+        const auto mappedFileTokens = tokenize(mappedFile.data());
+        const auto tokenBufferTokens = tokenize(TokenBuffer{mappedFile.data()});
+
+        ASSERT_FALSE(scannerTokens.empty());
+        ASSERT_EQ(regexTokens, scannerTokens);
+        ASSERT_EQ(regexTokens, mappedFileTokens);
+        ASSERT_EQ(regexTokens, tokenBufferTokens);
+    }
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and tokenizes it
+     * with the scanner reading from a stream in chunks of various (small) sizes, so that tokens and
+     * comments are split across chunk-boundaries. All token-streams are expected to equal the one
+     * produced when reading from a memory-mapped file.
+     */
+    TEST_P(TokenizerTest, ChunkedScannerMatchesBufferScanner) {
+        const fs::path inputPath{testFilesPath + GetParam()};
+
+        ASSERT_TRUE(fs::exists(inputPath)) << "The test-file " << inputPath << " does not exist.";
+
+        const MappedFile mappedFile{inputPath};
+        ASSERT_TRUE(mappedFile) << "The test-file " << inputPath << " could not be mapped.";
+        const auto mappedFileTokens = tokenize(mappedFile.data());
+
+        for(const size_t chunkSize : {1, 2, 3, 7, 64}) {
+            ifstream inputStream{inputPath, std::ios::binary};
+            ASSERT_EQ(mappedFileTokens, tokenize(inputStream, Tokenizer::LexerMode::SCANNER, chunkSize)) 
+                << "Chunk-size: " << chunkSize;
+        }
+    }
+
+    INSTANTIATE_TEST_CASE_P(TokenizerTestInstance, TokenizerTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+
+    TEST(TokenizerScannerTest, SplitsTokensWithoutWhitespace) {
+        const vector<TokenRecord> expected{
+            {Tokenizer::TokenType::KEYWORD,      "let",     1},
+            {Tokenizer::TokenType::IDENTIFIER,   "a_1",     1},
+            {Tokenizer::TokenType::SYMBOL,       "[",       1},
+            {Tokenizer::TokenType::INT_CONST,    "2",       1},
+            {Tokenizer::TokenType::SYMBOL,       "]",       1},
+            {Tokenizer::TokenType::SYMBOL,       "=",       1},
+            {Tokenizer::TokenType::STRING_CONST, "x // y ", 1},
+            {Tokenizer::TokenType::SYMBOL,       ";",       1},
+            {Tokenizer::TokenType::IDENTIFIER,   "b",       2}
+        };
+
+        const string input{"let a_1[2]=\"x // y \";/* comment\n spanning lines */\tb // end"};
+        stringstream inputStream{input};
+
+        ASSERT_EQ(expected, tokenize(inputStream, Tokenizer::LexerMode::SCANNER));
+        ASSERT_EQ(expected, tokenize(string_view{input}));
+        ASSERT_EQ(expected, tokenize(TokenBuffer{input}));
+
+        for(const size_t chunkSize : {1, 2, 3, 5}) {
+            stringstream chunkedInputStream{input};
+            ASSERT_EQ(expected, tokenize(chunkedInputStream, Tokenizer::LexerMode::SCANNER, chunkSize))
+                << "Chunk-size: " << chunkSize;
+        }
+    }
+
+    TEST(TokenizerScannerTest, PeeksSymbols) {
+        const string input{"x[i] = f(y.z);"};
+        const TokenBuffer tokenBuffer{input};
+        stringstream inputStream{input};
+
+        Tokenizer tokenBufferTokenizer{tokenBuffer};
+        Tokenizer streamTokenizer{inputStream};
+
+        ASSERT_EQ(12, tokenBuffer.size());
+        ASSERT_EQ('[', tokenBuffer.symbol(1));
+        ASSERT_EQ("f", tokenBuffer.text(5));
+
+        for(auto* tokenizer : {&tokenBufferTokenizer, &streamTokenizer}) {
+            tokenizer->advance();
+            ASSERT_EQ('[', tokenizer->peekSymbol());
+            tokenizer->advance();
+            ASSERT_EQ('\0', tokenizer->peekSymbol());
+        }
+
+        ASSERT_EQ(']', tokenBufferTokenizer.peekSymbol(2));
+        ASSERT_EQ('(', tokenBufferTokenizer.peekSymbol(5));
+        ASSERT_EQ(')', tokenBufferTokenizer.peekSymbol(9));
+        ASSERT_EQ('\0', tokenBufferTokenizer.peekSymbol(11));
+        ASSERT_THROW(streamTokenizer.peekSymbol(2), runtime_error);
+    }
+
+    TEST(TokenizerScannerTest, ReportsInvalidTokens) {
+        ASSERT_EQ("On line 2: Invalid token >>1abc<<", tokenizationError("let\nx = 1abc;"));
+        ASSERT_EQ("On line 1: Invalid token >>$<<", tokenizationError("let $ = 1;"));
+    }
+
+    TEST(TokenizerScannerTest, ReportsMalformedStringLiterals) {
+        ASSERT_EQ("On line 2: Malformed string literal. Did you forget closing '\"'?", 
+            tokenizationError("do f(\"a\");\ndo f(\"a);\n"));
+    }
+
+    TEST(TokenizerScannerTest, ReportsUnclosedBlockComments) {
+        ASSERT_EQ("On line 2: A block-comment starting on this line was never closed.", 
+            tokenizationError("let x = 1;\nlet y = 2; /* comment\n\n"));
+    }
+
+    TEST(TokenizerScannerTest, ClassifiesKeywords) {
+        const string keywords{"class constructor function method field static var int char boolean void "
+                              "true false null this let do if else while return"};
+        const auto tokens = tokenize(string_view{keywords});
+
+        ASSERT_EQ(21, tokens.size());
+
+        for(const auto& token : tokens) {
+            ASSERT_EQ(Tokenizer::TokenType::KEYWORD, token.type) << token;
+        }
+
+        for(const auto& token : tokenize("Class classes i dos nul returns thisx v w x")) {
+            ASSERT_EQ(Tokenizer::TokenType::IDENTIFIER, token.type) << token;
+        }
+    }
+}
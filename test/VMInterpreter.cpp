@@ -0,0 +1,285 @@
+#include "VMInterpreter.h"
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+using std::istringstream;
+using std::runtime_error;
+using std::to_string;
+
+namespace {
+    constexpr int SP = 0;
+    constexpr int LCL = 1;
+    constexpr int ARG = 2;
+    constexpr int THIS = 3;
+    constexpr int THAT = 4;
+    constexpr int TEMP = 5;
+    constexpr int STATIC = 16;
+    constexpr int STACK = 256;
+    // the return address of the function called by the test
+    constexpr int HALT = -1;
+
+    int16_t wrap(int value) {
+        value &= 0xFFFF;
+        return static_cast<int16_t>(value >= 0x8000 ? value - 0x10000 : value);
+    }
+
+    int16_t fromBool(bool value) {
+        return value ? -1 : 0;
+    }
+}
+
+void VMInterpreter::load(const string& fileName, const string& vmCode) {
+    const size_t file = files_.size();
+    files_.push_back(fileName);
+
+    istringstream codeStream{vmCode};
+    string line;
+    string currentFunction;
+
+    while(std::getline(codeStream, line)) {
+        line = line.substr(0, line.find("//"));
+
+        istringstream lineStream{line};
+        Instruction instruction;
+        instruction.file = file;
+
+        if(!(lineStream >> instruction.command)) {
+            continue;
+        }
+
+        lineStream >> instruction.argument >> instruction.value;
+
+        if(instruction.command == "function") {
+            currentFunction = instruction.argument;
+            functions_[currentFunction] = instructions_.size();
+        }
+        else if(instruction.command == "label") {
+            labels_[currentFunction + '$' + instruction.argument] = instructions_.size();
+        }
+
+        if(instruction.command == "label" || instruction.command == "goto" || instruction.command == "if-goto") {
+            instruction.argument = currentFunction + '$' + instruction.argument;
+        }
+
+        instructions_.push_back(instruction);
+    }
+}
+
+int VMInterpreter::call(const string& functionName, const vector<int>& arguments) {
+    sp() = STACK;
+
+    for(const int argument : arguments) {
+        push(argument);
+    }
+
+    // the frame of the caller
+    push(HALT);
+
+    for(int pointer = LCL; pointer <= THAT; ++pointer) {
+        push(at(pointer));
+    }
+
+    at(ARG) = wrap(sp() - static_cast<int>(arguments.size()) - 5);
+    at(LCL) = sp();
+
+    if(functions_.count(functionName) == 0) {
+        throw runtime_error{"Unknown function " + functionName};
+    }
+
+    for(auto pc = static_cast<int>(functions_.at(functionName)); pc != HALT; ) {
+        if(++executedInstructions_ > MAX_INSTRUCTIONS) {
+            throw runtime_error{"Too many instructions"};
+        }
+
+        const auto& instruction = instructions_.at(static_cast<size_t>(pc));
+        const auto& command = instruction.command;
+        ++pc;
+
+        if(command == "push") {
+            push(instruction.argument == "constant" ? instruction.value : at(address(instruction)));
+        }
+        else if(command == "pop") {
+            const int value = pop();
+            at(address(instruction)) = wrap(value);
+        }
+        else if(command == "add" || command == "sub" || command == "and" || command == "or" || 
+                command == "eq" || command == "gt" || command == "lt") {
+            const int right = pop();
+            const int left = pop();
+
+            if(command == "add") push(wrap(left + right));
+            else if(command == "sub") push(wrap(left - right));
+            else if(command == "and") push(wrap(left & right));
+            else if(command == "or") push(wrap(left | right));
+            else if(command == "eq") push(fromBool(left == right));
+            else if(command == "gt") push(fromBool(left > right));
+            else push(fromBool(left < right));
+        }
+        else if(command == "neg") {
+            push(wrap(-pop()));
+        }
+        else if(command == "not") {
+            push(wrap(~pop()));
+        }
+        else if(command == "label") {
+            // labels are resolved when loading
+        }
+        else if(command == "goto") {
+            pc = static_cast<int>(labels_.at(instruction.argument));
+        }
+        else if(command == "if-goto") {
+            if(pop() != 0) {
+                pc = static_cast<int>(labels_.at(instruction.argument));
+            }
+        }
+        else if(command == "function") {
+            for(int i = 0; i < instruction.value; ++i) {
+                push(0);
+            }
+        }
+        else if(command == "call") {
+            if(functions_.count(instruction.argument) == 0) {
+                callBuiltIn(instruction.argument, instruction.value);
+                continue;
+            }
+
+            push(pc);
+
+            for(int pointer = LCL; pointer <= THAT; ++pointer) {
+                push(at(pointer));
+            }
+
+            at(ARG) = wrap(sp() - instruction.value - 5);
+            at(LCL) = sp();
+            pc = static_cast<int>(functions_.at(instruction.argument));
+        }
+        else if(command == "return") {
+            const int frame = at(LCL);
+            const int returnAddress = at(frame - 5);
+
+            at(at(ARG)) = wrap(pop());
+            sp() = wrap(at(ARG) + 1);
+
+            for(int pointer = THAT; pointer >= LCL; --pointer) {
+                at(pointer) = at(frame - (THAT + 1 - pointer));
+            }
+
+            pc = returnAddress;
+        }
+        else {
+            throw runtime_error{"Invalid command " + command};
+        }
+    }
+
+    return pop();
+}
+
+int16_t& VMInterpreter::at(int address) {
+    if(address < 0 || address >= static_cast<int>(ram_.size())) {
+        throw runtime_error{"Invalid address " + to_string(address)};
+    }
+
+    return ram_[static_cast<size_t>(address)];
+}
+
+int16_t& VMInterpreter::sp() {
+    return ram_[SP];
+}
+
+void VMInterpreter::push(int value) {
+    at(sp()) = wrap(value);
+    ++sp();
+}
+
+int VMInterpreter::pop() {
+    --sp();
+    return at(sp());
+}
+
+int VMInterpreter::address(const Instruction& instruction) {
+    const auto& segment = instruction.argument;
+    const int index = instruction.value;
+
+    if(segment == "local") return at(LCL) + index;
+    if(segment == "argument") return at(ARG) + index;
+    if(segment == "this") return at(THIS) + index;
+    if(segment == "that") return at(THAT) + index;
+    if(segment == "pointer") return THIS + index;
+    if(segment == "temp") return TEMP + index;
+
+    if(segment == "static") {
+        const auto key = std::make_pair(instruction.file, index);
+
+        if(staticAddresses_.count(key) == 0) {
+            const int staticAddress = STATIC + static_cast<int>(staticAddresses_.size());
+            staticAddresses_[key] = staticAddress;
+        }
+
+        return staticAddresses_.at(key);
+    }
+
+    throw runtime_error{"Invalid segment " + segment};
+}
+
+void VMInterpreter::callBuiltIn(const string& functionName, int nArgs) {
+    vector<int> arguments(static_cast<size_t>(nArgs));
+
+    for(auto it = arguments.rbegin(); it != arguments.rend(); ++it) {
+        *it = pop();
+    }
+
+    int result{};
+
+    if(functionName == "Math.multiply") {
+        result = arguments.at(0) * arguments.at(1);
+    }
+    else if(functionName == "Math.divide") {
+        if(arguments.at(1) == 0) {
+            throw runtime_error{"Division by zero"};
+        }
+
+        result = arguments.at(0) / arguments.at(1);
+    }
+    else if(functionName == "Memory.alloc" || functionName == "Array.new") {
+        result = heapPointer_;
+        heapPointer_ += arguments.at(0);
+    }
+    else if(functionName == "String.new") {
+        // the length followed by the characters
+        result = heapPointer_;
+        at(result) = 0;
+        heapPointer_ += arguments.at(0) + 1;
+    }
+    else if(functionName == "String.appendChar") {
+        const int string = arguments.at(0);
+        at(string + 1 + at(string)) = wrap(arguments.at(1));
+        ++at(string);
+        result = string;
+    }
+    else if(functionName == "Output.printString") {
+        const int string = arguments.at(0);
+
+        for(int i = 0; i < at(string); ++i) {
+            output_ += static_cast<char>(at(string + 1 + i));
+        }
+    }
+    else if(functionName == "Output.printInt") {
+        output_ += to_string(arguments.at(0));
+    }
+    else if(functionName == "Output.printChar") {
+        output_ += static_cast<char>(arguments.at(0));
+    }
+    else if(functionName == "Output.println") {
+        output_ += '\n';
+    }
+    else if(functionName == "Memory.deAlloc" || functionName == "Array.dispose" || functionName == "String.dispose") {
+        // memory is never reused
+    }
+    else {
+        throw runtime_error{"Unknown function " + functionName};
+    }
+
+    push(wrap(result));
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief A minimal interpreter for Hack virtual-machine code that is used to check that optimized code
+ * computes the same results as unoptimized code. The memory layout follows the Hack platform, the
+ * subroutines of the Jack OS that are needed by the tests (Math, Memory, Array, String and Output) are
+ * emulated natively.
+ */
+class VMInterpreter {
+public:
+    /**
+     * \brief Loads the VM code of a file. Every file has its own static segment.
+     * \param fileName The name of the file (without extension)
+     * \param vmCode The VM code
+     */
+    void load(const std::string& fileName, const std::string& vmCode);
+
+    /**
+     * \brief Calls a function and runs until it returns. Throws a runtime_error if the program
+     * executes an invalid instruction or too many instructions.
+     * \param functionName The fully qualified name of the function
+     * \param arguments The arguments of the function
+     * \return The returned value
+     */
+    int call(const std::string& functionName, const std::vector<int>& arguments = {});
+
+    /**
+     * \brief Gets everything that has been printed with the Output-class so far.
+     * \return The printed text
+     */
+    const std::string& output() const { return output_; }
+
+    /**
+     * \brief Gets the number of VM instructions that have been executed so far (OS subroutines
+     * count as one instruction).
+     * \return The number of executed instructions
+     */
+    size_t executedInstructions() const { return executedInstructions_; }
+
+private:
+    struct Instruction {
+        std::string command;
+        std::string argument;
+        int value{};
+        // the file that contains the instruction (to resolve static variables)
+        size_t file{};
+    };
+
+    static constexpr size_t MAX_INSTRUCTIONS = 10'000'000;
+
+    std::vector<Instruction> instructions_;
+    std::vector<std::string> files_;
+    std::unordered_map<std::string, size_t> functions_;
+    std::unordered_map<std::string, size_t> labels_;
+    std::map<std::pair<size_t, int>, int> staticAddresses_;
+    std::array<int16_t, 32768> ram_{};
+    int heapPointer_{2048};
+    std::string output_;
+    size_t executedInstructions_{};
+
+    int16_t& at(int address);
+    int16_t& sp();
+    void push(int value);
+    int pop();
+    int address(const Instruction& instruction);
+    void callBuiltIn(const std::string& functionName, int nArgs);
+};
@@ -0,0 +1,209 @@
+#include "TestCompilation.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <sstream>
+#include <string>
+
+using std::string;
+using std::stringstream;
+using JackCompiler::CompilationOptions;
+using TestCompilation::compile;
+
+namespace {
+    CompilationOptions valueNumberingOptions() {
+        CompilationOptions options;
+        options.eliminateCommonSubexpressions = true;
+        return options;
+    }
+
+    TEST(ValueNumberingTest, ReusesCommonSubexpressions) {
+        const string jackCode{"class Main {"
+                              "  field int x, dx;"
+                              "  method int f(int y) {"
+                              "    let y = (x + dx) + (dx + x);"
+                              "    if((x + dx) > y) { return y; }"
+                              "    return x + dx;"
+                              "  } }"};
+
+        // the value is reused across statements and in the condition, but not in the branch
+        ASSERT_EQ("function Main.f 0\n"
+                  "push argument 0\n"
+                  "pop pointer 0\n"
+                  "push this 0\n"
+                  "push this 1\n"
+                  "add\n"
+                  "pop temp 1\n"
+                  "push temp 1\n"
+                  "push temp 1\n"
+                  "add\n"
+                  "pop argument 1\n"
+                  "push temp 1\n"
+                  "push argument 1\n"
+                  "gt\n"
+                  "if-goto IF_TRUE0\n"
+                  "goto IF_FALSE0\n"
+                  "label IF_TRUE0\n"
+                  "push argument 1\n"
+                  "return\n"
+                  "label IF_FALSE0\n"
+                  "push this 0\n"
+                  "push this 1\n"
+                  "add\n"
+                  "return\n", compile(jackCode, valueNumberingOptions()));
+    }
+
+    TEST(ValueNumberingTest, RespectsAssignmentsAndCalls) {
+        const string jackCode{"class Main {"
+                              "  field int x;"
+                              "  method int f(int a, Array c) {"
+                              "    var int y;"
+                              "    let y = (a + x) + (a + x);"
+                              "    let a = 1;"
+                              "    let y = (a + x) + (c[a] + c[a]);"
+                              "    do Main.g();"
+                              "    let y = (a + x) + c[a];"
+                              "    return y;"
+                              "  }"
+                              "  function void g() { return; } }"};
+
+        // a + x is not reused after a is assigned, c[a] and a + x are not reused after the call (which may change the
+        // array element and the field as well as the temp-variables)
+        ASSERT_EQ("function Main.f 1\n"
+                  "push argument 0\n"
+                  "pop pointer 0\n"
+                  "push argument 1\n"
+                  "push this 0\n"
+                  "add\n"
+                  "pop temp 1\n"
+                  "push temp 1\n"
+                  "push temp 1\n"
+                  "add\n"
+                  "pop local 0\n"
+                  "push constant 1\n"
+                  "pop argument 1\n"
+                  "push argument 1\n"
+                  "push this 0\n"
+                  "add\n"
+                  "push argument 1\n"
+                  "push argument 2\n"
+                  "add\n"
+                  "pop pointer 1\n"
+                  "push that 0\n"
+                  "pop temp 1\n"
+                  "push temp 1\n"
+                  "push temp 1\n"
+                  "add\n"
+                  "add\n"
+                  "pop local 0\n"
+                  "call Main.g 0\n"
+                  "pop temp 0\n"
+                  "push argument 1\n"
+                  "push this 0\n"
+                  "add\n"
+                  "push argument 1\n"
+                  "push argument 2\n"
+                  "add\n"
+                  "pop pointer 1\n"
+                  "push that 0\n"
+                  "add\n"
+                  "pop local 0\n"
+                  "push local 0\n"
+                  "return\n"
+                  "function Main.g 0\n"
+                  "push constant 0\n"
+                  "return\n", compile(jackCode, valueNumberingOptions()));
+    }
+
+    TEST(ValueNumberingTest, AllocatesTempVariables) {
+        // all of the 8 values are used at the end of the statement, so only 7 of them can be reused
+        string expression;
+        string sum;
+
+        for(int i = 0; i < 8; ++i) {
+            const auto value = "(a[" + std::to_string(i) + "] + i)";
+            expression += value + " + ";
+            sum += (i > 0 ? " + " : "") + value;
+        }
+
+        const string jackCode{"class Main { function int f(Array a, int i) { return " + expression + sum + "; } }"};
+        const auto output = compile(jackCode, valueNumberingOptions());
+
+        for(int i = 1; i <= 7; ++i) {
+            ASSERT_NE(string::npos, output.find("pop temp " + std::to_string(i) + "\n"));
+        }
+
+        ASSERT_EQ(string::npos, output.find("pop temp 8\n"));
+        ASSERT_EQ(string::npos, output.find("temp 0\n"));
+    }
+
+    TEST(ValueNumberingTest, ReportsReusedValuesAsOccurrences) {
+        const string jackCode{"class Main {"
+                              "  field int x, dx;"
+                              "  method int f() { return (x + dx) + (x + dx); } }"};
+
+        JackCompiler::OptimizationStatistics statistics;
+        compile(jackCode, valueNumberingOptions(), &statistics);
+
+        // the value is stored in a temp-variable, which adds instructions
+        stringstream report;
+        statistics.print(report);
+        ASSERT_EQ("Optimizations (occurrences):\n"
+                  "  reused value: 1\n", report.str());
+    }
+
+    TEST(ValueNumberingTest, PreservesSemantics) {
+        const string jackCode{"class Main {"
+                              "  static int s;"
+                              "  function int f(int a, int b) {"
+                              "    var Array c;"
+                              "    var int i, result;"
+                              "    let c = Array.new(4);"
+                              "    let c[0] = a; let c[1] = b; let c[2] = a * b; let c[3] = a - b;"
+                              "    let s = a;"
+                              "    while(i < 4) {"
+                              "      let result = result + ((c[i] * c[i]) + (c[i] * c[i]));"
+                              "      let result = result + (s + b) + Main.g(i) + (s + b);"
+                              "      let c[i] = (a * b) + c[i];"
+                              "      if((result > (a * b)) & ((a * b) > 0)) { let result = result - (a * b); }"
+                              "      let i = i + 1;"
+                              "    }"
+                              "    return result + (c[0] + c[1] + c[2] + c[3]) + (c[3] + c[2]);"
+                              "  }"
+                              "  function int g(int i) { let s = s + i; return s; } }"};
+
+        TestCompilation::assertPreservesResults(jackCode, valueNumberingOptions(), {-3, 0, 2, 7}, {-1, 0, 5});
+    }
+
+    class ValueNumberingTest : public testing::TestWithParam<string> {};
+
+    /**
+     * \brief A parametrized test that gets an input-file <filename>.jack as a parameter and compiles it
+     * with value numbering combined with the other optimizations. Every load of a temp-variable must follow
+     * a store within the same subroutine.
+     */
+    TEST_P(ValueNumberingTest, StoresBeforeLoads) {
+        auto options = valueNumberingOptions();
+        options.foldConstants = true;
+        options.reduceStrength = true;
+        options.optimizeArrayAccess = true;
+
+        stringstream outputStream{compile(TestCompilation::readTestFile(GetParam()), options)};
+        string line;
+        std::array<bool, 8> stored{};
+
+        while(std::getline(outputStream, line)) {
+            if(line.rfind("function ", 0) == 0) {
+                stored.fill(false);
+            }
+            else if(line.rfind("pop temp ", 0) == 0) {
+                stored.at(static_cast<size_t>(std::stoi(line.substr(9)))) = true;
+            }
+            else if(line.rfind("push temp ", 0) == 0) {
+                ASSERT_TRUE(stored.at(static_cast<size_t>(std::stoi(line.substr(10))))) << line;
+            }
+        }
+    }
+
+    INSTANTIATE_TEST_CASE_P(ValueNumberingTestInstance, ValueNumberingTest, ::testing::ValuesIn(TestFiles::TEST_FILE_NAMES),
+        [] (const ::testing::TestParamInfo<string>& info) { return TestFiles::testNameFromFileName(info.param); });
+}